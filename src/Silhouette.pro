@@ -6,6 +6,7 @@
 
 QT       += core gui
 QT += opengl
+QT += concurrent
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 TARGET = Silhouette
@@ -16,22 +17,58 @@ TEMPLATE = app
 
 SOURCES += main.cpp\
         mainwindow.cpp \
+    geometrybuffer.cpp \
+    unitprimitive.cpp \
     unitsphere.cpp \
     unitcube.cpp \
     unitplane.cpp \
+    stressmesh.cpp \
     objloader.cpp \
+    meshtopology.cpp \
     renderer.cpp \
-    colorselector.cpp
+    colorselector.cpp \
+    shadercompiler.cpp \
+    toonramp.cpp \
+    textureloader.cpp \
+    texturecache.cpp \
+    frustum.cpp \
+    bvh.cpp \
+    scene.cpp \
+    meshpool.cpp \
+    gpuculler.cpp \
+    occlusionculler.cpp \
+    shadowmap.cpp \
+    gpuprofiler.cpp \
+    tracer.cpp \
+    headlessbenchmark.cpp
 
 HEADERS  += mainwindow.h \
+    geometrybuffer.h \
+    unitprimitive.h \
     unitsphere.h \
     unitcube.h \
     unitplane.h \
+    stressmesh.h \
     cyTriMesh.h \
     cyPoint.h \
     objloader.h \
+    meshtopology.h \
     renderer.h \
-    colorselector.h
+    colorselector.h \
+    shadercompiler.h \
+    toonramp.h \
+    textureloader.h \
+    texturecache.h \
+    frustum.h \
+    bvh.h \
+    scene.h \
+    meshpool.h \
+    gpuculler.h \
+    occlusionculler.h \
+    shadowmap.h \
+    gpuprofiler.h \
+    tracer.h \
+    headlessbenchmark.h
 
 RESOURCES += \
     shaders.qrc \
@@ -0,0 +1,447 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+// Microbenchmarks of the mesh pipeline: OBJ parsing, normals and bounding box computation
+// in cyTriMesh, the half-edge topology, the whole OBJLoader::loadObjFile (with the
+// flattening into per-corner attributes and the tangents), the sphere generation and the
+// procedural stress meshes.
+// The inputs are the bundled models, generated height field grids and spheres from 10K to
+// 50M triangles and the StressMesh kinds from 10K triangles, all up to --max-triangles.
+//------------------------------------------------------------------------------------------
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QFile>
+#include <QFileInfo>
+
+#include "objloader.h"
+#include "unitsphere.h"
+#include "stressmesh.h"
+#include "meshtopology.h"
+
+//------------------------------------------------------------------------------------------
+struct StageResult
+{
+    double timeMs;
+    qint64 peakAllocationKB;
+};
+
+static QTextStream output(stdout);
+
+//------------------------------------------------------------------------------------------
+// Linux only: the peak resident memory is reset through clear_refs, the growth of the
+// high water mark during a stage is its peak allocation. -1 where it is not available.
+//------------------------------------------------------------------------------------------
+static qint64 readMemoryStatusKB(const char* _field)
+{
+#ifdef Q_OS_LINUX
+    QFile file("/proc/self/status");
+
+    if(file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        QList<QByteArray> lines = file.readAll().split('\n');
+
+        for(int i = 0; i < lines.size(); ++i)
+        {
+            if(lines[i].startsWith(_field))
+            {
+                return lines[i].mid(strlen(_field)).trimmed().split(' ').first().toLongLong();
+            }
+        }
+    }
+#else
+    Q_UNUSED(_field);
+#endif
+
+    return -1;
+}
+
+//------------------------------------------------------------------------------------------
+static qint64 resetPeakMemory()
+{
+#ifdef Q_OS_LINUX
+    QFile file("/proc/self/clear_refs");
+
+    if(file.open(QIODevice::WriteOnly))
+    {
+        file.write("5");
+    }
+#endif
+
+    return readMemoryStatusKB("VmRSS:");
+}
+
+//------------------------------------------------------------------------------------------
+static qint64 getPeakAllocationKB(qint64 _baselineKB)
+{
+    qint64 peakKB = readMemoryStatusKB("VmHWM:");
+
+    return (peakKB < 0 || _baselineKB < 0) ? -1 : qMax(peakKB - _baselineKB, (qint64) 0);
+}
+
+//------------------------------------------------------------------------------------------
+static void printHeader()
+{
+    output << QString("%1 %2 %3 %4 %5 %6 %7\n")
+           .arg("input", -22).arg("stage", -20).arg("triangles", 12)
+           .arg("ms", 10).arg("MB/s", 10).arg("Mtriangles/s", 13).arg("peak KB", 10);
+    output.flush();
+}
+
+//------------------------------------------------------------------------------------------
+// the throughput is computed on _numBytes, the input of the stage
+//------------------------------------------------------------------------------------------
+static void printResult(const QString& _input, const QString& _stage, qint64 _numTriangles,
+                        qint64 _numBytes, const StageResult& _result)
+{
+    double seconds = qMax(_result.timeMs * 1e-3, 1e-9);
+
+    output << QString("%1 %2 %3 %4 %5 %6 %7\n")
+           .arg(_input, -22).arg(_stage, -20).arg(_numTriangles, 12)
+           .arg(_result.timeMs, 10, 'f', 2)
+           .arg((double) _numBytes / seconds / (1024.0 * 1024.0), 10, 'f', 1)
+           .arg((double) _numTriangles / seconds * 1e-6, 13, 'f', 2)
+           .arg(_result.peakAllocationKB, 10);
+    output.flush();
+}
+
+//------------------------------------------------------------------------------------------
+// a grid of _gridSize x _gridSize quads over a wavy height field, with texture coordinates
+// so that the OBJLoader can compute the tangents
+//------------------------------------------------------------------------------------------
+static bool writeGridObj(const QString& _fileName, int _gridSize)
+{
+    QFile file(_fileName);
+
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return false;
+    }
+
+    QByteArray buffer;
+    buffer.reserve(1 << 20);
+    int numRowVertices = _gridSize + 1;
+
+    for(int j = 0; j < numRowVertices; ++j)
+    {
+        for(int i = 0; i < numRowVertices; ++i)
+        {
+            float u = (float) i / _gridSize;
+            float v = (float) j / _gridSize;
+            float height = 0.05f * sin(u * 31.0f) * cos(v * 17.0f);
+
+            buffer += "v " + QByteArray::number(u - 0.5f, 'f', 6) + " " +
+                      QByteArray::number(height, 'f', 6) + " " +
+                      QByteArray::number(v - 0.5f, 'f', 6) + "\n";
+            buffer += "vt " + QByteArray::number(u, 'f', 6) + " " +
+                      QByteArray::number(v, 'f', 6) + "\n";
+        }
+
+        if(buffer.size() > (1 << 20) - 4096)
+        {
+            file.write(buffer);
+            buffer.clear();
+        }
+    }
+
+    for(int j = 0; j < _gridSize; ++j)
+    {
+        for(int i = 0; i < _gridSize; ++i)
+        {
+            // OBJ indices start at 1
+            QByteArray v0 = QByteArray::number(j * numRowVertices + i + 1);
+            QByteArray v1 = QByteArray::number(j * numRowVertices + i + 2);
+            QByteArray v2 = QByteArray::number((j + 1) * numRowVertices + i + 1);
+            QByteArray v3 = QByteArray::number((j + 1) * numRowVertices + i + 2);
+
+            buffer += "f " + v0 + "/" + v0 + " " + v2 + "/" + v2 + " " + v1 + "/" + v1 + "\n";
+            buffer += "f " + v1 + "/" + v1 + " " + v2 + "/" + v2 + " " + v3 + "/" + v3 + "\n";
+        }
+
+        if(buffer.size() > (1 << 20) - 4096)
+        {
+            file.write(buffer);
+            buffer.clear();
+        }
+    }
+
+    file.write(buffer);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+// best time of the repetitions, the peak allocation of the first one
+//------------------------------------------------------------------------------------------
+static void benchmarkObjFile(const QString& _input, const QString& _fileName, int _repeat)
+{
+    qint64 fileSize = QFileInfo(_fileName).size();
+    QByteArray fileName = _fileName.toLocal8Bit();
+    StageResult results[5];
+    qint64 numTriangles = 0;
+    qint64 meshBytes = 0;
+    qint64 vertexBytes = 0;
+    QElapsedTimer timer;
+
+    for(int i = 0; i < 5; ++i)
+    {
+        results[i].timeMs = 1e30;
+    }
+
+    for(int repetition = 0; repetition < _repeat; ++repetition)
+    {
+        double times[5];
+        qint64 peaks[5];
+
+        cyTriMesh* mesh = new cyTriMesh;
+        qint64 baseline = resetPeakMemory();
+        timer.start();
+
+        if(!mesh->LoadFromFileObj(fileName.constData(), false))
+        {
+            output << "Cannot load " << _fileName << "\n";
+            delete mesh;
+            return;
+        }
+
+        times[0] = (double) timer.nsecsElapsed() * 1e-6;
+        peaks[0] = getPeakAllocationKB(baseline);
+
+        baseline = resetPeakMemory();
+        timer.start();
+        mesh->ComputeNormals();
+        times[1] = (double) timer.nsecsElapsed() * 1e-6;
+        peaks[1] = getPeakAllocationKB(baseline);
+
+        baseline = resetPeakMemory();
+        timer.start();
+        mesh->ComputeBoundingBox();
+        times[2] = (double) timer.nsecsElapsed() * 1e-6;
+        peaks[2] = getPeakAllocationKB(baseline);
+
+        MeshTopology* topology = new MeshTopology;
+        baseline = resetPeakMemory();
+        timer.start();
+        topology->build(*mesh);
+        times[4] = (double) timer.nsecsElapsed() * 1e-6;
+        peaks[4] = getPeakAllocationKB(baseline);
+        delete topology;
+
+        numTriangles = mesh->NF();
+        vertexBytes = (qint64) mesh->NV() * 3 * sizeof(float);
+        meshBytes = vertexBytes + numTriangles * 3 * sizeof(unsigned int);
+        delete mesh;
+
+        OBJLoader* objLoader = new OBJLoader;
+        baseline = resetPeakMemory();
+        timer.start();
+        objLoader->loadObjFile(fileName.constData());
+        times[3] = (double) timer.nsecsElapsed() * 1e-6;
+        peaks[3] = getPeakAllocationKB(baseline);
+        delete objLoader;
+
+        for(int i = 0; i < 5; ++i)
+        {
+            results[i].timeMs = qMin(results[i].timeMs, times[i]);
+
+            if(repetition == 0)
+            {
+                results[i].peakAllocationKB = peaks[i];
+            }
+        }
+    }
+
+    printResult(_input, "LoadFromFileObj", numTriangles, fileSize, results[0]);
+    printResult(_input, "ComputeNormals", numTriangles, meshBytes, results[1]);
+    printResult(_input, "ComputeBoundingBox", numTriangles, vertexBytes, results[2]);
+    printResult(_input, "MeshTopology::build", numTriangles, meshBytes, results[4]);
+    printResult(_input, "loadObjFile", numTriangles, fileSize, results[3]);
+}
+
+//------------------------------------------------------------------------------------------
+static void benchmarkSphere(int _numStacks, int _numSlices, int _repeat)
+{
+    StageResult result;
+    result.timeMs = 1e30;
+    result.peakAllocationKB = -1;
+    QElapsedTimer timer;
+    int indexSize = 0;
+
+    for(int repetition = 0; repetition < _repeat; ++repetition)
+    {
+        UnitSphere* sphere = new UnitSphere;
+        qint64 baseline = resetPeakMemory();
+        timer.start();
+        sphere->generateSphere(_numStacks, _numSlices);
+        result.timeMs = qMin(result.timeMs, (double) timer.nsecsElapsed() * 1e-6);
+
+        if(repetition == 0)
+        {
+            result.peakAllocationKB = getPeakAllocationKB(baseline);
+        }
+
+        indexSize = sphere->getIndexSize();
+        delete sphere;
+    }
+
+    // positions, normals, texture coordinates and indices written
+    qint64 numVertices = (qint64)(_numStacks + 1) * (_numSlices + 1);
+    qint64 numTriangles = 2 * (qint64) _numStacks * _numSlices;
+    qint64 numBytes = numVertices * 8 * sizeof(float) + numTriangles * 3 * indexSize;
+
+    printResult(QString("sphere %1x%2").arg(_numStacks).arg(_numSlices), "generateSphere",
+                numTriangles, numBytes, result);
+}
+
+//------------------------------------------------------------------------------------------
+// the generation alone, then the whole OBJLoader path from the generated cyTriMesh
+//------------------------------------------------------------------------------------------
+static void benchmarkStressMesh(StressMeshType _type, int _level, int _repeat)
+{
+    StageResult results[2];
+    QElapsedTimer timer;
+    qint64 numTriangles = 0;
+    qint64 meshBytes = 0;
+
+    for(int stage = 0; stage < 2; ++stage)
+    {
+        results[stage].timeMs = 1e30;
+        results[stage].peakAllocationKB = -1;
+    }
+
+    for(int repetition = 0; repetition < _repeat; ++repetition)
+    {
+        cyTriMesh* mesh = new cyTriMesh;
+        qint64 baseline = resetPeakMemory();
+        timer.start();
+        StressMesh::generate(_type, _level, mesh);
+        results[0].timeMs = qMin(results[0].timeMs, (double) timer.nsecsElapsed() * 1e-6);
+
+        if(repetition == 0)
+        {
+            results[0].peakAllocationKB = getPeakAllocationKB(baseline);
+        }
+
+        numTriangles = mesh->NF();
+        meshBytes = (qint64) mesh->NV() * 3 * sizeof(float) + numTriangles * 3 *
+                    sizeof(unsigned int);
+        delete mesh;
+
+        OBJLoader* objLoader = new OBJLoader;
+        baseline = resetPeakMemory();
+        timer.start();
+        objLoader->loadStressMesh(_type, _level);
+        results[1].timeMs = qMin(results[1].timeMs, (double) timer.nsecsElapsed() * 1e-6);
+
+        if(repetition == 0)
+        {
+            results[1].peakAllocationKB = getPeakAllocationKB(baseline);
+        }
+
+        delete objLoader;
+    }
+
+    QString input = QString("%1 level %2").arg(StressMesh::getName(_type)).arg(_level);
+    printResult(input, "StressMesh::generate", numTriangles, meshBytes, results[0]);
+    printResult(input, "loadStressMesh", numTriangles, meshBytes, results[1]);
+}
+
+//------------------------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    QCoreApplication application(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Microbenchmarks of the mesh pipeline.");
+    parser.addHelpOption();
+
+    QCommandLineOption maxTrianglesOption("max-triangles",
+                                          "Largest generated mesh, up to 50000000.",
+                                          "n", "1000000");
+    QCommandLineOption repeatOption("repeat", "Repetitions of the small inputs, the best "
+                                    "time is reported.", "n", "3");
+    parser.addOption(maxTrianglesOption);
+    parser.addOption(repeatOption);
+    parser.process(application);
+
+    qint64 maxTriangles = parser.value(maxTrianglesOption).toLongLong();
+    int repeat = qMax(1, parser.value(repeatOption).toInt());
+
+    printHeader();
+
+    /////////////////////////////////////////////////////////////////
+    // bundled models, copied out of the resources as the generated meshes are read from disk
+    QTemporaryDir tempDir;
+
+    if(!tempDir.isValid())
+    {
+        output << "Cannot create a temporary directory\n";
+        return EXIT_FAILURE;
+    }
+
+    const char* models[] = {"teapot", "bunny"};
+
+    for(int i = 0; i < 2; ++i)
+    {
+        QString fileName = tempDir.path() + QString("/%1.obj").arg(models[i]);
+        QFile::copy(QString(":/obj/%1.obj").arg(models[i]), fileName);
+        benchmarkObjFile(models[i], fileName, repeat);
+    }
+
+    /////////////////////////////////////////////////////////////////
+    // generated meshes, a single run above a million triangles
+    const qint64 meshSizes[] = {10000, 100000, 1000000, 10000000, 50000000};
+
+    for(int i = 0; i < 5 && meshSizes[i] <= maxTriangles; ++i)
+    {
+        int gridSize = (int) ceil(sqrt(meshSizes[i] / 2.0));
+        QString fileName = tempDir.path() + QString("/grid%1.obj").arg(meshSizes[i]);
+
+        if(!writeGridObj(fileName, gridSize))
+        {
+            output << "Cannot write " << fileName << "\n";
+            return EXIT_FAILURE;
+        }
+
+        benchmarkObjFile(QString("grid %1").arg(2 * (qint64) gridSize * gridSize), fileName,
+                         meshSizes[i] > 1000000 ? 1 : repeat);
+        QFile::remove(fileName);
+    }
+
+    /////////////////////////////////////////////////////////////////
+    // spheres of the same sizes, twice as many slices as stacks
+    for(int i = 0; i < 5 && meshSizes[i] <= maxTriangles; ++i)
+    {
+        int numStacks = (int) sqrt(meshSizes[i] / 4.0);
+        benchmarkSphere(numStacks, 2 * numStacks, meshSizes[i] > 1000000 ? 1 : repeat);
+    }
+
+    /////////////////////////////////////////////////////////////////
+    // procedural meshes, the size of the high genus plate grows with the square of the level
+    for(int type = 0; type < NUM_STRESS_MESH; ++type)
+    {
+        StressMeshType stressMeshType = (StressMeshType) type;
+        int level = 1;
+
+        while(StressMesh::getNumTriangles(stressMeshType, level) <= maxTriangles)
+        {
+            qint64 numTriangles = StressMesh::getNumTriangles(stressMeshType, level);
+
+            if(numTriangles >= 10000)
+            {
+                benchmarkStressMesh(stressMeshType, level, numTriangles > 1000000 ? 1 : repeat);
+            }
+
+            level = (stressMeshType == STRESS_HIGH_GENUS) ? 2 * level : level + 1;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,40 @@
+#-------------------------------------------------
+#
+# Microbenchmarks of the mesh pipeline, built next to the application:
+#     qmake benchmark/meshbenchmark.pro && make && ./MeshBenchmark --help
+#
+#-------------------------------------------------
+
+QT       += core gui
+QT += opengl
+QT += concurrent
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+TARGET = MeshBenchmark
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+INCLUDEPATH += ..
+
+SOURCES += meshbenchmark.cpp \
+    ../objloader.cpp \
+    ../geometrybuffer.cpp \
+    ../unitprimitive.cpp \
+    ../unitsphere.cpp \
+    ../stressmesh.cpp \
+    ../meshtopology.cpp \
+    ../tracer.cpp
+
+HEADERS  += ../objloader.h \
+    ../geometrybuffer.h \
+    ../unitprimitive.h \
+    ../unitsphere.h \
+    ../stressmesh.h \
+    ../meshtopology.h \
+    ../cyTriMesh.h \
+    ../cyPoint.h \
+    ../tracer.h
+
+RESOURCES += \
+    ../models.qrc
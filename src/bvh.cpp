@@ -0,0 +1,408 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#include <QVarLengthArray>
+
+#include "bvh.h"
+
+//------------------------------------------------------------------------------------------
+BVH::BVH():
+    rootNode(BVH_NULL_NODE),
+    freeList(BVH_NULL_NODE)
+{
+}
+
+//------------------------------------------------------------------------------------------
+void BVH::clear()
+{
+    nodes.clear();
+    rootNode = BVH_NULL_NODE;
+    freeList = BVH_NULL_NODE;
+}
+
+//------------------------------------------------------------------------------------------
+int BVH::insertLeaf(const AABB& _box, int _objectIndex)
+{
+    int leafID = allocateNode();
+    nodes[leafID].box = _box.fattened(BVH_FAT_MARGIN);
+    nodes[leafID].objectIndex = _objectIndex;
+
+    insertNode(leafID);
+
+    return leafID;
+}
+
+//------------------------------------------------------------------------------------------
+void BVH::removeLeaf(int _leafID)
+{
+    detachNode(_leafID);
+    freeNode(_leafID);
+}
+
+//------------------------------------------------------------------------------------------
+bool BVH::moveLeaf(int _leafID, const AABB& _box)
+{
+    if(nodes[_leafID].box.contains(_box))
+    {
+        return false;
+    }
+
+    detachNode(_leafID);
+    nodes[_leafID].box = _box.fattened(BVH_FAT_MARGIN);
+    insertNode(_leafID);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+int BVH::cull(const Frustum& _frustum, QVector<int>& _visibleObjects) const
+{
+    if(rootNode == BVH_NULL_NODE)
+    {
+        return 0;
+    }
+
+    int numTestedNodes = 0;
+    // the tree is balanced, its height only exceeds the stack for huge scenes
+    QVarLengthArray<int, 128> stack;
+    stack.append(rootNode);
+
+    while(!stack.isEmpty())
+    {
+        const Node& node = nodes[stack.last()];
+        stack.removeLast();
+        ++numTestedNodes;
+
+        Frustum::TestResult result = _frustum.testAABB(node.box);
+
+        if(result == Frustum::OUTSIDE)
+        {
+            continue;
+        }
+
+        if(node.isLeaf())
+        {
+            _visibleObjects.append(node.objectIndex);
+        }
+        else if(result == Frustum::INSIDE)
+        {
+            // the whole subtree is visible, no more tests needed
+            addSubtree(node.child1, _visibleObjects);
+            addSubtree(node.child2, _visibleObjects);
+        }
+        else
+        {
+            stack.append(node.child1);
+            stack.append(node.child2);
+        }
+    }
+
+    return numTestedNodes;
+}
+
+//------------------------------------------------------------------------------------------
+int BVH::getHeight() const
+{
+    return (rootNode == BVH_NULL_NODE) ? 0 : nodes[rootNode].height;
+}
+
+//------------------------------------------------------------------------------------------
+int BVH::allocateNode()
+{
+    int nodeID;
+
+    if(freeList != BVH_NULL_NODE)
+    {
+        nodeID = freeList;
+        freeList = nodes[nodeID].parent;
+    }
+    else
+    {
+        nodeID = nodes.size();
+        nodes.append(Node());
+    }
+
+    Node& node = nodes[nodeID];
+    node.parent = BVH_NULL_NODE;
+    node.child1 = BVH_NULL_NODE;
+    node.child2 = BVH_NULL_NODE;
+    node.objectIndex = -1;
+    node.height = 0;
+
+    return nodeID;
+}
+
+//------------------------------------------------------------------------------------------
+void BVH::freeNode(int _nodeID)
+{
+    nodes[_nodeID].parent = freeList;
+    nodes[_nodeID].height = -1;
+    freeList = _nodeID;
+}
+
+//------------------------------------------------------------------------------------------
+// descend to the sibling with the lowest increase in surface area
+//------------------------------------------------------------------------------------------
+void BVH::insertNode(int _leafID)
+{
+    if(rootNode == BVH_NULL_NODE)
+    {
+        rootNode = _leafID;
+        nodes[rootNode].parent = BVH_NULL_NODE;
+        return;
+    }
+
+    AABB leafBox = nodes[_leafID].box;
+    int siblingID = rootNode;
+
+    while(!nodes[siblingID].isLeaf())
+    {
+        const Node& node = nodes[siblingID];
+        float area = node.box.getSurfaceArea();
+        float combinedArea = node.box.merged(leafBox).getSurfaceArea();
+
+        // cost of making a new parent for this node and the leaf
+        float cost = 2.0f * combinedArea;
+        // minimum cost of pushing the leaf further down the tree
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        float cost1 = leafBox.merged(nodes[node.child1].box).getSurfaceArea() + inheritanceCost;
+        float cost2 = leafBox.merged(nodes[node.child2].box).getSurfaceArea() + inheritanceCost;
+
+        if(!nodes[node.child1].isLeaf())
+        {
+            cost1 -= nodes[node.child1].box.getSurfaceArea();
+        }
+
+        if(!nodes[node.child2].isLeaf())
+        {
+            cost2 -= nodes[node.child2].box.getSurfaceArea();
+        }
+
+        if(cost < cost1 && cost < cost2)
+        {
+            break;
+        }
+
+        siblingID = (cost1 < cost2) ? node.child1 : node.child2;
+    }
+
+    /////////////////////////////////////////////////////////////////
+    // make a new parent for the sibling and the leaf
+    int oldParentID = nodes[siblingID].parent;
+    int newParentID = allocateNode();
+    nodes[newParentID].parent = oldParentID;
+    nodes[newParentID].box = leafBox.merged(nodes[siblingID].box);
+    nodes[newParentID].height = nodes[siblingID].height + 1;
+    nodes[newParentID].child1 = siblingID;
+    nodes[newParentID].child2 = _leafID;
+    nodes[siblingID].parent = newParentID;
+    nodes[_leafID].parent = newParentID;
+
+    if(oldParentID != BVH_NULL_NODE)
+    {
+        if(nodes[oldParentID].child1 == siblingID)
+        {
+            nodes[oldParentID].child1 = newParentID;
+        }
+        else
+        {
+            nodes[oldParentID].child2 = newParentID;
+        }
+    }
+    else
+    {
+        rootNode = newParentID;
+    }
+
+    refitAncestors(nodes[_leafID].parent);
+}
+
+//------------------------------------------------------------------------------------------
+// replace the parent of the leaf by its sibling
+//------------------------------------------------------------------------------------------
+void BVH::detachNode(int _leafID)
+{
+    if(_leafID == rootNode)
+    {
+        rootNode = BVH_NULL_NODE;
+        return;
+    }
+
+    int parentID = nodes[_leafID].parent;
+    int grandParentID = nodes[parentID].parent;
+    int siblingID = (nodes[parentID].child1 == _leafID) ?
+                    nodes[parentID].child2 : nodes[parentID].child1;
+
+    if(grandParentID != BVH_NULL_NODE)
+    {
+        if(nodes[grandParentID].child1 == parentID)
+        {
+            nodes[grandParentID].child1 = siblingID;
+        }
+        else
+        {
+            nodes[grandParentID].child2 = siblingID;
+        }
+
+        nodes[siblingID].parent = grandParentID;
+        freeNode(parentID);
+
+        refitAncestors(grandParentID);
+    }
+    else
+    {
+        rootNode = siblingID;
+        nodes[siblingID].parent = BVH_NULL_NODE;
+        freeNode(parentID);
+    }
+
+    nodes[_leafID].parent = BVH_NULL_NODE;
+}
+
+//------------------------------------------------------------------------------------------
+// walk up to the root, balancing each ancestor before refitting it; the children of a
+// node are always refit before the node itself
+//------------------------------------------------------------------------------------------
+void BVH::refitAncestors(int _nodeID)
+{
+    while(_nodeID != BVH_NULL_NODE)
+    {
+        _nodeID = balance(_nodeID);
+        refitNode(_nodeID);
+
+        _nodeID = nodes[_nodeID].parent;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// rotate the taller child up if the heights of the children differ by more than one,
+// return the root of the subtree
+//------------------------------------------------------------------------------------------
+int BVH::balance(int _nodeID)
+{
+    const Node& node = nodes[_nodeID];
+
+    if(node.isLeaf())
+    {
+        return _nodeID;
+    }
+
+    int heightDifference = nodes[node.child2].height - nodes[node.child1].height;
+
+    if(heightDifference > 1)
+    {
+        return rotate(_nodeID, node.child2);
+    }
+
+    if(heightDifference < -1)
+    {
+        return rotate(_nodeID, node.child1);
+    }
+
+    return _nodeID;
+}
+
+//------------------------------------------------------------------------------------------
+// the child takes the place of the node, which takes the place of the shorter grandchild
+// and becomes the first child of the child; return the child
+//------------------------------------------------------------------------------------------
+int BVH::rotate(int _nodeID, int _childID)
+{
+    Node& node = nodes[_nodeID];
+    Node& child = nodes[_childID];
+    int grandChild1 = child.child1;
+    int grandChild2 = child.child2;
+
+    /////////////////////////////////////////////////////////////////
+    // the child replaces the node under its parent
+    child.parent = node.parent;
+    node.parent = _childID;
+
+    if(child.parent != BVH_NULL_NODE)
+    {
+        if(nodes[child.parent].child1 == _nodeID)
+        {
+            nodes[child.parent].child1 = _childID;
+        }
+        else
+        {
+            nodes[child.parent].child2 = _childID;
+        }
+    }
+    else
+    {
+        rootNode = _childID;
+    }
+
+    /////////////////////////////////////////////////////////////////
+    // the taller grandchild stays under the child, the other one moves under the node
+    int tallID = grandChild1;
+    int shortID = grandChild2;
+
+    if(nodes[grandChild2].height > nodes[grandChild1].height)
+    {
+        tallID = grandChild2;
+        shortID = grandChild1;
+    }
+
+    child.child1 = _nodeID;
+    child.child2 = tallID;
+
+    if(node.child1 == _childID)
+    {
+        node.child1 = shortID;
+    }
+    else
+    {
+        node.child2 = shortID;
+    }
+
+    nodes[shortID].parent = _nodeID;
+
+    refitNode(_nodeID);
+    refitNode(_childID);
+
+    return _childID;
+}
+
+//------------------------------------------------------------------------------------------
+void BVH::refitNode(int _nodeID)
+{
+    Node& node = nodes[_nodeID];
+    const Node& child1 = nodes[node.child1];
+    const Node& child2 = nodes[node.child2];
+
+    node.box = child1.box.merged(child2.box);
+    node.height = 1 + qMax(child1.height, child2.height);
+}
+
+//------------------------------------------------------------------------------------------
+// append every leaf of the subtree, with an explicit stack as in cull()
+//------------------------------------------------------------------------------------------
+void BVH::addSubtree(int _nodeID, QVector<int>& _visibleObjects) const
+{
+    QVarLengthArray<int, 128> stack;
+    stack.append(_nodeID);
+
+    while(!stack.isEmpty())
+    {
+        const Node& node = nodes[stack.last()];
+        stack.removeLast();
+
+        if(node.isLeaf())
+        {
+            _visibleObjects.append(node.objectIndex);
+        }
+        else
+        {
+            stack.append(node.child1);
+            stack.append(node.child2);
+        }
+    }
+}
@@ -0,0 +1,77 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#ifndef BVH_H
+#define BVH_H
+
+#include <QVector>
+
+#include "frustum.h"
+
+#define BVH_NULL_NODE  -1
+#define BVH_FAT_MARGIN 0.1f
+
+//------------------------------------------------------------------------------------------
+// Dynamic bounding volume hierarchy: the leaves store fattened boxes, so an object that
+// moves a little only refits nothing, and an object that leaves its fat box is removed and
+// reinserted at the cheapest sibling (surface area heuristic) with its ancestors refit.
+// The ancestors are also rotated when their subtrees differ in height by more than one,
+// as in an AVL tree, so reinserting animated objects keeps the height logarithmic
+//------------------------------------------------------------------------------------------
+class BVH
+{
+public:
+    BVH();
+
+    void clear();
+
+    // return the leaf ID
+    int insertLeaf(const AABB& _box, int _objectIndex);
+    void removeLeaf(int _leafID);
+
+    // return true if the leaf has been reinserted
+    bool moveLeaf(int _leafID, const AABB& _box);
+
+    // append the indices of the objects whose boxes are not outside the frustum,
+    // return the number of tested nodes
+    int cull(const Frustum& _frustum, QVector<int>& _visibleObjects) const;
+
+    int getHeight() const;
+
+private:
+    struct Node
+    {
+        AABB box;
+        int parent;
+        int child1;
+        int child2;
+        int objectIndex;
+        int height;
+
+        bool isLeaf() const
+        {
+            return (child1 == BVH_NULL_NODE);
+        }
+    };
+
+    int allocateNode();
+    void freeNode(int _nodeID);
+    void insertNode(int _leafID);
+    void detachNode(int _leafID);
+    void refitAncestors(int _nodeID);
+    int balance(int _nodeID);
+    int rotate(int _nodeID, int _childID);
+    void refitNode(int _nodeID);
+    void addSubtree(int _nodeID, QVector<int>& _visibleObjects) const;
+
+    QVector<Node> nodes;
+    int rootNode;
+    int freeList;
+};
+
+#endif // BVH_H
@@ -0,0 +1,155 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+#include <math.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "frustum.h"
+
+//------------------------------------------------------------------------------------------
+AABB AABB::merged(const AABB& _other) const
+{
+    return AABB(QVector3D(qMin(minPoint.x(), _other.minPoint.x()),
+                          qMin(minPoint.y(), _other.minPoint.y()),
+                          qMin(minPoint.z(), _other.minPoint.z())),
+                QVector3D(qMax(maxPoint.x(), _other.maxPoint.x()),
+                          qMax(maxPoint.y(), _other.maxPoint.y()),
+                          qMax(maxPoint.z(), _other.maxPoint.z())));
+}
+
+//------------------------------------------------------------------------------------------
+AABB AABB::fattened(float _relativeMargin) const
+{
+    QVector3D margin = (maxPoint - minPoint) * _relativeMargin;
+    return AABB(minPoint - margin, maxPoint + margin);
+}
+
+//------------------------------------------------------------------------------------------
+// transform the center, and the extent by the absolute values of the matrix
+//------------------------------------------------------------------------------------------
+AABB AABB::transformed(const QMatrix4x4& _matrix) const
+{
+    QVector3D center = _matrix.map(getCenter());
+    QVector3D extent = getExtent();
+    QVector3D newExtent;
+
+    for(int row = 0; row < 3; ++row)
+    {
+        newExtent[row] = fabs(_matrix(row, 0)) * extent.x() +
+                         fabs(_matrix(row, 1)) * extent.y() +
+                         fabs(_matrix(row, 2)) * extent.z();
+    }
+
+    return AABB(center - newExtent, center + newExtent);
+}
+
+//------------------------------------------------------------------------------------------
+Frustum::Frustum()
+{
+    for(int i = 0; i < 8; ++i)
+    {
+        planeX[i] = 0.0f;
+        planeY[i] = 0.0f;
+        planeZ[i] = 0.0f;
+        planeW[i] = 1.0f;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// planes point inwards: left, right, bottom, top, near, far
+//------------------------------------------------------------------------------------------
+void Frustum::setFromMatrix(const QMatrix4x4& _viewProjectionMatrix)
+{
+    QVector4D rowW = _viewProjectionMatrix.row(3);
+
+    for(int i = 0; i < 6; ++i)
+    {
+        QVector4D row = _viewProjectionMatrix.row(i / 2);
+        QVector4D plane = (i & 1) ? (rowW - row) : (rowW + row);
+
+        planeX[i] = plane.x();
+        planeY[i] = plane.y();
+        planeZ[i] = plane.z();
+        planeW[i] = plane.w();
+    }
+}
+
+//------------------------------------------------------------------------------------------
+QVector4D Frustum::getPlane(int _planeIndex) const
+{
+    return QVector4D(planeX[_planeIndex], planeY[_planeIndex], planeZ[_planeIndex],
+                     planeW[_planeIndex]);
+}
+
+//------------------------------------------------------------------------------------------
+// signed distance of the box center against the projected radius of the box
+//------------------------------------------------------------------------------------------
+Frustum::TestResult Frustum::testAABB(const AABB& _box) const
+{
+    QVector3D center = _box.getCenter();
+    QVector3D extent = _box.getExtent();
+
+#ifdef __SSE2__
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 zero = _mm_setzero_ps();
+    __m128 cx = _mm_set1_ps(center.x());
+    __m128 cy = _mm_set1_ps(center.y());
+    __m128 cz = _mm_set1_ps(center.z());
+    __m128 ex = _mm_set1_ps(extent.x());
+    __m128 ey = _mm_set1_ps(extent.y());
+    __m128 ez = _mm_set1_ps(extent.z());
+    __m128 intersect = zero;
+
+    for(int i = 0; i < 8; i += 4)
+    {
+        __m128 nx = _mm_loadu_ps(planeX + i);
+        __m128 ny = _mm_loadu_ps(planeY + i);
+        __m128 nz = _mm_loadu_ps(planeZ + i);
+        __m128 nw = _mm_loadu_ps(planeW + i);
+
+        __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)),
+                                     _mm_add_ps(_mm_mul_ps(nz, cz), nw));
+        __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, nx), ex),
+                                              _mm_mul_ps(_mm_andnot_ps(signMask, ny), ey)),
+                                   _mm_mul_ps(_mm_andnot_ps(signMask, nz), ez));
+
+        if(_mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, radius), zero)))
+        {
+            return OUTSIDE;
+        }
+
+        intersect = _mm_or_ps(intersect, _mm_cmplt_ps(_mm_sub_ps(distance, radius), zero));
+    }
+
+    return _mm_movemask_ps(intersect) ? INTERSECT : INSIDE;
+#else
+    TestResult result = INSIDE;
+
+    for(int i = 0; i < 6; ++i)
+    {
+        float distance = planeX[i] * center.x() + planeY[i] * center.y() +
+                         planeZ[i] * center.z() + planeW[i];
+        float radius = fabs(planeX[i]) * extent.x() + fabs(planeY[i]) * extent.y() +
+                       fabs(planeZ[i]) * extent.z();
+
+        if(distance + radius < 0.0f)
+        {
+            return OUTSIDE;
+        }
+
+        if(distance - radius < 0.0f)
+        {
+            result = INTERSECT;
+        }
+    }
+
+    return result;
+#endif
+}
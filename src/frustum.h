@@ -0,0 +1,88 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <QVector3D>
+#include <QMatrix4x4>
+#include <float.h>
+
+//------------------------------------------------------------------------------------------
+struct AABB
+{
+    AABB():
+        minPoint(FLT_MAX, FLT_MAX, FLT_MAX),
+        maxPoint(-FLT_MAX, -FLT_MAX, -FLT_MAX) {}
+
+    AABB(const QVector3D& _minPoint, const QVector3D& _maxPoint):
+        minPoint(_minPoint),
+        maxPoint(_maxPoint) {}
+
+    QVector3D getCenter() const
+    {
+        return 0.5f * (minPoint + maxPoint);
+    }
+
+    QVector3D getExtent() const
+    {
+        return 0.5f * (maxPoint - minPoint);
+    }
+
+    float getSurfaceArea() const
+    {
+        QVector3D size = maxPoint - minPoint;
+        return 2.0f * (size.x() * size.y() + size.y() * size.z() + size.z() * size.x());
+    }
+
+    bool contains(const AABB& _other) const
+    {
+        return (minPoint.x() <= _other.minPoint.x() && minPoint.y() <= _other.minPoint.y() &&
+                minPoint.z() <= _other.minPoint.z() && maxPoint.x() >= _other.maxPoint.x() &&
+                maxPoint.y() >= _other.maxPoint.y() && maxPoint.z() >= _other.maxPoint.z());
+    }
+
+    AABB merged(const AABB& _other) const;
+    AABB fattened(float _relativeMargin) const;
+    AABB transformed(const QMatrix4x4& _matrix) const;
+
+    QVector3D minPoint;
+    QVector3D maxPoint;
+};
+
+//------------------------------------------------------------------------------------------
+// View frustum planes extracted from the view-projection matrix, the AABB test uses SSE
+// for 4 planes at once when available
+//------------------------------------------------------------------------------------------
+class Frustum
+{
+public:
+    enum TestResult
+    {
+        OUTSIDE = 0,
+        INTERSECT,
+        INSIDE
+    };
+
+    Frustum();
+
+    void setFromMatrix(const QMatrix4x4& _viewProjectionMatrix);
+    TestResult testAABB(const AABB& _box) const;
+
+    // (normal, distance) of the left, right, bottom, top, near and far planes
+    QVector4D getPlane(int _planeIndex) const;
+
+private:
+    // structure of arrays, padded to 8 planes with planes that never reject a box
+    float planeX[8];
+    float planeY[8];
+    float planeZ[8];
+    float planeW[8];
+};
+
+#endif // FRUSTUM_H
@@ -0,0 +1,245 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#include "geometrybuffer.h"
+
+//------------------------------------------------------------------------------------------
+GeometryBuffer::GeometryBuffer():
+    data(NULL),
+    numVertices(0),
+    numIndices(0),
+    attributes(0),
+    indexType(GL_UNSIGNED_INT),
+    released(false)
+{
+    computeLayout();
+}
+
+//------------------------------------------------------------------------------------------
+GeometryBuffer::~GeometryBuffer()
+{
+    qFreeAligned(data);
+}
+
+#ifdef Q_COMPILER_RVALUE_REFS
+//------------------------------------------------------------------------------------------
+GeometryBuffer::GeometryBuffer(GeometryBuffer&& _other):
+    data(NULL),
+    numVertices(0),
+    numIndices(0),
+    attributes(0),
+    indexType(GL_UNSIGNED_INT),
+    released(false)
+{
+    computeLayout();
+    swap(_other);
+}
+
+//------------------------------------------------------------------------------------------
+GeometryBuffer& GeometryBuffer::operator =(GeometryBuffer&& _other)
+{
+    swap(_other);
+    return *this;
+}
+#endif
+
+//------------------------------------------------------------------------------------------
+void GeometryBuffer::swap(GeometryBuffer& _other)
+{
+    qSwap(data, _other.data);
+    qSwap(numVertices, _other.numVertices);
+    qSwap(numIndices, _other.numIndices);
+    qSwap(attributes, _other.attributes);
+    qSwap(indexType, _other.indexType);
+    qSwap(released, _other.released);
+
+    for(int i = 0; i < NUM_GEOMETRY_ATTRIBUTES + 2; ++i)
+    {
+        qSwap(blockOffsets[i], _other.blockOffsets[i]);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+void GeometryBuffer::allocate(int _numVertices, int _numIndices, int _attributes,
+                              GLenum _indexType)
+{
+    qFreeAligned(data);
+    data = NULL;
+
+    numVertices = _numVertices;
+    numIndices = _numIndices;
+    attributes = _attributes;
+    indexType = _indexType;
+    released = false;
+    computeLayout();
+
+    qint64 size = blockOffsets[NUM_GEOMETRY_ATTRIBUTES + 1];
+
+    if(size > 0)
+    {
+        data = (char*) qMallocAligned(size, GEOMETRY_ALIGNMENT);
+        Q_CHECK_PTR(data);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+void GeometryBuffer::squeeze(int _numVertices, int _numIndices)
+{
+    Q_ASSERT(_numVertices <= numVertices && _numIndices <= numIndices && !released);
+
+    if(_numVertices == numVertices && _numIndices == numIndices)
+    {
+        return;
+    }
+
+    GeometryBuffer squeezed;
+    squeezed.allocate(_numVertices, _numIndices, attributes, indexType);
+
+    for(int i = 0; i < NUM_GEOMETRY_ATTRIBUTES; ++i)
+    {
+        GeometryAttribute attribute = (GeometryAttribute) i;
+
+        if(hasAttribute(attribute))
+        {
+            memcpy(squeezed.getAttribute(attribute), getAttribute(attribute),
+                   squeezed.getAttributeSize(attribute));
+        }
+    }
+
+    if(_numIndices > 0)
+    {
+        memcpy(squeezed.getIndices(), getIndices(), (qint64) _numIndices * getIndexSize());
+    }
+
+    swap(squeezed);
+}
+
+//------------------------------------------------------------------------------------------
+void GeometryBuffer::release()
+{
+    qFreeAligned(data);
+    data = NULL;
+    released = true;
+}
+
+//------------------------------------------------------------------------------------------
+// the blocks are rounded up to the alignment, the padding is never read
+//------------------------------------------------------------------------------------------
+void GeometryBuffer::computeLayout()
+{
+    qint64 offset = 0;
+
+    for(int i = 0; i < NUM_GEOMETRY_ATTRIBUTES; ++i)
+    {
+        blockOffsets[i] = offset;
+
+        if(attributes & (1 << i))
+        {
+            offset += getAttributeSize((GeometryAttribute) i);
+            offset = (offset + GEOMETRY_ALIGNMENT - 1) & ~(GEOMETRY_ALIGNMENT - 1);
+        }
+    }
+
+    blockOffsets[NUM_GEOMETRY_ATTRIBUTES] = offset;
+    blockOffsets[NUM_GEOMETRY_ATTRIBUTES + 1] = offset + (qint64) numIndices * getIndexSize();
+}
+
+//------------------------------------------------------------------------------------------
+bool GeometryBuffer::isEmpty() const
+{
+    return (numVertices == 0);
+}
+
+//------------------------------------------------------------------------------------------
+bool GeometryBuffer::isReleased() const
+{
+    return released;
+}
+
+//------------------------------------------------------------------------------------------
+int GeometryBuffer::getNumVertices() const
+{
+    return numVertices;
+}
+
+//------------------------------------------------------------------------------------------
+int GeometryBuffer::getNumIndices() const
+{
+    return numIndices;
+}
+
+//------------------------------------------------------------------------------------------
+bool GeometryBuffer::hasAttribute(GeometryAttribute _attribute) const
+{
+    return (attributes & (1 << _attribute)) != 0;
+}
+
+//------------------------------------------------------------------------------------------
+qint64 GeometryBuffer::getMemorySize() const
+{
+    return data ? blockOffsets[NUM_GEOMETRY_ATTRIBUTES + 1] : 0;
+}
+
+//------------------------------------------------------------------------------------------
+int GeometryBuffer::getNumComponents(GeometryAttribute _attribute)
+{
+    static const int numComponents[NUM_GEOMETRY_ATTRIBUTES] = {3, 3, 2, 4};
+
+    return numComponents[_attribute];
+}
+
+//------------------------------------------------------------------------------------------
+GLfloat* GeometryBuffer::getAttribute(GeometryAttribute _attribute)
+{
+    return (data && hasAttribute(_attribute)) ? (GLfloat*)(data + blockOffsets[_attribute]) :
+           NULL;
+}
+
+//------------------------------------------------------------------------------------------
+const GLfloat* GeometryBuffer::getAttribute(GeometryAttribute _attribute) const
+{
+    return (data && hasAttribute(_attribute)) ?
+           (const GLfloat*)(data + blockOffsets[_attribute]) : NULL;
+}
+
+//------------------------------------------------------------------------------------------
+qint64 GeometryBuffer::getAttributeSize(GeometryAttribute _attribute) const
+{
+    return (qint64) numVertices * getNumComponents(_attribute) * sizeof(GLfloat);
+}
+
+//------------------------------------------------------------------------------------------
+GLenum GeometryBuffer::getIndexType() const
+{
+    return indexType;
+}
+
+//------------------------------------------------------------------------------------------
+int GeometryBuffer::getIndexSize() const
+{
+    return (indexType == GL_UNSIGNED_SHORT) ? sizeof(GLushort) : sizeof(GLuint);
+}
+
+//------------------------------------------------------------------------------------------
+GLvoid* GeometryBuffer::getIndices()
+{
+    return data ? (GLvoid*)(data + blockOffsets[NUM_GEOMETRY_ATTRIBUTES]) : NULL;
+}
+
+//------------------------------------------------------------------------------------------
+const GLvoid* GeometryBuffer::getIndices() const
+{
+    return data ? (const GLvoid*)(data + blockOffsets[NUM_GEOMETRY_ATTRIBUTES]) : NULL;
+}
+
+//------------------------------------------------------------------------------------------
+GLuint GeometryBuffer::getIndex(int _i) const
+{
+    return (indexType == GL_UNSIGNED_SHORT) ? ((const GLushort*) getIndices())[_i] :
+           ((const GLuint*) getIndices())[_i];
+}
@@ -0,0 +1,93 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#ifndef GEOMETRYBUFFER_H
+#define GEOMETRYBUFFER_H
+
+#include <QtGui>
+
+#define GEOMETRY_ALIGNMENT 64 // bytes, every block starts on a cache line
+
+enum GeometryAttribute
+{
+    POSITION_ATTRIBUTE = 0,
+    NORMAL_ATTRIBUTE,
+    TEXCOORD_ATTRIBUTE,
+    TANGENT_ATTRIBUTE,
+    NUM_GEOMETRY_ATTRIBUTES
+};
+
+#define GEOMETRY_POSITIONS (1 << POSITION_ATTRIBUTE)
+#define GEOMETRY_NORMALS (1 << NORMAL_ATTRIBUTE)
+#define GEOMETRY_TEXCOORDS (1 << TEXCOORD_ATTRIBUTE)
+#define GEOMETRY_TANGENTS (1 << TANGENT_ATTRIBUTE)
+
+//------------------------------------------------------------------------------------------
+// Owning storage of one mesh: a single aligned allocation holding a planar block per
+// attribute (3 floats per position and normal, 2 per texture coordinate, 4 per tangent)
+// followed by the indices, 16 or 32-bit. It cannot be copied, only swapped or moved, so the
+// geometry lives in exactly one place on the CPU until release() frees it once the GPU
+// has its copy. The counts stay valid after the release.
+//------------------------------------------------------------------------------------------
+class GeometryBuffer
+{
+public:
+    GeometryBuffer();
+    ~GeometryBuffer();
+
+#ifdef Q_COMPILER_RVALUE_REFS
+    GeometryBuffer(GeometryBuffer&& _other);
+    GeometryBuffer& operator =(GeometryBuffer&& _other);
+#endif
+
+    void swap(GeometryBuffer& _other);
+
+    // _attributes is a combination of GEOMETRY_POSITIONS... flags, the content is left
+    // uninitialized
+    void allocate(int _numVertices, int _numIndices, int _attributes, GLenum _indexType);
+    // keep the first vertices and indices only, in a new allocation of the exact size
+    void squeeze(int _numVertices, int _numIndices);
+    void release();
+
+    bool isEmpty() const;
+    bool isReleased() const;
+    int getNumVertices() const;
+    int getNumIndices() const;
+    bool hasAttribute(GeometryAttribute _attribute) const;
+    qint64 getMemorySize() const;
+
+    static int getNumComponents(GeometryAttribute _attribute);
+    GLfloat* getAttribute(GeometryAttribute _attribute);
+    const GLfloat* getAttribute(GeometryAttribute _attribute) const;
+    // size in bytes of the whole block of an attribute
+    qint64 getAttributeSize(GeometryAttribute _attribute) const;
+
+    // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+    GLenum getIndexType() const;
+    int getIndexSize() const;
+    GLvoid* getIndices();
+    const GLvoid* getIndices() const;
+    GLuint getIndex(int _i) const;
+
+private:
+    Q_DISABLE_COPY(GeometryBuffer)
+
+    void computeLayout();
+
+    char* data;
+    int numVertices;
+    int numIndices;
+    int attributes;
+    GLenum indexType;
+    bool released;
+
+    // the last offset is the one of the indices, followed by the size of the allocation
+    qint64 blockOffsets[NUM_GEOMETRY_ATTRIBUTES + 2];
+};
+
+#endif // GEOMETRYBUFFER_H
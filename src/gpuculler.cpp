@@ -0,0 +1,345 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#include "gpuculler.h"
+
+//------------------------------------------------------------------------------------------
+GpuCuller::GpuCuller():
+    initialized(false),
+    cullProgram(NULL),
+    numObjects(0),
+    instanceCapacity(0),
+    objectBuffer(0),
+    lodBuffer(0),
+    commandBuffer(0),
+    commandTemplateBuffer(0),
+    visibilityBuffer(0),
+    useObjectVisibility(false),
+    timerQuery(0),
+    timerQueryPending(false),
+    cullTimeNs(0)
+{
+}
+
+//------------------------------------------------------------------------------------------
+GpuCuller::~GpuCuller()
+{
+    delete cullProgram;
+}
+
+//------------------------------------------------------------------------------------------
+bool GpuCuller::initialize()
+{
+    // fail on contexts older than 4.3
+    if(!initializeOpenGLFunctions())
+    {
+        return false;
+    }
+
+    cullProgram = new QOpenGLShaderProgram;
+
+    if(!cullProgram->addShaderFromSourceFile(QOpenGLShader::Compute,
+                                             ":/shaders/cull.cs.glsl") ||
+       !cullProgram->link())
+    {
+        qDebug() << "Cannot build the culling compute shader:" << cullProgram->log();
+        delete cullProgram;
+        cullProgram = NULL;
+        return false;
+    }
+
+    uniFrustumPlanes = cullProgram->uniformLocation("frustumPlanes");
+    uniCameraPosition = cullProgram->uniformLocation("cameraPosition");
+    uniNumObjects = cullProgram->uniformLocation("numObjects");
+    uniUseObjectVisibility = cullProgram->uniformLocation("useObjectVisibility");
+
+    glGenBuffers(1, &objectBuffer);
+    glGenBuffers(1, &lodBuffer);
+    glGenBuffers(1, &commandBuffer);
+    glGenBuffers(1, &commandTemplateBuffer);
+    glGenBuffers(1, &visibilityBuffer);
+    glGenQueries(1, &timerQuery);
+
+    initialized = true;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+bool GpuCuller::isInitialized()
+{
+    return initialized;
+}
+
+//------------------------------------------------------------------------------------------
+void GpuCuller::setMeshes(MeshPool& _meshPool)
+{
+    meshLods.clear();
+    meshBounds.clear();
+    lodDistances.clear();
+    commandTemplate.clear();
+
+    for(int i = 0; i < _meshPool.getNumMeshes(); ++i)
+    {
+        const MeshRange& range = _meshPool.getMeshRange(i);
+
+        MeshLods lods;
+        lods.firstLod = commandTemplate.size();
+        lods.numLods = 1;
+        meshLods.append(lods);
+        meshBounds.append(range.bounds);
+
+        // an evicted mesh draws nothing, the scene only holds the resident one anyway
+        DrawElementsIndirectCommand command;
+        command.count = range.resident ? range.indexCount : 0;
+        command.instanceCount = 0;
+        command.firstIndex = range.firstIndex;
+        command.baseVertex = range.baseVertex;
+        command.baseInstance = 0;
+        commandTemplate.append(command);
+        lodDistances.append(FLT_MAX);
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, lodBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, lodDistances.size() * sizeof(GLfloat),
+                 lodDistances.constData(), GL_STATIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER,
+                 commandTemplate.size() * sizeof(DrawElementsIndirectCommand),
+                 NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+//------------------------------------------------------------------------------------------
+// each LOD reserves a range of instances as large as the number of objects of its mesh,
+// the commands are reset from the template buffer before culling
+//------------------------------------------------------------------------------------------
+void GpuCuller::uploadObjects(const Scene& _scene)
+{
+    numObjects = _scene.getNumObjects();
+    QVector<ObjectData> objects(numObjects);
+    QVector<int> numMeshObjects(meshLods.size(), 0);
+
+    for(int i = 0; i < numObjects; ++i)
+    {
+        const SceneObject& sceneObject = _scene.getObject(i);
+        const AABB& bounds = meshBounds[sceneObject.meshIndex];
+        ObjectData& object = objects[i];
+
+        memcpy(object.modelMatrix, sceneObject.transform.constData(), 16 * sizeof(GLfloat));
+        object.boundsMin[0] = bounds.minPoint.x();
+        object.boundsMin[1] = bounds.minPoint.y();
+        object.boundsMin[2] = bounds.minPoint.z();
+        object.boundsMin[3] = 1.0f;
+        object.boundsMax[0] = bounds.maxPoint.x();
+        object.boundsMax[1] = bounds.maxPoint.y();
+        object.boundsMax[2] = bounds.maxPoint.z();
+        object.boundsMax[3] = 1.0f;
+        object.firstLod = meshLods[sceneObject.meshIndex].firstLod;
+        object.numLods = meshLods[sceneObject.meshIndex].numLods;
+        object.materialIndex = sceneObject.materialIndex;
+        object.padding = 0;
+
+        ++numMeshObjects[sceneObject.meshIndex];
+    }
+
+    instanceCapacity = 0;
+
+    for(int i = 0; i < meshLods.size(); ++i)
+    {
+        for(int lod = 0; lod < meshLods[i].numLods; ++lod)
+        {
+            commandTemplate[meshLods[i].firstLod + lod].baseInstance = instanceCapacity;
+            instanceCapacity += numMeshObjects[i];
+        }
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, objectBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, numObjects * sizeof(ObjectData),
+                 objects.constData(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    glBindBuffer(GL_COPY_READ_BUFFER, commandTemplateBuffer);
+    glBufferData(GL_COPY_READ_BUFFER,
+                 commandTemplate.size() * sizeof(DrawElementsIndirectCommand),
+                 commandTemplate.constData(), GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+    objectVisibility.fill(1, qMax(numObjects, 1));
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, visibilityBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, objectVisibility.size() * sizeof(GLuint),
+                 objectVisibility.constData(), GL_STREAM_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+//------------------------------------------------------------------------------------------
+void GpuCuller::setObjectVisibility(const QVector<int>& _visibleObjects)
+{
+    if(!initialized || numObjects == 0)
+    {
+        return;
+    }
+
+    objectVisibility.fill(0);
+
+    for(int i = 0; i < _visibleObjects.size(); ++i)
+    {
+        objectVisibility[_visibleObjects[i]] = 1;
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, visibilityBuffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, numObjects * sizeof(GLuint),
+                    objectVisibility.constData());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    useObjectVisibility = true;
+}
+
+//------------------------------------------------------------------------------------------
+void GpuCuller::clearObjectVisibility()
+{
+    useObjectVisibility = false;
+}
+
+//------------------------------------------------------------------------------------------
+int GpuCuller::getInstanceCapacity()
+{
+    return instanceCapacity;
+}
+
+//------------------------------------------------------------------------------------------
+void GpuCuller::cull(const QMatrix4x4& _viewProjectionMatrix,
+                     const QVector3D& _cameraPosition, GLuint _instanceBuffer)
+{
+    if(!initialized || numObjects == 0)
+    {
+        return;
+    }
+
+    /////////////////////////////////////////////////////////////////
+    // collect the timing of a previous frame without waiting for it
+    if(timerQueryPending)
+    {
+        GLint available = 0;
+        glGetQueryObjectiv(timerQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+
+        if(available)
+        {
+            GLuint64 timeElapsed = 0;
+            glGetQueryObjectui64v(timerQuery, GL_QUERY_RESULT, &timeElapsed);
+            cullTimeNs = (qint64) timeElapsed;
+            timerQueryPending = false;
+        }
+    }
+
+    bool timeThisFrame = !timerQueryPending;
+
+    if(timeThisFrame)
+    {
+        glBeginQuery(GL_TIME_ELAPSED, timerQuery);
+    }
+
+    /////////////////////////////////////////////////////////////////
+    // reset the instance counts
+    glBindBuffer(GL_COPY_READ_BUFFER, commandTemplateBuffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, commandBuffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
+                        commandTemplate.size() * sizeof(DrawElementsIndirectCommand));
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+    /////////////////////////////////////////////////////////////////
+    // cull
+    Frustum frustum;
+    frustum.setFromMatrix(_viewProjectionMatrix);
+    QVector4D planes[6];
+
+    for(int i = 0; i < 6; ++i)
+    {
+        planes[i] = frustum.getPlane(i);
+    }
+
+    cullProgram->bind();
+    cullProgram->setUniformValueArray(uniFrustumPlanes, planes, 6);
+    cullProgram->setUniformValue(uniCameraPosition, _cameraPosition);
+    glUniform1ui(uniNumObjects, numObjects);
+    glUniform1i(uniUseObjectVisibility, useObjectVisibility ? 1 : 0);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, objectBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, lodBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, commandBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, _instanceBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, visibilityBuffer);
+
+    glDispatchCompute((numObjects + GPU_CULLING_GROUP_SIZE - 1) / GPU_CULLING_GROUP_SIZE,
+                      1, 1);
+
+    for(int i = 0; i < 5; ++i)
+    {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, i, 0);
+    }
+
+    cullProgram->release();
+
+    // the commands and instances are read by the draws, the counts by the stats
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT |
+                    GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    if(timeThisFrame)
+    {
+        glEndQuery(GL_TIME_ELAPSED);
+        timerQueryPending = true;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+void GpuCuller::drawCommands()
+{
+    if(!initialized || commandTemplate.isEmpty())
+    {
+        return;
+    }
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, NULL,
+                                commandTemplate.size(), 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+//------------------------------------------------------------------------------------------
+int GpuCuller::readNumVisibleObjects()
+{
+    if(!initialized || commandTemplate.isEmpty())
+    {
+        return 0;
+    }
+
+    QVector<DrawElementsIndirectCommand> commands(commandTemplate.size());
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+    glGetBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0,
+                       commands.size() * sizeof(DrawElementsIndirectCommand),
+                       commands.data());
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    int numVisible = 0;
+
+    for(int i = 0; i < commands.size(); ++i)
+    {
+        numVisible += commands[i].instanceCount;
+    }
+
+    return numVisible;
+}
+
+//------------------------------------------------------------------------------------------
+qint64 GpuCuller::getCullTimeNs()
+{
+    return cullTimeNs;
+}
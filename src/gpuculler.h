@@ -0,0 +1,112 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#ifndef GPUCULLER_H
+#define GPUCULLER_H
+
+#include <QtGui>
+#include <QOpenGLFunctions_4_3_Core>
+#include <QOpenGLShaderProgram>
+
+#include "meshpool.h"
+#include "scene.h"
+
+#define GPU_CULLING_GROUP_SIZE 64
+
+//------------------------------------------------------------------------------------------
+// Culls the scene objects on the GPU and draws them without any per-object CPU work: a
+// compute shader tests each object against the frustum, picks its LOD and appends it to
+// the instances of the DrawElementsIndirectCommand of that LOD, then all the commands
+// are issued by a single glMultiDrawElementsIndirect.
+// Needs OpenGL 4.3 (compute shaders, storage buffers, multi-draw indirect).
+//------------------------------------------------------------------------------------------
+class GpuCuller : protected QOpenGLFunctions_4_3_Core
+{
+public:
+    GpuCuller();
+    ~GpuCuller();
+
+    // return false if the current context does not support OpenGL 4.3
+    bool initialize();
+    bool isInitialized();
+
+    // one draw command per mesh LOD, each mesh has a single LOD for now
+    void setMeshes(MeshPool& _meshPool);
+    void uploadObjects(const Scene& _scene);
+
+    // only the listed objects may be drawn, on top of the frustum culling
+    void setObjectVisibility(const QVector<int>& _visibleObjects);
+    void clearObjectVisibility();
+
+    // the instance buffer must hold getInstanceCapacity() instances
+    int getInstanceCapacity();
+    void cull(const QMatrix4x4& _viewProjectionMatrix, const QVector3D& _cameraPosition,
+              GLuint _instanceBuffer);
+
+    // issue all draw commands, the vertex array object must be bound
+    void drawCommands();
+
+    // read back the instance counts, this waits for the culling to finish
+    int readNumVisibleObjects();
+    qint64 getCullTimeNs();
+
+private:
+    struct ObjectData
+    {
+        GLfloat modelMatrix[16];
+        GLfloat boundsMin[4];
+        GLfloat boundsMax[4];
+        GLint firstLod;
+        GLint numLods;
+        GLint materialIndex;
+        GLint padding;
+    };
+
+    struct DrawElementsIndirectCommand
+    {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint baseVertex;
+        GLuint baseInstance;
+    };
+
+    struct MeshLods
+    {
+        int firstLod;
+        int numLods;
+    };
+
+    bool initialized;
+    QOpenGLShaderProgram* cullProgram;
+    GLint uniFrustumPlanes;
+    GLint uniCameraPosition;
+    GLint uniNumObjects;
+    GLint uniUseObjectVisibility;
+
+    QVector<MeshLods> meshLods;
+    QVector<AABB> meshBounds;
+    QVector<GLfloat> lodDistances;
+    QVector<DrawElementsIndirectCommand> commandTemplate;
+    int numObjects;
+    int instanceCapacity;
+
+    GLuint objectBuffer;
+    GLuint lodBuffer;
+    GLuint commandBuffer;
+    GLuint commandTemplateBuffer;
+    GLuint visibilityBuffer;
+    QVector<GLuint> objectVisibility;
+    bool useObjectVisibility;
+
+    GLuint timerQuery;
+    bool timerQueryPending;
+    qint64 cullTimeNs;
+};
+
+#endif // GPUCULLER_H
@@ -0,0 +1,418 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#include "gpuprofiler.h"
+
+// query target of each pipeline statistics counter
+static const GLenum statisticsTargets[GpuProfiler::NUM_COUNTERS - 1] =
+{
+    GL_VERTEX_SHADER_INVOCATIONS_ARB,
+    GL_PRIMITIVES_SUBMITTED_ARB,
+    GL_FRAGMENT_SHADER_INVOCATIONS_ARB
+};
+
+static const char* counterNames[GpuProfiler::NUM_COUNTERS] =
+{
+    "ms",
+    "vertex_invocations",
+    "primitives",
+    "fragment_invocations"
+};
+
+//------------------------------------------------------------------------------------------
+// 1234567 -> 1.23M
+//------------------------------------------------------------------------------------------
+static QString formatCount(double _count)
+{
+    if(_count >= 1e6)
+    {
+        return QString("%1M").arg(_count * 1e-6, 0, 'f', 2);
+    }
+
+    if(_count >= 1e3)
+    {
+        return QString("%1k").arg(_count * 1e-3, 0, 'f', 1);
+    }
+
+    return QString::number(_count, 'f', 0);
+}
+
+//------------------------------------------------------------------------------------------
+GpuProfiler::GpuProfiler():
+    initialized(false),
+    pipelineStatistics(false),
+    currentBuffer(0),
+    frameCounter(0),
+    inFrame(false),
+    numDroppedFrames(0)
+{
+}
+
+//------------------------------------------------------------------------------------------
+GpuProfiler::~GpuProfiler()
+{
+    stopLogging();
+}
+
+//------------------------------------------------------------------------------------------
+void GpuProfiler::initialize(const QStringList& _passNames)
+{
+    initializeOpenGLFunctions();
+
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    pipelineStatistics = context &&
+                         context->hasExtension("GL_ARB_pipeline_statistics_query");
+    passNames = _passNames;
+
+    for(int i = 0; i < GPU_PROFILER_NUM_BUFFERS; ++i)
+    {
+        frames[i].passes.resize(passNames.size());
+        frames[i].frameIndex = 0;
+        frames[i].pending = false;
+
+        for(int pass = 0; pass < passNames.size(); ++pass)
+        {
+            PassQueries& queries = frames[i].passes[pass];
+            glGenQueries(1, &queries.timeQuery);
+
+            if(pipelineStatistics)
+            {
+                glGenQueries(NUM_COUNTERS - 1, queries.statisticsQueries);
+            }
+
+            queries.issued = false;
+        }
+    }
+
+    histories.resize(passNames.size());
+
+    for(int pass = 0; pass < passNames.size(); ++pass)
+    {
+        memset(&histories[pass], 0, sizeof(PassHistory));
+    }
+
+    initialized = true;
+
+    qDebug() << "GPU profiler:" << passNames.size() << "passes, pipeline statistics"
+             << (pipelineStatistics ? "supported" : "not supported");
+}
+
+//------------------------------------------------------------------------------------------
+bool GpuProfiler::isInitialized()
+{
+    return initialized;
+}
+
+//------------------------------------------------------------------------------------------
+bool GpuProfiler::hasPipelineStatistics()
+{
+    return pipelineStatistics;
+}
+
+//------------------------------------------------------------------------------------------
+// the buffer of this frame still holds the queries issued GPU_PROFILER_NUM_BUFFERS frames
+// ago, collect them before they are reused
+//------------------------------------------------------------------------------------------
+void GpuProfiler::beginFrame()
+{
+    if(!initialized)
+    {
+        return;
+    }
+
+    FrameQueries& frame = frames[currentBuffer];
+
+    if(frame.pending)
+    {
+        if(isFrameAvailable(frame))
+        {
+            collectFrame(frame);
+        }
+        else
+        {
+            ++numDroppedFrames;
+        }
+    }
+
+    for(int pass = 0; pass < frame.passes.size(); ++pass)
+    {
+        frame.passes[pass].issued = false;
+    }
+
+    frame.frameIndex = frameCounter;
+    frame.pending = false;
+    inFrame = true;
+}
+
+//------------------------------------------------------------------------------------------
+void GpuProfiler::endFrame()
+{
+    if(!inFrame)
+    {
+        return;
+    }
+
+    FrameQueries& frame = frames[currentBuffer];
+
+    for(int pass = 0; pass < frame.passes.size(); ++pass)
+    {
+        frame.pending = frame.pending || frame.passes[pass].issued;
+    }
+
+    inFrame = false;
+    currentBuffer = (currentBuffer + 1) % GPU_PROFILER_NUM_BUFFERS;
+    ++frameCounter;
+}
+
+//------------------------------------------------------------------------------------------
+void GpuProfiler::beginPass(int _pass)
+{
+    if(!inFrame)
+    {
+        return;
+    }
+
+    PassQueries& queries = frames[currentBuffer].passes[_pass];
+    glBeginQuery(GL_TIME_ELAPSED, queries.timeQuery);
+
+    if(pipelineStatistics)
+    {
+        for(int i = 0; i < NUM_COUNTERS - 1; ++i)
+        {
+            glBeginQuery(statisticsTargets[i], queries.statisticsQueries[i]);
+        }
+    }
+
+    queries.issued = true;
+}
+
+//------------------------------------------------------------------------------------------
+void GpuProfiler::endPass(int _pass)
+{
+    if(!inFrame)
+    {
+        return;
+    }
+
+    Q_UNUSED(_pass);
+
+    if(pipelineStatistics)
+    {
+        for(int i = NUM_COUNTERS - 2; i >= 0; --i)
+        {
+            glEndQuery(statisticsTargets[i]);
+        }
+    }
+
+    glEndQuery(GL_TIME_ELAPSED);
+}
+
+//------------------------------------------------------------------------------------------
+// the last query issued finishes last, but all of them are checked to be safe
+//------------------------------------------------------------------------------------------
+bool GpuProfiler::isFrameAvailable(const FrameQueries& _frame)
+{
+    for(int pass = 0; pass < _frame.passes.size(); ++pass)
+    {
+        const PassQueries& queries = _frame.passes[pass];
+
+        if(!queries.issued)
+        {
+            continue;
+        }
+
+        GLint available = 0;
+        glGetQueryObjectiv(queries.timeQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+
+        for(int i = 0; pipelineStatistics && available && i < NUM_COUNTERS - 1; ++i)
+        {
+            glGetQueryObjectiv(queries.statisticsQueries[i], GL_QUERY_RESULT_AVAILABLE,
+                               &available);
+        }
+
+        if(!available)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+void GpuProfiler::collectFrame(FrameQueries& _frame)
+{
+    QStringList row;
+    row.append(QString::number(_frame.frameIndex));
+
+    for(int pass = 0; pass < _frame.passes.size(); ++pass)
+    {
+        const PassQueries& queries = _frame.passes[pass];
+
+        if(!queries.issued)
+        {
+            for(int counter = 0; counter < NUM_COUNTERS; ++counter)
+            {
+                row.append(QString());
+            }
+
+            continue;
+        }
+
+        double values[NUM_COUNTERS];
+        GLuint64 result = 0;
+        glGetQueryObjectui64v(queries.timeQuery, GL_QUERY_RESULT, &result);
+        values[COUNTER_TIME] = (double) result * 1e-6;
+
+        for(int i = 0; i < NUM_COUNTERS - 1; ++i)
+        {
+            result = 0;
+
+            if(pipelineStatistics)
+            {
+                glGetQueryObjectui64v(queries.statisticsQueries[i], GL_QUERY_RESULT, &result);
+            }
+
+            values[i + 1] = (double) result;
+        }
+
+        /////////////////////////////////////////////////////////////////
+        // rolling averages
+        PassHistory& history = histories[pass];
+
+        for(int counter = 0; counter < NUM_COUNTERS; ++counter)
+        {
+            history.sums[counter] += values[counter] -
+                                     history.samples[counter][history.nextSample];
+            history.samples[counter][history.nextSample] = values[counter];
+            row.append(QString::number(values[counter], 'g', 8));
+        }
+
+        history.nextSample = (history.nextSample + 1) % GPU_PROFILER_AVERAGE_FRAMES;
+        history.numSamples = qMin(history.numSamples + 1, GPU_PROFILER_AVERAGE_FRAMES);
+    }
+
+    if(logFile.isOpen())
+    {
+        logStream << row.join(",") << "\n";
+    }
+}
+
+//------------------------------------------------------------------------------------------
+bool GpuProfiler::hasSamples(int _pass)
+{
+    return histories[_pass].numSamples > 0;
+}
+
+//------------------------------------------------------------------------------------------
+double GpuProfiler::getAverage(int _pass, Counter _counter)
+{
+    const PassHistory& history = histories[_pass];
+
+    if(history.numSamples == 0)
+    {
+        return 0.0;
+    }
+
+    return history.sums[_counter] / history.numSamples;
+}
+
+//------------------------------------------------------------------------------------------
+// one line per pass that has been rendered
+//------------------------------------------------------------------------------------------
+QStringList GpuProfiler::getSummary()
+{
+    QStringList lines;
+
+    for(int pass = 0; pass < passNames.size(); ++pass)
+    {
+        if(!hasSamples(pass))
+        {
+            continue;
+        }
+
+        QString line = QString("%1: %2 ms").arg(passNames[pass], -10)
+                       .arg(getAverage(pass, COUNTER_TIME), 0, 'f', 3);
+
+        if(pipelineStatistics)
+        {
+            line += QString(", vertices: %1, primitives: %2, fragments: %3")
+                    .arg(formatCount(getAverage(pass, COUNTER_VERTEX_INVOCATIONS)))
+                    .arg(formatCount(getAverage(pass, COUNTER_PRIMITIVES)))
+                    .arg(formatCount(getAverage(pass, COUNTER_FRAGMENT_INVOCATIONS)));
+        }
+
+        lines.append(line);
+    }
+
+    return lines;
+}
+
+//------------------------------------------------------------------------------------------
+int GpuProfiler::getNumDroppedFrames()
+{
+    return numDroppedFrames;
+}
+
+//------------------------------------------------------------------------------------------
+bool GpuProfiler::startLogging(const QString& _fileName)
+{
+    stopLogging();
+    logFile.setFileName(_fileName);
+
+    if(!logFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    {
+        qDebug() << "Cannot open GPU profile log:" << _fileName;
+        return false;
+    }
+
+    logStream.setDevice(&logFile);
+    writeLogHeader();
+
+    qDebug() << "GPU profile log:" << QFileInfo(logFile).absoluteFilePath();
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+void GpuProfiler::stopLogging()
+{
+    if(!logFile.isOpen())
+    {
+        return;
+    }
+
+    logStream.flush();
+    logStream.setDevice(NULL);
+    logFile.close();
+}
+
+//------------------------------------------------------------------------------------------
+bool GpuProfiler::isLogging()
+{
+    return logFile.isOpen();
+}
+
+//------------------------------------------------------------------------------------------
+// frame,<pass>_ms,<pass>_vertex_invocations,... the statistics are 0 when not supported
+//------------------------------------------------------------------------------------------
+void GpuProfiler::writeLogHeader()
+{
+    QStringList header;
+    header.append("frame");
+
+    for(int pass = 0; pass < passNames.size(); ++pass)
+    {
+        for(int counter = 0; counter < NUM_COUNTERS; ++counter)
+        {
+            header.append(passNames[pass] + "_" + counterNames[counter]);
+        }
+    }
+
+    logStream << header.join(",") << "\n";
+}
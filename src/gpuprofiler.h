@@ -0,0 +1,116 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#ifndef GPUPROFILER_H
+#define GPUPROFILER_H
+
+#include <QtGui>
+#include <QOpenGLFunctions_4_0_Core>
+
+// ARB_pipeline_statistics_query, core in OpenGL 4.6
+#ifndef GL_PRIMITIVES_SUBMITTED_ARB
+#define GL_PRIMITIVES_SUBMITTED_ARB 0x82EF
+#endif
+
+#ifndef GL_VERTEX_SHADER_INVOCATIONS_ARB
+#define GL_VERTEX_SHADER_INVOCATIONS_ARB 0x82F0
+#endif
+
+#ifndef GL_FRAGMENT_SHADER_INVOCATIONS_ARB
+#define GL_FRAGMENT_SHADER_INVOCATIONS_ARB 0x82F4
+#endif
+
+#define GPU_PROFILER_NUM_BUFFERS    2
+#define GPU_PROFILER_AVERAGE_FRAMES 60
+
+//------------------------------------------------------------------------------------------
+// Measures the GPU time of each render pass, and the pipeline statistics where the driver
+// supports them. The queries of a frame are read when their buffer comes around again,
+// GPU_PROFILER_NUM_BUFFERS frames later, and only if the results are available, so the
+// CPU never waits for the GPU: a frame whose results are not ready yet is dropped.
+// The passes must not be nested in another GL_TIME_ELAPSED query.
+//------------------------------------------------------------------------------------------
+class GpuProfiler : protected QOpenGLFunctions_4_0_Core
+{
+public:
+    enum Counter
+    {
+        COUNTER_TIME = 0,
+        COUNTER_VERTEX_INVOCATIONS,
+        COUNTER_PRIMITIVES,
+        COUNTER_FRAGMENT_INVOCATIONS,
+        NUM_COUNTERS
+    };
+
+    GpuProfiler();
+    ~GpuProfiler();
+
+    void initialize(const QStringList& _passNames);
+    bool isInitialized();
+    bool hasPipelineStatistics();
+
+    // the passes are only measured between beginFrame and endFrame
+    void beginFrame();
+    void endFrame();
+    void beginPass(int _pass);
+    void endPass(int _pass);
+
+    // averages over the last GPU_PROFILER_AVERAGE_FRAMES frames that rendered the pass,
+    // the time is in ms
+    bool hasSamples(int _pass);
+    double getAverage(int _pass, Counter _counter);
+    QStringList getSummary();
+    int getNumDroppedFrames();
+
+    // one row per measured frame
+    bool startLogging(const QString& _fileName);
+    void stopLogging();
+    bool isLogging();
+
+private:
+    struct PassQueries
+    {
+        GLuint timeQuery;
+        GLuint statisticsQueries[NUM_COUNTERS - 1];
+        bool issued;
+    };
+
+    struct FrameQueries
+    {
+        QVector<PassQueries> passes;
+        qint64 frameIndex;
+        bool pending;
+    };
+
+    struct PassHistory
+    {
+        double samples[NUM_COUNTERS][GPU_PROFILER_AVERAGE_FRAMES];
+        double sums[NUM_COUNTERS];
+        int nextSample;
+        int numSamples;
+    };
+
+    bool isFrameAvailable(const FrameQueries& _frame);
+    void collectFrame(FrameQueries& _frame);
+    void writeLogHeader();
+
+    bool initialized;
+    bool pipelineStatistics;
+    QStringList passNames;
+    FrameQueries frames[GPU_PROFILER_NUM_BUFFERS];
+    QVector<PassHistory> histories;
+    int currentBuffer;
+    qint64 frameCounter;
+    bool inFrame;
+    int numDroppedFrames;
+
+    QFile logFile;
+    QTextStream logStream;
+};
+
+#endif // GPUPROFILER_H
@@ -0,0 +1,441 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#include <algorithm>
+
+#include "headlessbenchmark.h"
+
+//------------------------------------------------------------------------------------------
+HeadlessBenchmark::HeadlessBenchmark()
+{
+}
+
+//------------------------------------------------------------------------------------------
+bool HeadlessBenchmark::parseArguments(const QStringList& _arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless benchmark of the renderer.");
+
+    QCommandLineOption benchmarkOption("benchmark", "Run the headless benchmark.");
+    QCommandLineOption traceOption("trace", "Trace from startup.");
+    QCommandLineOption meshOption("mesh", "Mesh object: teapot, bunny, icosphere, blob, "
+                                  "genus or thin.", "mesh", "bunny");
+    QCommandLineOption levelOption("level", "Size of the procedural mesh, see StressMesh.",
+                                   "n");
+    QCommandLineOption meshBudgetOption("mesh-budget", "GPU memory of the mesh cache.", "MB",
+                                        QString::number(MESH_POOL_DEFAULT_BUDGET >> 20));
+    QCommandLineOption shadingOption("shading", "Shading: phong or toon.", "shading", "phong");
+    QCommandLineOption silhouetteOption("silhouette", "Render the silhouette.");
+    QCommandLineOption shadowsOption("shadow-cascades", "Number of shadow map cascades, "
+                                     "0 without shadows.", "n",
+                                     QString::number(DEFAULT_SHADOW_CASCADES));
+    QCommandLineOption cameraOption("camera", "Camera path: orbit, zoom or a path file.",
+                                    "path", "orbit");
+    QCommandLineOption framesOption("frames", "Number of measured frames.", "n", "300");
+    QCommandLineOption warmupOption("warmup", "Number of warm-up frames.", "n", "10");
+    QCommandLineOption sizeOption("size", "Framebuffer size.", "WxH", "1280x720");
+    QCommandLineOption objectsOption("objects", "Number of scene objects.", "n", "1");
+    QCommandLineOption outputOption("output", "JSON output file, stdout otherwise.", "file");
+
+    parser.addOption(benchmarkOption);
+    parser.addOption(traceOption);
+    parser.addOption(meshOption);
+    parser.addOption(levelOption);
+    parser.addOption(meshBudgetOption);
+    parser.addOption(shadingOption);
+    parser.addOption(silhouetteOption);
+    parser.addOption(shadowsOption);
+    parser.addOption(cameraOption);
+    parser.addOption(framesOption);
+    parser.addOption(warmupOption);
+    parser.addOption(sizeOption);
+    parser.addOption(objectsOption);
+    parser.addOption(outputOption);
+
+    if(!parser.parse(_arguments))
+    {
+        qDebug() << "Error:" << parser.errorText();
+        qDebug().noquote() << parser.helpText();
+        return false;
+    }
+
+    /////////////////////////////////////////////////////////////////
+    // mesh and shading
+    QString mesh = parser.value(meshOption).toLower();
+    QString shading = parser.value(shadingOption).toLower();
+
+    options.meshObject = NUM_MESH_OBJECT;
+
+    for(int i = 0; i < NUM_MESH_OBJECT; ++i)
+    {
+        if(mesh == Renderer::getMeshObjectName((MeshObject) i))
+        {
+            options.meshObject = (MeshObject) i;
+        }
+    }
+
+    if(options.meshObject == NUM_MESH_OBJECT || (shading != "phong" && shading != "toon"))
+    {
+        qDebug() << "Error: unknown mesh" << mesh << "or shading" << shading;
+        qDebug().noquote() << parser.helpText();
+        return false;
+    }
+
+    options.stressMeshLevel = parser.isSet(levelOption) ?
+                              parser.value(levelOption).toInt() : -1;
+    options.shadingMode = (shading == "toon") ? ToonShading : PhongShading;
+    options.renderSilhouette = parser.isSet(silhouetteOption);
+    options.cameraPath = parser.value(cameraOption);
+    options.outputFile = parser.value(outputOption);
+
+    /////////////////////////////////////////////////////////////////
+    // numbers
+    bool validFrames, validWarmup, validObjects, validBudget, validShadows, validWidth,
+         validHeight;
+    options.numFrames = parser.value(framesOption).toInt(&validFrames);
+    options.numWarmupFrames = parser.value(warmupOption).toInt(&validWarmup);
+    options.numObjects = parser.value(objectsOption).toInt(&validObjects);
+    options.meshCacheBudget = parser.value(meshBudgetOption).toInt(&validBudget);
+    options.numShadowCascades = parser.value(shadowsOption).toInt(&validShadows);
+
+    QStringList size = parser.value(sizeOption).toLower().split("x");
+    validWidth = validHeight = false;
+
+    if(size.size() == 2)
+    {
+        options.size = QSize(size[0].toInt(&validWidth), size[1].toInt(&validHeight));
+    }
+
+    if(!validFrames || !validWarmup || !validObjects || !validBudget || !validShadows ||
+       !validWidth || !validHeight || options.numFrames < 1 || options.numWarmupFrames < 0 ||
+       options.numObjects < 1 || options.meshCacheBudget < 0 ||
+       options.numShadowCascades < 0 || options.numShadowCascades > SHADOW_MAX_CASCADES ||
+       options.size.isEmpty())
+    {
+        qDebug() << "Error: invalid number of frames, objects, mesh budget, shadow cascades "
+                 "or framebuffer size";
+        qDebug().noquote() << parser.helpText();
+        return false;
+    }
+
+    return buildCameraPath();
+}
+
+//------------------------------------------------------------------------------------------
+int HeadlessBenchmark::run()
+{
+    /////////////////////////////////////////////////////////////////
+    // offscreen context, with the format requested by main
+    QOpenGLContext context;
+    context.setFormat(QSurfaceFormat::defaultFormat());
+
+    QOffscreenSurface surface;
+    surface.setFormat(context.format());
+    surface.create();
+
+    if(!context.create() || !surface.isValid() || !context.makeCurrent(&surface))
+    {
+        qDebug() << "Error: cannot create the offscreen OpenGL context";
+        return EXIT_FAILURE;
+    }
+
+    QOpenGLFunctions* functions = context.functions();
+    QString glRenderer = (const char*) functions->glGetString(GL_RENDERER);
+    QString glVersion = (const char*) functions->glGetString(GL_VERSION);
+    qDebug() << "Benchmark on" << glRenderer << glVersion;
+
+    QOpenGLFramebufferObject* framebuffer =
+        new QOpenGLFramebufferObject(options.size, QOpenGLFramebufferObject::Depth);
+    framebuffer->bind();
+
+    /////////////////////////////////////////////////////////////////
+    // load everything before the first measured frame
+    QElapsedTimer timer;
+    timer.start();
+
+    Renderer* renderer = new Renderer;
+    renderer->enableRenderSilhouette(options.renderSilhouette);
+
+    // the reported level is the one rendered, the default one without --level
+    if(options.meshObject >= FIRST_STRESS_MESH_OBJECT)
+    {
+        StressMeshType stressMeshType = (StressMeshType)(options.meshObject -
+                                                         FIRST_STRESS_MESH_OBJECT);
+
+        if(options.stressMeshLevel >= 0)
+        {
+            renderer->setStressMeshLevel(stressMeshType, options.stressMeshLevel);
+        }
+
+        options.stressMeshLevel = renderer->getStressMeshLevel(stressMeshType);
+    }
+
+    renderer->setMeshCacheBudget(options.meshCacheBudget);
+    renderer->setNumShadowCascades(options.numShadowCascades);
+    renderer->initializeHeadless(options.size, options.meshObject, options.shadingMode,
+                                 options.numObjects);
+    functions->glFinish();
+
+    double initTime = (double) timer.nsecsElapsed() * 1e-6;
+
+    for(int frame = 0; frame < options.numWarmupFrames; ++frame)
+    {
+        int pathIndex = frame % cameraPositions.size();
+        renderer->renderHeadlessFrame(cameraPositions[pathIndex], cameraFocuses[pathIndex]);
+        functions->glFinish();
+    }
+
+    /////////////////////////////////////////////////////////////////
+    // the triangle counts are read after each frame has been timed
+    QVector<double> frameTimes(options.numFrames);
+    qint64 numTriangles = 0;
+
+    for(int frame = 0; frame < options.numFrames; ++frame)
+    {
+        int pathIndex = frame % cameraPositions.size();
+
+        timer.start();
+        renderer->renderHeadlessFrame(cameraPositions[pathIndex], cameraFocuses[pathIndex]);
+        functions->glFinish();
+        frameTimes[frame] = (double) timer.nsecsElapsed() * 1e-6;
+
+        numTriangles += renderer->getNumRenderedTriangles();
+    }
+
+    MeshPoolStats meshCacheStats = renderer->getMeshCacheStats();
+    ShadowStats shadowStats = renderer->getShadowStats();
+    delete renderer;
+    framebuffer->release();
+    delete framebuffer;
+    context.doneCurrent();
+
+    /////////////////////////////////////////////////////////////////
+    // results
+    double totalTime = 0.0;
+
+    for(int frame = 0; frame < options.numFrames; ++frame)
+    {
+        totalTime += frameTimes[frame];
+    }
+
+    QJsonObject results;
+    results["renderer"] = glRenderer;
+    results["glVersion"] = glVersion;
+    results["mesh"] = Renderer::getMeshObjectName(options.meshObject);
+
+    if(options.meshObject >= FIRST_STRESS_MESH_OBJECT)
+    {
+        results["meshLevel"] = options.stressMeshLevel;
+    }
+
+    results["shading"] = (options.shadingMode == ToonShading) ? "toon" : "phong";
+    results["silhouette"] = options.renderSilhouette;
+    results["camera"] = options.cameraPath;
+    results["objects"] = options.numObjects;
+    results["width"] = options.size.width();
+    results["height"] = options.size.height();
+    results["frames"] = options.numFrames;
+    results["warmupFrames"] = options.numWarmupFrames;
+    results["initTimeMs"] = initTime;
+    results["frameTimeMs"] = getFrameTimeStats(frameTimes);
+    results["framesPerSecond"] = options.numFrames / (totalTime * 1e-3);
+    results["trianglesPerSecond"] = (double) numTriangles / (totalTime * 1e-3);
+    results["pixelsPerSecond"] = (double) options.size.width() * options.size.height() *
+                                 options.numFrames / (totalTime * 1e-3);
+    results["peakMemoryKB"] = (double) getPeakMemoryKB();
+
+    QJsonObject meshCache;
+    meshCache["budgetMB"] = options.meshCacheBudget;
+    meshCache["bytesInUse"] = (double) meshCacheStats.bytesInUse;
+    meshCache["capacityBytes"] = (double) meshCacheStats.capacityBytes;
+    meshCache["residentMeshes"] = meshCacheStats.numResidentMeshes;
+    meshCache["hits"] = meshCacheStats.numHits;
+    meshCache["misses"] = meshCacheStats.numMisses;
+    meshCache["evictions"] = meshCacheStats.numEvictions;
+    results["meshCache"] = meshCache;
+
+    QJsonObject shadows;
+    shadows["cascades"] = options.numShadowCascades;
+    shadows["updates"] = shadowStats.numUpdates;
+    shadows["cachedUpdates"] = shadowStats.numCachedUpdates;
+    results["shadows"] = shadows;
+
+    QByteArray json = QJsonDocument(results).toJson();
+
+    if(options.outputFile.isEmpty())
+    {
+        QTextStream(stdout) << json;
+        return EXIT_SUCCESS;
+    }
+
+    QFile file(options.outputFile);
+
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qDebug() << "Error: cannot write" << options.outputFile;
+        return EXIT_FAILURE;
+    }
+
+    file.write(json);
+
+    return EXIT_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------
+// one camera per measured frame for the generated paths, the path file is looped over
+//------------------------------------------------------------------------------------------
+bool HeadlessBenchmark::buildCameraPath()
+{
+    cameraPositions.clear();
+    cameraFocuses.clear();
+
+    QVector3D focus = DEFAULT_CAMERA_FOCUS;
+    QVector3D eyeVector = DEFAULT_CAMERA_POSITION - DEFAULT_CAMERA_FOCUS;
+
+    if(options.cameraPath == "orbit")
+    {
+        float radius = eyeVector.length();
+
+        for(int frame = 0; frame < options.numFrames; ++frame)
+        {
+            float angle = 2.0f * (float) M_PI * frame / options.numFrames;
+            cameraPositions.append(focus + QVector3D(radius * sin(angle), 0.0f,
+                                                     radius * cos(angle)));
+            cameraFocuses.append(focus);
+        }
+
+        return true;
+    }
+
+    // move in to 30% of the default distance and back out
+    if(options.cameraPath == "zoom")
+    {
+        for(int frame = 0; frame < options.numFrames; ++frame)
+        {
+            float angle = 2.0f * (float) M_PI * frame / options.numFrames;
+            float distance = 1.0f - 0.35f * (1.0f - cos(angle));
+            cameraPositions.append(focus + eyeVector * distance);
+            cameraFocuses.append(focus);
+        }
+
+        return true;
+    }
+
+    return loadCameraPathFile(options.cameraPath);
+}
+
+//------------------------------------------------------------------------------------------
+// px py pz [fx fy fz] per line, # starts a comment, the focus is the default one if omitted
+//------------------------------------------------------------------------------------------
+bool HeadlessBenchmark::loadCameraPathFile(const QString& _fileName)
+{
+    QFile file(_fileName);
+
+    if(!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        qDebug() << "Error: camera path is not orbit, zoom, or a readable file:" << _fileName;
+        return false;
+    }
+
+    QTextStream stream(&file);
+    int lineNumber = 0;
+
+    while(!stream.atEnd())
+    {
+        QString line = stream.readLine().section('#', 0, 0).trimmed();
+        ++lineNumber;
+
+        if(line.isEmpty())
+        {
+            continue;
+        }
+
+        QStringList fields = line.split(QRegExp("\\s+"));
+        float values[6];
+        bool valid = (fields.size() == 3 || fields.size() == 6);
+
+        for(int i = 0; valid && i < fields.size(); ++i)
+        {
+            values[i] = fields[i].toFloat(&valid);
+        }
+
+        if(!valid)
+        {
+            qDebug() << "Error: invalid camera at line" << lineNumber << "of" << _fileName;
+            return false;
+        }
+
+        cameraPositions.append(QVector3D(values[0], values[1], values[2]));
+        cameraFocuses.append(fields.size() == 6 ?
+                             QVector3D(values[3], values[4], values[5]) :
+                             DEFAULT_CAMERA_FOCUS);
+    }
+
+    if(cameraPositions.isEmpty())
+    {
+        qDebug() << "Error: empty camera path" << _fileName;
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+// nearest-rank percentiles
+//------------------------------------------------------------------------------------------
+QJsonObject HeadlessBenchmark::getFrameTimeStats(QVector<double> _frameTimes)
+{
+    std::sort(_frameTimes.begin(), _frameTimes.end());
+
+    double sum = 0.0;
+
+    for(int i = 0; i < _frameTimes.size(); ++i)
+    {
+        sum += _frameTimes[i];
+    }
+
+    QJsonObject stats;
+    stats["mean"] = sum / _frameTimes.size();
+    stats["min"] = _frameTimes.first();
+    stats["max"] = _frameTimes.last();
+
+    const int percentiles[] = {50, 95, 99};
+
+    for(int i = 0; i < 3; ++i)
+    {
+        int rank = (int) ceil(percentiles[i] / 100.0 * _frameTimes.size());
+        stats[QString("p%1").arg(percentiles[i])] = _frameTimes[qMax(rank, 1) - 1];
+    }
+
+    return stats;
+}
+
+//------------------------------------------------------------------------------------------
+// the high water mark of the resident memory, -1 where it is not available
+//------------------------------------------------------------------------------------------
+qint64 HeadlessBenchmark::getPeakMemoryKB()
+{
+#ifdef Q_OS_LINUX
+    QFile file("/proc/self/status");
+
+    if(file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        QList<QByteArray> lines = file.readAll().split('\n');
+
+        for(int i = 0; i < lines.size(); ++i)
+        {
+            if(lines[i].startsWith("VmHWM:"))
+            {
+                return lines[i].mid(6).trimmed().split(' ').first().toLongLong();
+            }
+        }
+    }
+#endif
+
+    return -1;
+}
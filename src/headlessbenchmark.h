@@ -0,0 +1,78 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#ifndef HEADLESSBENCHMARK_H
+#define HEADLESSBENCHMARK_H
+
+#include <QtGui>
+#include <QtWidgets>
+#include <QOffscreenSurface>
+#include <QOpenGLFramebufferObject>
+
+#include "renderer.h"
+
+//------------------------------------------------------------------------------------------
+struct BenchmarkOptions
+{
+    BenchmarkOptions():
+        meshObject(BUNNY_OBJ),
+        stressMeshLevel(-1),
+        meshCacheBudget(MESH_POOL_DEFAULT_BUDGET >> 20),
+        shadingMode(PhongShading),
+        renderSilhouette(false),
+        numShadowCascades(DEFAULT_SHADOW_CASCADES),
+        cameraPath("orbit"),
+        numFrames(300),
+        numWarmupFrames(10),
+        size(1280, 720),
+        numObjects(1) {}
+
+    MeshObject meshObject;
+    int stressMeshLevel; // default level of the procedural mesh if negative, resolved by run()
+    int meshCacheBudget; // MB
+    ShadingProgram shadingMode;
+    bool renderSilhouette;
+    int numShadowCascades; // 0 without shadows
+    QString cameraPath; // orbit, zoom, or a file of "px py pz [fx fy fz]" lines
+    int numFrames;
+    int numWarmupFrames;
+    QSize size;
+    int numObjects;
+    QString outputFile; // stdout if empty
+};
+
+//------------------------------------------------------------------------------------------
+// Silhouette --benchmark [options]: renders a deterministic camera path into a framebuffer
+// object on an offscreen surface, no window is shown, and reports the frame times as JSON.
+// Each frame is timed up to glFinish, so the times are meaningful on software renderers.
+// On a machine without GPU, it runs on Mesa llvmpipe:
+//     LIBGL_ALWAYS_SOFTWARE=1 xvfb-run -a ./Silhouette --benchmark --frames 100
+//------------------------------------------------------------------------------------------
+class HeadlessBenchmark
+{
+public:
+    HeadlessBenchmark();
+
+    // print the usage or the error and return false on invalid arguments
+    bool parseArguments(const QStringList& _arguments);
+
+    // return the exit code of the program
+    int run();
+
+private:
+    bool buildCameraPath();
+    bool loadCameraPathFile(const QString& _fileName);
+    QJsonObject getFrameTimeStats(QVector<double> _frameTimes);
+    static qint64 getPeakMemoryKB();
+
+    BenchmarkOptions options;
+    QVector<QVector3D> cameraPositions;
+    QVector<QVector3D> cameraFocuses;
+};
+
+#endif // HEADLESSBENCHMARK_H
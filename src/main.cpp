@@ -11,17 +11,37 @@
 #include <QtOpenGL/qgl.h>
 
 #include "mainwindow.h"
+#include "headlessbenchmark.h"
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
 
+    // trace from startup, T dumps the trace
+    if(a.arguments().contains("--trace"))
+    {
+        Tracer::setEnabled(true);
+    }
+
     QSurfaceFormat format;
     format.setVersion(4, 0);
     format.setSwapBehavior(QSurfaceFormat::DoubleBuffer);
     format.setProfile(QSurfaceFormat::CoreProfile);
     QSurfaceFormat::setDefaultFormat(format);
 
+    // no window, the results are printed as JSON
+    if(a.arguments().contains("--benchmark"))
+    {
+        HeadlessBenchmark benchmark;
+
+        if(!benchmark.parseArguments(a.arguments()))
+        {
+            return EXIT_FAILURE;
+        }
+
+        return benchmark.run();
+    }
+
     MainWindow mainWindow;
     mainWindow.show();
     mainWindow.setGeometry( QStyle::alignedRect(Qt::LeftToRight, Qt::AlignCenter,
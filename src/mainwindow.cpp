@@ -13,10 +13,7 @@ MainWindow::MainWindow(QWidget* parent) : QWidget(parent)
 
     setupGUI();
 
-    // Update continuously
-    QTimer* timer = new QTimer(this);
-    connect(timer, SIGNAL(timeout()), renderer, SLOT(update()));
-    timer->start(10);
+    // the renderer schedules its own frames, only while something moves or changes
 }
 
 //------------------------------------------------------------------------------------------
@@ -52,12 +49,40 @@ void MainWindow::keyPressEvent(QKeyEvent* e)
         nextMeshObjectTexture();
         break;
 
+    case Qt::Key_B:
+        renderer->benchmarkShaderVariants();
+        break;
+
+    case Qt::Key_I:
+        renderer->benchmarkInstancing();
+        break;
+
+    case Qt::Key_T:
+        toggleTracing();
+        break;
+
     default:
         renderer->keyPressEvent(e);
     }
 }
 
 
+//------------------------------------------------------------------------------------------
+// start tracing, or stop and dump what has been recorded
+//------------------------------------------------------------------------------------------
+void MainWindow::toggleTracing()
+{
+    if(!Tracer::isEnabled())
+    {
+        qDebug() << "Tracing started, press T again to dump" << TRACE_FILE;
+        Tracer::setEnabled(true);
+        return;
+    }
+
+    Tracer::setEnabled(false);
+    Tracer::dumpChromeTrace(TRACE_FILE);
+}
+
 //------------------------------------------------------------------------------------------
 void MainWindow::setupGUI()
 {
@@ -82,17 +107,55 @@ void MainWindow::setupGUI()
     QCheckBox* chkRenderSilhouette = new QCheckBox("Render Silhouette");
     shadingLayout->addWidget(chkRenderSilhouette, 1, 0, 1, 2);
 
+    QCheckBox* chkDepthPrepass = new QCheckBox("Depth Pre-pass (Phong)");
+    chkDepthPrepass->setChecked(true);
+    shadingLayout->addWidget(chkDepthPrepass, 2, 0, 1, 2);
+
+    QSpinBox* spbShadowCascades = new QSpinBox;
+    spbShadowCascades->setRange(0, SHADOW_MAX_CASCADES);
+    spbShadowCascades->setSpecialValueText("Off");
+    spbShadowCascades->setValue(DEFAULT_SHADOW_CASCADES);
+    shadingLayout->addWidget(new QLabel("Shadow cascades:"), 3, 0);
+    shadingLayout->addWidget(spbShadowCascades, 3, 1);
+
 
     foreach (QRadioButton* rdbShading, rdb2ShadingMap.keys())
     {
         connect(rdbShading, SIGNAL(clicked(bool)), this, SLOT(changeShadingMode(bool)));
     }
     connect(chkRenderSilhouette, &QCheckBox::toggled, renderer, &Renderer::enableRenderSilhouette);
+    connect(chkDepthPrepass, &QCheckBox::toggled, renderer, &Renderer::enableDepthPrepass);
+    connect(spbShadowCascades, SIGNAL(valueChanged(int)), renderer,
+            SLOT(setNumShadowCascades(int)));
 
     QGroupBox* shadingGroup = new QGroupBox("Shading Modes");
     shadingGroup->setLayout(shadingLayout);
 
 
+    ////////////////////////////////////////////////////////////////////////////////
+    // toon shading bands
+    txtToonDiffuseBands = new QLineEdit(renderer->getToonDiffuseBands());
+    txtToonSpecularBands = new QLineEdit(renderer->getToonSpecularBands());
+
+    QString strBandsToolTip("Comma separated threshold:level pairs, in range [0, 1]");
+    txtToonDiffuseBands->setToolTip(strBandsToolTip);
+    txtToonSpecularBands->setToolTip(strBandsToolTip);
+
+    QGridLayout* toonBandsLayout = new QGridLayout;
+    toonBandsLayout->addWidget(new QLabel("Diffuse:"), 0, 0);
+    toonBandsLayout->addWidget(txtToonDiffuseBands, 0, 1);
+    toonBandsLayout->addWidget(new QLabel("Specular:"), 1, 0);
+    toonBandsLayout->addWidget(txtToonSpecularBands, 1, 1);
+
+    QGroupBox* toonBandsGroup = new QGroupBox("Toon Shading Bands");
+    toonBandsGroup->setLayout(toonBandsLayout);
+
+    connect(txtToonDiffuseBands, SIGNAL(editingFinished()), this,
+            SLOT(changeToonDiffuseBands()));
+    connect(txtToonSpecularBands, SIGNAL(editingFinished()), this,
+            SLOT(changeToonSpecularBands()));
+
+
     ////////////////////////////////////////////////////////////////////////////////
     // mesh object textures
     QGridLayout* meshObjectTextureLayout = new QGridLayout;
@@ -136,6 +199,18 @@ void MainWindow::setupGUI()
 
     str = QString("Bunny");
     cbMeshObject->addItem(str);
+
+    str = QString("Icosphere");
+    cbMeshObject->addItem(str);
+
+    str = QString("Noise Blob");
+    cbMeshObject->addItem(str);
+
+    str = QString("High Genus Plate");
+    cbMeshObject->addItem(str);
+
+    str = QString("Thin Spikes");
+    cbMeshObject->addItem(str);
     QGridLayout* meshObjectLayout = new QGridLayout;
     meshObjectLayout->addWidget(cbMeshObject, 0, 0, 1, 3);
     QGroupBox* meshObjectGroup = new QGroupBox("Mesh Object");
@@ -157,6 +232,33 @@ void MainWindow::setupGUI()
             SLOT(prevMeshObject()));
     connect(btnNextMeshObject, SIGNAL(clicked()), this, SLOT(nextMeshObject()));
 
+    QSpinBox* spbNumObjects = new QSpinBox;
+    spbNumObjects->setRange(1, MAX_INSTANCES);
+    spbNumObjects->setValue(renderer->getNumSceneObjects());
+    meshObjectLayout->addWidget(new QLabel("Objects:"), 1, 0, 1, 1);
+    meshObjectLayout->addWidget(spbNumObjects, 1, 1, 1, 4);
+
+    QCheckBox* chkAnimateObjects = new QCheckBox("Animate objects");
+    chkAnimateObjects->setChecked(false);
+    meshObjectLayout->addWidget(chkAnimateObjects, 2, 0, 1, 2);
+
+    QCheckBox* chkOcclusionCulling = new QCheckBox("Occlusion culling");
+    chkOcclusionCulling->setChecked(false);
+    meshObjectLayout->addWidget(chkOcclusionCulling, 2, 2, 1, 3);
+
+    QLabel* lblSceneStats = new QLabel;
+    lblSceneStats->setWordWrap(true);
+    meshObjectLayout->addWidget(lblSceneStats, 3, 0, 1, 5);
+
+    connect(spbNumObjects, SIGNAL(valueChanged(int)), renderer,
+            SLOT(setNumSceneObjects(int)));
+    connect(chkAnimateObjects, SIGNAL(toggled(bool)), renderer,
+            SLOT(enableAnimateSceneObjects(bool)));
+    connect(chkOcclusionCulling, SIGNAL(toggled(bool)), renderer,
+            SLOT(enableOcclusionCulling(bool)));
+    connect(renderer, SIGNAL(sceneStatsChanged(QString)), lblSceneStats,
+            SLOT(setText(QString)));
+
 
 
     ////////////////////////////////////////////////////////////////////////////////
@@ -210,6 +312,7 @@ void MainWindow::setupGUI()
     // Add slider group to parameter group
     QVBoxLayout* parameterLayout = new QVBoxLayout;
     parameterLayout->addWidget(shadingGroup);
+    parameterLayout->addWidget(toonBandsGroup);
     parameterLayout->addWidget(meshObjectTextureGroup);
     parameterLayout->addWidget(meshObjectGroup);
     parameterLayout->addWidget(lightIntensityGroup);
@@ -318,3 +421,22 @@ void MainWindow::nextMeshObject()
         cbMeshObject->setCurrentIndex(0);
     }
 }
+
+//------------------------------------------------------------------------------------------
+void MainWindow::changeToonDiffuseBands()
+{
+    // restore the current bands if the input is invalid
+    if(!renderer->setToonDiffuseBands(txtToonDiffuseBands->text()))
+    {
+        txtToonDiffuseBands->setText(renderer->getToonDiffuseBands());
+    }
+}
+
+//------------------------------------------------------------------------------------------
+void MainWindow::changeToonSpecularBands()
+{
+    if(!renderer->setToonSpecularBands(txtToonSpecularBands->text()))
+    {
+        txtToonSpecularBands->setText(renderer->getToonSpecularBands());
+    }
+}
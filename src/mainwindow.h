@@ -37,6 +37,9 @@ public slots:
     void nextMeshObjectTexture();
     void prevMeshObject();
     void nextMeshObject();
+    void changeToonDiffuseBands();
+    void changeToonSpecularBands();
+    void toggleTracing();
 
 private:
     Renderer* renderer;
@@ -48,6 +51,9 @@ private:
 
     QComboBox* cbMeshObjectTexture;
 
+    QLineEdit* txtToonDiffuseBands;
+    QLineEdit* txtToonSpecularBands;
+
 };
 
 #endif // MAINWINDOW_H
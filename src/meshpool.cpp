@@ -0,0 +1,694 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#include "meshpool.h"
+#include "tracer.h"
+
+//------------------------------------------------------------------------------------------
+MeshPool::MeshPool():
+    useCounter(0),
+    budget(MESH_POOL_DEFAULT_BUDGET),
+    vertexCapacity(0),
+    indexCapacity(0),
+    bufferGeneration(0),
+    vertexBuffer(QOpenGLBuffer::VertexBuffer),
+    indexBuffer(QOpenGLBuffer::IndexBuffer)
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+//------------------------------------------------------------------------------------------
+MeshPool::~MeshPool()
+{
+    qDeleteAll(meshGeometries);
+}
+
+//------------------------------------------------------------------------------------------
+void MeshPool::initialize()
+{
+    initializeOpenGLFunctions();
+}
+
+//------------------------------------------------------------------------------------------
+// the buffers are kept, all their ranges become free
+//------------------------------------------------------------------------------------------
+void MeshPool::clear()
+{
+    meshRanges.clear();
+    assetPaths.clear();
+    lastUses.clear();
+    qDeleteAll(meshGeometries);
+    meshGeometries.clear();
+
+    freeVertexRanges.clear();
+    freeIndexRanges.clear();
+
+    if(vertexCapacity > 0)
+    {
+        freeVertexRanges.insert(0, vertexCapacity);
+        freeIndexRanges.insert(0, indexCapacity);
+    }
+
+    int numHits = stats.numHits;
+    int numMisses = stats.numMisses;
+    int numEvictions = stats.numEvictions;
+    memset(&stats, 0, sizeof(stats));
+    stats.numHits = numHits;
+    stats.numMisses = numMisses;
+    stats.numEvictions = numEvictions;
+    stats.capacityBytes = getCapacitySize(vertexCapacity, indexCapacity);
+}
+
+//------------------------------------------------------------------------------------------
+int MeshPool::addMesh(const QString& _assetPath)
+{
+    MeshRange range;
+    range.firstIndex = 0;
+    range.indexCount = 0;
+    range.baseVertex = 0;
+    range.numVertices = 0;
+    range.loaded = false;
+    range.resident = false;
+    range.scalingFactor = 1.0f;
+    range.lowestYCoordinate = 0.0f;
+
+    meshRanges.append(range);
+    assetPaths.append(_assetPath);
+    lastUses.append(0);
+    meshGeometries.append(NULL);
+
+    return meshRanges.size() - 1;
+}
+
+//------------------------------------------------------------------------------------------
+QString MeshPool::getStressMeshAssetPath(StressMeshType _type, int _level)
+{
+    return QString(STRESS_MESH_ASSET_PREFIX "%1:%2").arg(StressMesh::getName(_type))
+           .arg(_level);
+}
+
+//------------------------------------------------------------------------------------------
+// a hit only refreshes the order of use, a miss loads the asset, evicts the least
+// recently used meshes over budget and uploads the mesh into free ranges of the buffers,
+// see allocateMesh()
+//------------------------------------------------------------------------------------------
+bool MeshPool::makeResident(int _meshIndex, OBJLoader* _objLoader)
+{
+    TRACE_SCOPE("makeMeshResident");
+
+    lastUses[_meshIndex] = ++useCounter;
+    MeshRange& range = meshRanges[_meshIndex];
+
+    if(range.resident)
+    {
+        ++stats.numHits;
+        return true;
+    }
+
+    ++stats.numMisses;
+
+    if(!loadAsset(assetPaths[_meshIndex], _objLoader))
+    {
+        return false;
+    }
+
+    delete meshGeometries[_meshIndex];
+    meshGeometries[_meshIndex] = weldMesh(_meshIndex, _objLoader);
+    _objLoader->clearData();
+
+    qint64 meshSize = getMeshSize(range);
+
+    while(stats.bytesInUse + meshSize > budget)
+    {
+        int leastRecentlyUsed = findLeastRecentlyUsed(_meshIndex);
+
+        if(leastRecentlyUsed < 0)
+        {
+            qDebug() << "Mesh" << assetPaths[_meshIndex] << "alone exceeds the budget of"
+                     << budget / 1048576 << "MB";
+            break;
+        }
+
+        evictMesh(leastRecentlyUsed);
+    }
+
+    uploadMesh(_meshIndex);
+
+    qDebug() << "Mesh cache miss:" << assetPaths[_meshIndex] << "," << meshSize / 1024 <<
+             "KB, in use" << stats.bytesInUse / 1024 << "KB, allocated" <<
+             stats.capacityBytes / 1024 << "KB of" << budget / 1024 << "KB";
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+bool MeshPool::isResident(int _meshIndex)
+{
+    return meshRanges[_meshIndex].resident;
+}
+
+//------------------------------------------------------------------------------------------
+// the meshes over the new budget are evicted and the buffers shrunk when the next one is
+// loaded
+//------------------------------------------------------------------------------------------
+void MeshPool::setBudget(qint64 _bytes)
+{
+    budget = qMax((qint64) 0, _bytes);
+}
+
+//------------------------------------------------------------------------------------------
+qint64 MeshPool::getBudget()
+{
+    return budget;
+}
+
+//------------------------------------------------------------------------------------------
+const MeshPoolStats& MeshPool::getStats()
+{
+    return stats;
+}
+
+//------------------------------------------------------------------------------------------
+int MeshPool::getBufferGeneration()
+{
+    return bufferGeneration;
+}
+
+//------------------------------------------------------------------------------------------
+bool MeshPool::loadAsset(const QString& _assetPath, OBJLoader* _objLoader)
+{
+    if(!_assetPath.startsWith(STRESS_MESH_ASSET_PREFIX))
+    {
+        return _objLoader->loadObjFile(_assetPath.toLocal8Bit().constData());
+    }
+
+    QStringList fields = _assetPath.mid(QString(STRESS_MESH_ASSET_PREFIX).size()).split(':');
+
+    for(int i = 0; i < NUM_STRESS_MESH && fields.size() == 2; ++i)
+    {
+        if(fields[0] == StressMesh::getName((StressMeshType) i))
+        {
+            return _objLoader->loadStressMesh((StressMeshType) i, fields[1].toInt());
+        }
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------------------------------------
+// the corners with exactly the same attributes become one vertex, the geometry is
+// allocated for the worst case then squeezed to the welded size
+//------------------------------------------------------------------------------------------
+GeometryBuffer* MeshPool::weldMesh(int _meshIndex, OBJLoader* _objLoader)
+{
+    MeshRange& range = meshRanges[_meshIndex];
+    int numCorners = _objLoader->getNumVertices();
+    const GLfloat* cornerVertices = _objLoader->getVertices();
+    const GLfloat* cornerNormals = _objLoader->getNormals();
+    const GLfloat* cornerTexCoords = _objLoader->getTexureCoordinates();
+    const GLfloat* cornerTangents = _objLoader->getTangents();
+
+    range.indexCount = numCorners;
+    range.bounds = AABB(_objLoader->getBoundingBoxMin(), _objLoader->getBoundingBoxMax());
+    range.scalingFactor = _objLoader->getScalingFactor();
+    range.lowestYCoordinate = _objLoader->getLowestYCoordinate();
+    range.loaded = true;
+
+    GeometryBuffer* geometry = new GeometryBuffer;
+    geometry->allocate(numCorners, numCorners, GEOMETRY_POSITIONS | GEOMETRY_NORMALS |
+                       GEOMETRY_TEXCOORDS | GEOMETRY_TANGENTS, GL_UNSIGNED_INT);
+
+    GLfloat* vertices = geometry->getAttribute(POSITION_ATTRIBUTE);
+    GLfloat* normals = geometry->getAttribute(NORMAL_ATTRIBUTE);
+    GLfloat* texCoords = geometry->getAttribute(TEXCOORD_ATTRIBUTE);
+    GLfloat* tangents = geometry->getAttribute(TANGENT_ATTRIBUTE);
+    GLuint* indices = (GLuint*) geometry->getIndices();
+
+    QHash<QByteArray, GLuint> vertexMap;
+    GLuint numMeshVertices = 0;
+    GLfloat key[12];
+
+    for(int i = 0; i < numCorners; ++i)
+    {
+        memcpy(key, cornerVertices + 3 * i, 3 * sizeof(GLfloat));
+        memcpy(key + 3, cornerNormals + 3 * i, 3 * sizeof(GLfloat));
+        memcpy(key + 6, cornerTexCoords + 2 * i, 2 * sizeof(GLfloat));
+        memcpy(key + 8, cornerTangents + 4 * i, 4 * sizeof(GLfloat));
+
+        QByteArray keyData = QByteArray::fromRawData((const char*) key, sizeof(key));
+        QHash<QByteArray, GLuint>::const_iterator it = vertexMap.constFind(keyData);
+
+        if(it != vertexMap.constEnd())
+        {
+            indices[i] = it.value();
+            continue;
+        }
+
+        // fromRawData does not copy, the stored key must own its data
+        vertexMap.insert(QByteArray((const char*) key, sizeof(key)), numMeshVertices);
+        indices[i] = numMeshVertices;
+
+        memcpy(vertices + 3 * numMeshVertices, key, 3 * sizeof(GLfloat));
+        memcpy(normals + 3 * numMeshVertices, key + 3, 3 * sizeof(GLfloat));
+        memcpy(texCoords + 2 * numMeshVertices, key + 6, 2 * sizeof(GLfloat));
+        memcpy(tangents + 4 * numMeshVertices, key + 8, 4 * sizeof(GLfloat));
+        ++numMeshVertices;
+    }
+
+    geometry->squeeze(numMeshVertices, numCorners);
+    range.numVertices = numMeshVertices;
+
+    qDebug() << "Mesh" << _meshIndex << ":" << numCorners / 3 <<
+             "triangles," << numCorners << "corners welded into" << numMeshVertices <<
+             "vertices";
+
+    return geometry;
+}
+
+//------------------------------------------------------------------------------------------
+// each block goes to its place in the planar layout of the shared buffer
+//------------------------------------------------------------------------------------------
+void MeshPool::uploadMesh(int _meshIndex)
+{
+    MeshRange& range = meshRanges[_meshIndex];
+    const GeometryBuffer* geometry = meshGeometries[_meshIndex];
+
+    allocateMesh(_meshIndex);
+    range.resident = true;
+
+    // not through the element array binding, which belongs to the bound vertex array
+    const int blockOffsets[NUM_GEOMETRY_ATTRIBUTES] =
+    {
+        0, getNormalOffset(), getTexCoordOffset(), getTangentOffset()
+    };
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, vertexBuffer.bufferId());
+
+    for(int i = 0; i < NUM_GEOMETRY_ATTRIBUTES; ++i)
+    {
+        GeometryAttribute attribute = (GeometryAttribute) i;
+        int numComponents = GeometryBuffer::getNumComponents(attribute);
+        glBufferSubData(GL_COPY_WRITE_BUFFER,
+                        blockOffsets[i] +
+                        (GLintptr) range.baseVertex * numComponents * sizeof(GLfloat),
+                        geometry->getAttributeSize(attribute), geometry->getAttribute(attribute));
+    }
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, indexBuffer.bufferId());
+    glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr) range.firstIndex * sizeof(GLuint),
+                    (GLsizeiptr) range.indexCount * sizeof(GLuint), geometry->getIndices());
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    stats.bytesInUse += getMeshSize(range);
+    ++stats.numResidentMeshes;
+}
+
+//------------------------------------------------------------------------------------------
+// the buffers stay within the budget: when no free range is large enough, the live ranges
+// are compacted if the free space is only fragmented, the buffers grow if the budget
+// allows it, otherwise the least recently used meshes are evicted until one of both
+// works. Only a mesh that alone exceeds the budget grows the buffers past it.
+//------------------------------------------------------------------------------------------
+void MeshPool::allocateMesh(int _meshIndex)
+{
+    MeshRange& range = meshRanges[_meshIndex];
+
+    // a budget lowered since the buffers were allocated
+    if(stats.capacityBytes > budget)
+    {
+        int numVertices = range.numVertices;
+        int numIndices = range.indexCount;
+        addResidentSizes(numVertices, numIndices);
+        resizeBuffers(numVertices, numIndices);
+    }
+
+    while(true)
+    {
+        int baseVertex = allocateRange(freeVertexRanges, range.numVertices);
+        int firstIndex = allocateRange(freeIndexRanges, range.indexCount);
+
+        if(baseVertex >= 0 && firstIndex >= 0)
+        {
+            range.baseVertex = baseVertex;
+            range.firstIndex = firstIndex;
+            return;
+        }
+
+        if(baseVertex >= 0)
+        {
+            freeRange(freeVertexRanges, baseVertex, range.numVertices);
+        }
+
+        if(firstIndex >= 0)
+        {
+            freeRange(freeIndexRanges, firstIndex, range.indexCount);
+        }
+
+        int numVertices = range.numVertices;
+        int numIndices = range.indexCount;
+        addResidentSizes(numVertices, numIndices);
+
+        // once compacted, the free space is one range at the end of each buffer
+        if(numVertices <= vertexCapacity && numIndices <= indexCapacity)
+        {
+            reallocateBuffers(vertexCapacity, indexCapacity);
+            continue;
+        }
+
+        int leastRecentlyUsed = findLeastRecentlyUsed(_meshIndex);
+
+        if(getCapacitySize(numVertices, numIndices) <= budget || leastRecentlyUsed < 0)
+        {
+            resizeBuffers(numVertices, numIndices);
+            continue;
+        }
+
+        evictMesh(leastRecentlyUsed);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+void MeshPool::evictMesh(int _meshIndex)
+{
+    MeshRange& range = meshRanges[_meshIndex];
+
+    freeRange(freeVertexRanges, range.baseVertex, range.numVertices);
+    freeRange(freeIndexRanges, range.firstIndex, range.indexCount);
+    range.resident = false;
+
+    stats.bytesInUse -= getMeshSize(range);
+    --stats.numResidentMeshes;
+    ++stats.numEvictions;
+
+    qDebug() << "Mesh cache eviction:" << assetPaths[_meshIndex];
+}
+
+//------------------------------------------------------------------------------------------
+int MeshPool::findLeastRecentlyUsed(int _exceptMesh)
+{
+    int leastRecentlyUsed = -1;
+
+    for(int i = 0; i < meshRanges.size(); ++i)
+    {
+        if(i == _exceptMesh || !meshRanges[i].resident)
+        {
+            continue;
+        }
+
+        if(leastRecentlyUsed < 0 || lastUses[i] < lastUses[leastRecentlyUsed])
+        {
+            leastRecentlyUsed = i;
+        }
+    }
+
+    return leastRecentlyUsed;
+}
+
+//------------------------------------------------------------------------------------------
+void MeshPool::addResidentSizes(int& _numVertices, int& _numIndices)
+{
+    for(int i = 0; i < meshRanges.size(); ++i)
+    {
+        if(meshRanges[i].resident)
+        {
+            _numVertices += meshRanges[i].numVertices;
+            _numIndices += meshRanges[i].indexCount;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// the capacities double while the budget allows it, otherwise the budget is split in
+// proportion of the required capacities, which are never cut
+//------------------------------------------------------------------------------------------
+void MeshPool::resizeBuffers(int _minVertexCapacity, int _minIndexCapacity)
+{
+    int newVertexCapacity = qMax(qMax(2 * vertexCapacity, MESH_POOL_INITIAL_VERTICES),
+                                 _minVertexCapacity);
+    int newIndexCapacity = qMax(qMax(2 * indexCapacity, MESH_POOL_INITIAL_INDICES),
+                                _minIndexCapacity);
+    qint64 minSize = getCapacitySize(_minVertexCapacity, _minIndexCapacity);
+
+    if(getCapacitySize(newVertexCapacity, newIndexCapacity) > budget)
+    {
+        double scale = (minSize > 0) ? qMax(1.0, (double) budget / minSize) : 1.0;
+        newVertexCapacity = (int) qMin((double) newVertexCapacity, _minVertexCapacity * scale);
+        newIndexCapacity = (int) qMin((double) newIndexCapacity, _minIndexCapacity * scale);
+        newVertexCapacity = qMax(newVertexCapacity, _minVertexCapacity);
+        newIndexCapacity = qMax(newIndexCapacity, _minIndexCapacity);
+    }
+
+    if(minSize > budget)
+    {
+        qDebug() << "Mesh buffers exceed the budget of" << budget / 1048576 << "MB:" <<
+                 minSize / 1048576 << "MB";
+    }
+
+    reallocateBuffers(newVertexCapacity, newIndexCapacity);
+}
+
+//------------------------------------------------------------------------------------------
+// the resident meshes are copied on the GPU to the start of the new buffers, one after the
+// other, block by block since the planar offsets depend on the vertex capacity; this also
+// compacts the live ranges when the capacities are unchanged
+//------------------------------------------------------------------------------------------
+void MeshPool::reallocateBuffers(int _vertexCapacity, int _indexCapacity)
+{
+    TRACE_SCOPE("reallocateMeshBuffers");
+
+    QOpenGLBuffer newVertexBuffer(QOpenGLBuffer::VertexBuffer);
+    QOpenGLBuffer newIndexBuffer(QOpenGLBuffer::IndexBuffer);
+    newVertexBuffer.create();
+    newIndexBuffer.create();
+    int numVertices = 0;
+    int numIndices = 0;
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, newVertexBuffer.bufferId());
+    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr) _vertexCapacity * MESH_POOL_VERTEX_SIZE,
+                 NULL, GL_STATIC_DRAW);
+
+    if(vertexBuffer.isCreated())
+    {
+        glBindBuffer(GL_COPY_READ_BUFFER, vertexBuffer.bufferId());
+
+        for(int i = 0; i < meshRanges.size(); ++i)
+        {
+            MeshRange& range = meshRanges[i];
+
+            if(!range.resident)
+            {
+                continue;
+            }
+
+            GLintptr offset = 0;
+            GLintptr newOffset = 0;
+
+            for(int j = 0; j < NUM_GEOMETRY_ATTRIBUTES; ++j)
+            {
+                int componentSize = GeometryBuffer::getNumComponents((GeometryAttribute) j) *
+                                    sizeof(GLfloat);
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                    offset + (GLintptr) range.baseVertex * componentSize,
+                                    newOffset + (GLintptr) numVertices * componentSize,
+                                    (GLsizeiptr) range.numVertices * componentSize);
+                offset += (GLintptr) vertexCapacity * componentSize;
+                newOffset += (GLintptr) _vertexCapacity * componentSize;
+            }
+
+            range.baseVertex = numVertices;
+            numVertices += range.numVertices;
+        }
+    }
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, newIndexBuffer.bufferId());
+    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr) _indexCapacity * sizeof(GLuint), NULL,
+                 GL_STATIC_DRAW);
+
+    if(indexBuffer.isCreated())
+    {
+        glBindBuffer(GL_COPY_READ_BUFFER, indexBuffer.bufferId());
+
+        // the indices are relative to the base vertex, they move unchanged
+        for(int i = 0; i < meshRanges.size(); ++i)
+        {
+            MeshRange& range = meshRanges[i];
+
+            if(!range.resident)
+            {
+                continue;
+            }
+
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                (GLintptr) range.firstIndex * sizeof(GLuint),
+                                (GLintptr) numIndices * sizeof(GLuint),
+                                (GLsizeiptr) range.indexCount * sizeof(GLuint));
+            range.firstIndex = numIndices;
+            numIndices += range.indexCount;
+        }
+    }
+
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    if(vertexBuffer.isCreated())
+    {
+        vertexBuffer.destroy();
+        indexBuffer.destroy();
+    }
+
+    vertexBuffer = newVertexBuffer;
+    indexBuffer = newIndexBuffer;
+
+    Q_ASSERT(numVertices <= _vertexCapacity && numIndices <= _indexCapacity);
+    freeVertexRanges.clear();
+    freeIndexRanges.clear();
+    freeRange(freeVertexRanges, numVertices, _vertexCapacity - numVertices);
+    freeRange(freeIndexRanges, numIndices, _indexCapacity - numIndices);
+    vertexCapacity = _vertexCapacity;
+    indexCapacity = _indexCapacity;
+    ++bufferGeneration;
+
+    stats.capacityBytes = getCapacitySize(vertexCapacity, indexCapacity);
+}
+
+//------------------------------------------------------------------------------------------
+qint64 MeshPool::getCapacitySize(int _vertexCapacity, int _indexCapacity)
+{
+    return (qint64) _vertexCapacity * MESH_POOL_VERTEX_SIZE +
+           (qint64) _indexCapacity * sizeof(GLuint);
+}
+
+//------------------------------------------------------------------------------------------
+qint64 MeshPool::getMeshSize(const MeshRange& _range)
+{
+    return (qint64) _range.numVertices * MESH_POOL_VERTEX_SIZE +
+           (qint64) _range.indexCount * sizeof(GLuint);
+}
+
+//------------------------------------------------------------------------------------------
+// first fit, return -1 if no free range is large enough
+//------------------------------------------------------------------------------------------
+int MeshPool::allocateRange(QMap<int, int>& _freeRanges, int _size)
+{
+    for(QMap<int, int>::iterator it = _freeRanges.begin(); it != _freeRanges.end(); ++it)
+    {
+        if(it.value() < _size)
+        {
+            continue;
+        }
+
+        int start = it.key();
+        int remaining = it.value() - _size;
+        _freeRanges.erase(it);
+
+        if(remaining > 0)
+        {
+            _freeRanges.insert(start + _size, remaining);
+        }
+
+        return start;
+    }
+
+    return -1;
+}
+
+//------------------------------------------------------------------------------------------
+// merged with the adjacent free ranges
+//------------------------------------------------------------------------------------------
+void MeshPool::freeRange(QMap<int, int>& _freeRanges, int _start, int _size)
+{
+    if(_size <= 0)
+    {
+        return;
+    }
+
+    QMap<int, int>::iterator next = _freeRanges.lowerBound(_start);
+
+    if(next != _freeRanges.end() && next.key() == _start + _size)
+    {
+        _size += next.value();
+        next = _freeRanges.erase(next);
+    }
+
+    if(next != _freeRanges.begin())
+    {
+        QMap<int, int>::iterator previous = next - 1;
+
+        if(previous.key() + previous.value() == _start)
+        {
+            previous.value() += _size;
+            return;
+        }
+    }
+
+    _freeRanges.insert(_start, _size);
+}
+
+//------------------------------------------------------------------------------------------
+int MeshPool::getNumMeshes()
+{
+    return meshRanges.size();
+}
+
+//------------------------------------------------------------------------------------------
+const MeshRange& MeshPool::getMeshRange(int _meshIndex)
+{
+    return meshRanges[_meshIndex];
+}
+
+//------------------------------------------------------------------------------------------
+QOpenGLBuffer& MeshPool::getVertexBuffer()
+{
+    return vertexBuffer;
+}
+
+//------------------------------------------------------------------------------------------
+QOpenGLBuffer& MeshPool::getIndexBuffer()
+{
+    return indexBuffer;
+}
+
+//------------------------------------------------------------------------------------------
+int MeshPool::getNormalOffset()
+{
+    return vertexCapacity * 3 * sizeof(GLfloat);
+}
+
+//------------------------------------------------------------------------------------------
+int MeshPool::getTexCoordOffset()
+{
+    return getNormalOffset() + vertexCapacity * 3 * sizeof(GLfloat);
+}
+
+//------------------------------------------------------------------------------------------
+int MeshPool::getTangentOffset()
+{
+    return getTexCoordOffset() + vertexCapacity * 2 * sizeof(GLfloat);
+}
+
+//------------------------------------------------------------------------------------------
+bool MeshPool::hasGeometry(int _meshIndex)
+{
+    return meshGeometries[_meshIndex] != NULL;
+}
+
+//------------------------------------------------------------------------------------------
+const GeometryBuffer& MeshPool::getGeometry(int _meshIndex)
+{
+    return *meshGeometries[_meshIndex];
+}
+
+//------------------------------------------------------------------------------------------
+void MeshPool::releaseGeometry()
+{
+    for(int i = 0; i < meshGeometries.size(); ++i)
+    {
+        delete meshGeometries[i];
+        meshGeometries[i] = NULL;
+    }
+}
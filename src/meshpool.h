@@ -0,0 +1,147 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#ifndef MESHPOOL_H
+#define MESHPOOL_H
+
+#include <QtGui>
+#include <QOpenGLBuffer>
+#include <QOpenGLFunctions_4_0_Core>
+
+#include "objloader.h"
+#include "frustum.h"
+
+#define MESH_POOL_DEFAULT_BUDGET (256LL << 20) // bytes of vertex and index data
+#define MESH_POOL_INITIAL_VERTICES (1 << 16)
+#define MESH_POOL_INITIAL_INDICES (1 << 18)
+#define MESH_POOL_VERTEX_SIZE (12 * sizeof(GLfloat)) // position, normal, tex coord, tangent
+#define STRESS_MESH_ASSET_PREFIX "stress:"
+
+//------------------------------------------------------------------------------------------
+// the range of one mesh in the shared buffers, and the data to place it in the scene; the
+// bounds and scaling stay valid once the mesh has been loaded, the offsets only while it
+// is resident
+struct MeshRange
+{
+    GLuint firstIndex;
+    GLuint indexCount;
+    GLint baseVertex;
+    GLuint numVertices;
+    bool loaded;
+    bool resident;
+
+    AABB bounds;
+    float scalingFactor;
+    float lowestYCoordinate;
+};
+
+//------------------------------------------------------------------------------------------
+struct MeshPoolStats
+{
+    int numHits;
+    int numMisses;
+    int numEvictions;
+    int numResidentMeshes;
+    qint64 bytesInUse;
+    qint64 capacityBytes; // allocated by the buffers
+};
+
+//------------------------------------------------------------------------------------------
+// Packs the meshes into one vertex buffer and one index buffer: the triangle soup of each
+// OBJ file is welded into indexed vertices, the attributes are stored in planar blocks
+// (positions, normals, texture coordinates, tangents) so a single base vertex addresses
+// every block. Any mesh is then drawn from the same vertex array object.
+// The pool is a residency cache of the assets: a mesh is only loaded the first time it
+// is made resident, into a free range of the buffers, and the least recently used meshes
+// are evicted once their total size would exceed the budget. A switch to a resident mesh
+// only changes the drawn range. The budget also caps the allocated buffers: when no free
+// range is large enough, the live ranges are compacted, or the buffers grow up to the
+// budget, or more meshes are evicted. Compacting and resizing recreate the buffers; the
+// vertex array objects must then be rebuilt, see getBufferGeneration().
+// The CPU copy of a newly loaded mesh is kept until releaseGeometry(), the GPU has the
+// only copy afterwards.
+//------------------------------------------------------------------------------------------
+class MeshPool : protected QOpenGLFunctions_4_0_Core
+{
+public:
+    MeshPool();
+    ~MeshPool();
+
+    // with a current OpenGL context
+    void initialize();
+    void clear();
+
+    // an OBJ file path or a procedural mesh path, the mesh is not loaded yet;
+    // return the mesh index
+    int addMesh(const QString& _assetPath);
+    static QString getStressMeshAssetPath(StressMeshType _type, int _level);
+
+    // return false if the mesh could not be loaded
+    bool makeResident(int _meshIndex, OBJLoader* _objLoader);
+    bool isResident(int _meshIndex);
+
+    void setBudget(qint64 _bytes);
+    qint64 getBudget();
+    const MeshPoolStats& getStats();
+
+    // increased each time the buffers are recreated, the ranges of the resident meshes
+    // may have moved
+    int getBufferGeneration();
+
+    int getNumMeshes();
+    const MeshRange& getMeshRange(int _meshIndex);
+
+    QOpenGLBuffer& getVertexBuffer();
+    QOpenGLBuffer& getIndexBuffer();
+
+    int getNormalOffset();
+    int getTexCoordOffset();
+    int getTangentOffset();
+
+    // the CPU copy of a newly loaded mesh, 32-bit indices relative to its base vertex
+    bool hasGeometry(int _meshIndex);
+    const GeometryBuffer& getGeometry(int _meshIndex);
+    void releaseGeometry();
+
+private:
+    bool loadAsset(const QString& _assetPath, OBJLoader* _objLoader);
+    GeometryBuffer* weldMesh(int _meshIndex, OBJLoader* _objLoader);
+    void uploadMesh(int _meshIndex);
+    void allocateMesh(int _meshIndex);
+    void evictMesh(int _meshIndex);
+    int findLeastRecentlyUsed(int _exceptMesh);
+    void addResidentSizes(int& _numVertices, int& _numIndices);
+    void resizeBuffers(int _minVertexCapacity, int _minIndexCapacity);
+    void reallocateBuffers(int _vertexCapacity, int _indexCapacity);
+    qint64 getMeshSize(const MeshRange& _range);
+    static qint64 getCapacitySize(int _vertexCapacity, int _indexCapacity);
+
+    // free ranges of the buffers, start -> size, in vertices or indices
+    static int allocateRange(QMap<int, int>& _freeRanges, int _size);
+    static void freeRange(QMap<int, int>& _freeRanges, int _start, int _size);
+
+    QVector<MeshRange> meshRanges;
+    QStringList assetPaths;
+    QVector<quint64> lastUses;
+    QVector<GeometryBuffer*> meshGeometries;
+    quint64 useCounter;
+
+    qint64 budget;
+    MeshPoolStats stats;
+
+    int vertexCapacity;
+    int indexCapacity;
+    QMap<int, int> freeVertexRanges;
+    QMap<int, int> freeIndexRanges;
+    int bufferGeneration;
+
+    QOpenGLBuffer vertexBuffer;
+    QOpenGLBuffer indexBuffer;
+};
+
+#endif // MESHPOOL_H
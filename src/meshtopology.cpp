@@ -0,0 +1,442 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#include <algorithm>
+
+#include "meshtopology.h"
+#include "tracer.h"
+
+//------------------------------------------------------------------------------------------
+MeshTopology::MeshTopology()
+{
+    clear();
+}
+
+//------------------------------------------------------------------------------------------
+void MeshTopology::clear()
+{
+    numFaces = 0;
+    numVertices = 0;
+    numBoundaryEdges = 0;
+    numNonManifoldEdges = 0;
+    numDegeneratedFaces = 0;
+
+    weldedVertices.clear();
+    representativeVertices.clear();
+    vertexHalfEdges.clear();
+    halfEdgeOrigins.clear();
+    halfEdgeTwins.clear();
+    halfEdgeEdges.clear();
+    edgeOffsets.clear();
+    edgeHalfEdges.clear();
+    edgeFlags.clear();
+}
+
+//------------------------------------------------------------------------------------------
+void MeshTopology::build(const cyTriMesh& _mesh, float _weldTolerance)
+{
+    TRACE_SCOPE("buildMeshTopology");
+
+    clear();
+    numFaces = _mesh.NF();
+
+    weldVertices(_mesh, _weldTolerance);
+    buildEdges(_mesh);
+}
+
+//------------------------------------------------------------------------------------------
+// the positions are snapped to the nearest grid point, two vertices closer than the
+// tolerance may still land on neighboring grid points if they straddle a cell boundary
+//------------------------------------------------------------------------------------------
+void MeshTopology::weldVertices(const cyTriMesh& _mesh, float _weldTolerance)
+{
+    TRACE_SCOPE("weldVertices");
+
+    int numMeshVertices = _mesh.NV();
+    weldedVertices.resize(numMeshVertices);
+
+    if(numMeshVertices == 0)
+    {
+        return;
+    }
+
+    cyPoint3f boxMin = _mesh.V(0);
+    cyPoint3f boxMax = _mesh.V(0);
+
+    for(int i = 1; i < numMeshVertices; ++i)
+    {
+        const cyPoint3f& vertex = _mesh.V(i);
+        boxMin.x = qMin(boxMin.x, vertex.x);
+        boxMin.y = qMin(boxMin.y, vertex.y);
+        boxMin.z = qMin(boxMin.z, vertex.z);
+        boxMax.x = qMax(boxMax.x, vertex.x);
+        boxMax.y = qMax(boxMax.y, vertex.y);
+        boxMax.z = qMax(boxMax.z, vertex.z);
+    }
+
+    cyPoint3f extent = boxMax - boxMin;
+    float maxExtent = qMax(extent.x, qMax(extent.y, extent.z));
+    const quint64 maxCell = (1ULL << TOPOLOGY_QUANTIZATION_BITS) - 1;
+
+    float tolerance = (_weldTolerance > 0.0f) ? _weldTolerance :
+                      TOPOLOGY_DEFAULT_WELD_EPSILON * extent.Length();
+    tolerance = qMax(tolerance, maxExtent / (float)(maxCell - 1));
+
+    if(tolerance <= 0.0f)
+    {
+        // all vertices at the same position
+        tolerance = 1.0f;
+    }
+
+    QVector<SortEntry> entries(numMeshVertices);
+
+    for(int i = 0; i < numMeshVertices; ++i)
+    {
+        cyPoint3f cell = (_mesh.V(i) - boxMin) / tolerance;
+        quint64 x = qMin((quint64)(cell.x + 0.5f), maxCell);
+        quint64 y = qMin((quint64)(cell.y + 0.5f), maxCell);
+        quint64 z = qMin((quint64)(cell.z + 0.5f), maxCell);
+
+        entries[i].key = (x << (2 * TOPOLOGY_QUANTIZATION_BITS)) |
+                         (y << TOPOLOGY_QUANTIZATION_BITS) | z;
+        entries[i].index = i;
+    }
+
+    sortEntries(entries);
+
+    /////////////////////////////////////////////////////////////////
+    // each run of equal keys is one welded vertex, the entries are ordered by index
+    // inside a run so its first one is the representative
+    for(int i = 0; i < numMeshVertices; ++i)
+    {
+        if(i == 0 || entries[i].key != entries[i - 1].key)
+        {
+            representativeVertices.append(entries[i].index);
+        }
+
+        weldedVertices[entries[i].index] = representativeVertices.size() - 1;
+    }
+
+    numVertices = representativeVertices.size();
+}
+
+//------------------------------------------------------------------------------------------
+void MeshTopology::buildEdges(const cyTriMesh& _mesh)
+{
+    TRACE_SCOPE("buildEdges");
+
+    int numHalfEdges = 3 * numFaces;
+    halfEdgeOrigins.resize(numHalfEdges);
+    halfEdgeTwins.fill(-1, numHalfEdges);
+    halfEdgeEdges.fill(-1, numHalfEdges);
+    vertexHalfEdges.fill(-1, numVertices);
+
+    QVector<SortEntry> entries;
+    entries.reserve(numHalfEdges);
+    edgeOffsets.reserve(numHalfEdges / 2 + 1);
+    edgeFlags.reserve(numHalfEdges / 2);
+
+    for(int face = 0; face < numFaces; ++face)
+    {
+        const cyTriMesh::cyTriFace& meshFace = _mesh.F(face);
+        int v[3];
+
+        for(int corner = 0; corner < 3; ++corner)
+        {
+            v[corner] = weldedVertices[meshFace.v[corner]];
+            halfEdgeOrigins[3 * face + corner] = v[corner];
+        }
+
+        if(v[0] == v[1] || v[1] == v[2] || v[2] == v[0])
+        {
+            ++numDegeneratedFaces;
+            continue;
+        }
+
+        for(int corner = 0; corner < 3; ++corner)
+        {
+            quint64 v0 = v[corner];
+            quint64 v1 = v[(corner + 1) % 3];
+
+            SortEntry entry;
+            entry.key = (qMin(v0, v1) << 32) | qMax(v0, v1);
+            entry.index = 3 * face + corner;
+            entries.append(entry);
+        }
+    }
+
+    sortEntries(entries);
+
+    /////////////////////////////////////////////////////////////////
+    // each run of equal keys is one edge
+    edgeHalfEdges.resize(entries.size());
+
+    for(int i = 0; i < entries.size(); ++i)
+    {
+        edgeHalfEdges[i] = entries[i].index;
+    }
+
+    for(int first = 0; first < entries.size();)
+    {
+        int last = first + 1;
+
+        while(last < entries.size() && entries[last].key == entries[first].key)
+        {
+            ++last;
+        }
+
+        int edge = edgeOffsets.size();
+        int numEdgeFaces = last - first;
+        quint8 flags = 0;
+
+        edgeOffsets.append(first);
+
+        for(int i = first; i < last; ++i)
+        {
+            halfEdgeEdges[entries[i].index] = edge;
+        }
+
+        if(numEdgeFaces == 1)
+        {
+            flags = EDGE_BOUNDARY;
+            ++numBoundaryEdges;
+        }
+        else if(numEdgeFaces == 2)
+        {
+            int h0 = entries[first].index;
+            int h1 = entries[first + 1].index;
+            halfEdgeTwins[h0] = h1;
+            halfEdgeTwins[h1] = h0;
+
+            if(halfEdgeOrigins[h0] == halfEdgeOrigins[h1])
+            {
+                flags = EDGE_INCONSISTENT_ORIENTATION;
+            }
+        }
+        else
+        {
+            flags = EDGE_NON_MANIFOLD;
+            ++numNonManifoldEdges;
+        }
+
+        edgeFlags.append(flags);
+        first = last;
+    }
+
+    edgeOffsets.append(entries.size());
+
+    /////////////////////////////////////////////////////////////////
+    // the boundary half-edges override the others, so the walks around the boundary
+    // vertices start on the boundary
+    for(int halfEdge = 0; halfEdge < numHalfEdges; ++halfEdge)
+    {
+        if(halfEdgeEdges[halfEdge] < 0)
+        {
+            continue;
+        }
+
+        int& vertexHalfEdge = vertexHalfEdges[halfEdgeOrigins[halfEdge]];
+
+        if(vertexHalfEdge < 0 || halfEdgeTwins[halfEdge] < 0)
+        {
+            vertexHalfEdge = halfEdge;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// The chunks are sorted concurrently then merged pairwise, each level of merges running
+// concurrently too. The number of chunks is a power of two.
+//------------------------------------------------------------------------------------------
+void MeshTopology::sortEntries(QVector<SortEntry>& _entries)
+{
+    TRACE_SCOPE("sortEntries");
+
+    int numEntries = _entries.size();
+    SortEntry* data = _entries.data();
+
+    if(numEntries < TOPOLOGY_PARALLEL_THRESHOLD)
+    {
+        std::sort(data, data + numEntries);
+        return;
+    }
+
+    int numChunks = 1;
+
+    while(2 * numChunks <= QThread::idealThreadCount())
+    {
+        numChunks *= 2;
+    }
+
+    QVector<int> bounds(numChunks + 1);
+
+    for(int i = 0; i <= numChunks; ++i)
+    {
+        bounds[i] = (int)((qint64) numEntries * i / numChunks);
+    }
+
+    QVector<QFuture<void> > futures;
+
+    for(int i = 1; i < numChunks; ++i)
+    {
+        futures.append(QtConcurrent::run(&MeshTopology::sortRange, data + bounds[i],
+                                         data + bounds[i + 1]));
+    }
+
+    sortRange(data + bounds[0], data + bounds[1]);
+
+    for(int i = 0; i < futures.size(); ++i)
+    {
+        futures[i].waitForFinished();
+    }
+
+    for(int width = 1; width < numChunks; width *= 2)
+    {
+        futures.clear();
+
+        for(int i = 0; i < numChunks; i += 2 * width)
+        {
+            futures.append(QtConcurrent::run(&MeshTopology::mergeRanges, data + bounds[i],
+                                             data + bounds[i + width],
+                                             data + bounds[i + 2 * width]));
+        }
+
+        for(int i = 0; i < futures.size(); ++i)
+        {
+            futures[i].waitForFinished();
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+void MeshTopology::sortRange(SortEntry* _begin, SortEntry* _end)
+{
+    std::sort(_begin, _end);
+}
+
+//------------------------------------------------------------------------------------------
+void MeshTopology::mergeRanges(SortEntry* _begin, SortEntry* _middle, SortEntry* _end)
+{
+    std::inplace_merge(_begin, _middle, _end);
+}
+
+//------------------------------------------------------------------------------------------
+int MeshTopology::getNumFaces() const
+{
+    return numFaces;
+}
+
+//------------------------------------------------------------------------------------------
+int MeshTopology::getNumVertices() const
+{
+    return numVertices;
+}
+
+//------------------------------------------------------------------------------------------
+int MeshTopology::getNumEdges() const
+{
+    return edgeFlags.size();
+}
+
+//------------------------------------------------------------------------------------------
+int MeshTopology::getNumBoundaryEdges() const
+{
+    return numBoundaryEdges;
+}
+
+//------------------------------------------------------------------------------------------
+int MeshTopology::getNumNonManifoldEdges() const
+{
+    return numNonManifoldEdges;
+}
+
+//------------------------------------------------------------------------------------------
+int MeshTopology::getNumDegeneratedFaces() const
+{
+    return numDegeneratedFaces;
+}
+
+//------------------------------------------------------------------------------------------
+int MeshTopology::getWeldedVertex(int _meshVertex) const
+{
+    return weldedVertices[_meshVertex];
+}
+
+//------------------------------------------------------------------------------------------
+int MeshTopology::getRepresentativeVertex(int _vertex) const
+{
+    return representativeVertices[_vertex];
+}
+
+//------------------------------------------------------------------------------------------
+int MeshTopology::getVertexHalfEdge(int _vertex) const
+{
+    return vertexHalfEdges[_vertex];
+}
+
+//------------------------------------------------------------------------------------------
+int MeshTopology::getOrigin(int _halfEdge) const
+{
+    return halfEdgeOrigins[_halfEdge];
+}
+
+//------------------------------------------------------------------------------------------
+int MeshTopology::getDestination(int _halfEdge) const
+{
+    return halfEdgeOrigins[getNext(_halfEdge)];
+}
+
+//------------------------------------------------------------------------------------------
+int MeshTopology::getTwin(int _halfEdge) const
+{
+    return halfEdgeTwins[_halfEdge];
+}
+
+//------------------------------------------------------------------------------------------
+int MeshTopology::getEdge(int _halfEdge) const
+{
+    return halfEdgeEdges[_halfEdge];
+}
+
+//------------------------------------------------------------------------------------------
+int MeshTopology::getAdjacentFace(int _face, int _corner) const
+{
+    int twin = halfEdgeTwins[3 * _face + _corner];
+
+    return (twin < 0) ? -1 : getFace(twin);
+}
+
+//------------------------------------------------------------------------------------------
+int MeshTopology::getEdgeFlags(int _edge) const
+{
+    return edgeFlags[_edge];
+}
+
+//------------------------------------------------------------------------------------------
+bool MeshTopology::isBoundaryEdge(int _edge) const
+{
+    return (edgeFlags[_edge] & EDGE_BOUNDARY) != 0;
+}
+
+//------------------------------------------------------------------------------------------
+bool MeshTopology::isNonManifoldEdge(int _edge) const
+{
+    return (edgeFlags[_edge] & EDGE_NON_MANIFOLD) != 0;
+}
+
+//------------------------------------------------------------------------------------------
+int MeshTopology::getNumEdgeHalfEdges(int _edge) const
+{
+    return edgeOffsets[_edge + 1] - edgeOffsets[_edge];
+}
+
+//------------------------------------------------------------------------------------------
+int MeshTopology::getEdgeHalfEdge(int _edge, int _i) const
+{
+    return edgeHalfEdges[edgeOffsets[_edge] + _i];
+}
@@ -0,0 +1,137 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#ifndef MESHTOPOLOGY_H
+#define MESHTOPOLOGY_H
+
+#include <QtCore>
+#include <QtConcurrent>
+
+#include "cyTriMesh.h"
+
+#define TOPOLOGY_PARALLEL_THRESHOLD 65536 // sorted elements, sorted by one thread below
+#define TOPOLOGY_DEFAULT_WELD_EPSILON 1e-6f // relative to the bounding box diagonal
+#define TOPOLOGY_QUANTIZATION_BITS 21 // per axis, the three fit in a 64-bit key
+
+enum EdgeFlag
+{
+    EDGE_BOUNDARY = 1,                  // one face
+    EDGE_NON_MANIFOLD = 2,              // more than two faces
+    EDGE_INCONSISTENT_ORIENTATION = 4   // two faces traversing it in the same direction
+};
+
+//------------------------------------------------------------------------------------------
+// Half-edge and edge-to-face topology of a cyTriMesh, for silhouette extraction, adjacency
+// buffers and simplification.
+// The vertices closer than the weld tolerance are merged first: their positions are
+// quantized on a grid and the 64-bit cell keys are sorted, so the split normals and texture
+// seams of OBJ files do not break the connectivity. The half-edges are then sorted by
+// their undirected welded edge, the runs of equal keys become the edges. Both sorts are
+// parallel, the rest is linear: the build is O(n log n) with a small constant, a few
+// seconds for 10M faces.
+// Half-edge h = 3 * face + corner goes from the corner to the next one of the face.
+// Degenerated faces, with two corners welded together, have no edges.
+//------------------------------------------------------------------------------------------
+class MeshTopology
+{
+public:
+    MeshTopology();
+
+    // a non-positive tolerance is TOPOLOGY_DEFAULT_WELD_EPSILON times the bounding box
+    // diagonal, the tolerance is clamped to the resolution of the quantization grid
+    void build(const cyTriMesh& _mesh, float _weldTolerance = 0.0f);
+    void clear();
+
+    int getNumFaces() const;
+    int getNumVertices() const; // welded
+    int getNumEdges() const;
+    int getNumBoundaryEdges() const;
+    int getNumNonManifoldEdges() const;
+    int getNumDegeneratedFaces() const;
+
+    /////////////////////////////////////////////////////////////////
+    // vertices
+    int getWeldedVertex(int _meshVertex) const;
+    // the smallest mesh vertex welded into it
+    int getRepresentativeVertex(int _vertex) const;
+    // an outgoing half-edge, a boundary one if there is any, -1 if isolated
+    int getVertexHalfEdge(int _vertex) const;
+
+    /////////////////////////////////////////////////////////////////
+    // half-edges
+    static int getFace(int _halfEdge)
+    {
+        return _halfEdge / 3;
+    }
+    static int getNext(int _halfEdge)
+    {
+        return (_halfEdge % 3 == 2) ? _halfEdge - 2 : _halfEdge + 1;
+    }
+    static int getPrevious(int _halfEdge)
+    {
+        return (_halfEdge % 3 == 0) ? _halfEdge + 2 : _halfEdge - 1;
+    }
+
+    int getOrigin(int _halfEdge) const;
+    int getDestination(int _halfEdge) const;
+    // -1 on boundary, non-manifold and degenerated edges, in the same direction as the
+    // half-edge on the EDGE_INCONSISTENT_ORIENTATION ones
+    int getTwin(int _halfEdge) const;
+    // -1 on degenerated faces
+    int getEdge(int _halfEdge) const;
+    // the face across the edge at the given corner, -1 if none
+    int getAdjacentFace(int _face, int _corner) const;
+
+    /////////////////////////////////////////////////////////////////
+    // edges
+    int getEdgeFlags(int _edge) const;
+    bool isBoundaryEdge(int _edge) const;
+    bool isNonManifoldEdge(int _edge) const;
+    // one half-edge per face incident to the edge
+    int getNumEdgeHalfEdges(int _edge) const;
+    int getEdgeHalfEdge(int _edge, int _i = 0) const;
+
+private:
+    struct SortEntry
+    {
+        quint64 key;
+        quint32 index;
+
+        bool operator <(const SortEntry& _other) const
+        {
+            return (key < _other.key) || (key == _other.key && index < _other.index);
+        }
+    };
+
+    void weldVertices(const cyTriMesh& _mesh, float _weldTolerance);
+    void buildEdges(const cyTriMesh& _mesh);
+    static void sortEntries(QVector<SortEntry>& _entries);
+    static void sortRange(SortEntry* _begin, SortEntry* _end);
+    static void mergeRanges(SortEntry* _begin, SortEntry* _middle, SortEntry* _end);
+
+    int numFaces;
+    int numVertices;
+    int numBoundaryEdges;
+    int numNonManifoldEdges;
+    int numDegeneratedFaces;
+
+    QVector<int> weldedVertices;
+    QVector<int> representativeVertices;
+    QVector<int> vertexHalfEdges;
+
+    QVector<int> halfEdgeOrigins;
+    QVector<int> halfEdgeTwins;
+    QVector<int> halfEdgeEdges;
+
+    // the half-edges of edge e are edgeHalfEdges[edgeOffsets[e] .. edgeOffsets[e + 1] - 1]
+    QVector<int> edgeOffsets;
+    QVector<int> edgeHalfEdges;
+    QVector<quint8> edgeFlags;
+};
+
+#endif // MESHTOPOLOGY_H
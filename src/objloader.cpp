@@ -8,6 +8,7 @@
 #include <QtWidgets>
 #include "objloader.h"
 #include "cyPoint.h"
+#include "tracer.h"
 
 OBJLoader::OBJLoader():
     objObject(NULL)
@@ -17,6 +18,8 @@ OBJLoader::OBJLoader():
 //------------------------------------------------------------------------------------------
 bool OBJLoader::loadObjFile(const char* _fileName)
 {
+    TRACE_SCOPE("loadObjFile");
+
     if(!objObject)
     {
         objObject = new cyTriMesh;
@@ -26,63 +29,220 @@ bool OBJLoader::loadObjFile(const char* _fileName)
         objObject->Clear();
     }
 
-    if(!objObject->LoadFromFileObj(_fileName, false))
+    // cyTriMesh is kept as is, its functions are traced from here
+    bool loaded;
+
+    {
+        TRACE_SCOPE("LoadFromFileObj");
+        loaded = objObject->LoadFromFileObj(_fileName, false);
+    }
+
+    if(!loaded)
+    {
+        return false;
+    }
+
+    buildVertexData();
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+bool OBJLoader::loadStressMesh(StressMeshType _type, int _level)
+{
+    if(!objObject)
+    {
+        objObject = new cyTriMesh;
+    }
+
+    StressMesh::generate(_type, _level, objObject);
+
+    if(objObject->NF() == 0)
     {
         return false;
     }
 
+    buildVertexData();
+
+    return true;
+}
 
+//------------------------------------------------------------------------------------------
+// normals, bounding box, then the per-corner attributes of the loaded mesh, written once
+// into the geometry buffer; the cyTriMesh is not needed anymore and is freed
+//------------------------------------------------------------------------------------------
+void OBJLoader::buildVertexData()
+{
     clearData();
-    objObject->ComputeNormals();
+
+    {
+        TRACE_SCOPE("ComputeNormals");
+        objObject->ComputeNormals();
+    }
+
     objObject->ComputeBoundingBox();
     boxMin = objObject->GetBoundMin();
     boxMax = objObject->GetBoundMax();
 
 
+    int numCorners = objObject->NF() * 3;
+    geometry.allocate(numCorners, 0, GEOMETRY_POSITIONS | GEOMETRY_NORMALS |
+                      GEOMETRY_TEXCOORDS | GEOMETRY_TANGENTS, GL_UNSIGNED_INT);
+
+    GLfloat* vertices = geometry.getAttribute(POSITION_ATTRIBUTE);
+    GLfloat* normals = geometry.getAttribute(NORMAL_ATTRIBUTE);
+    GLfloat* texCoords = geometry.getAttribute(TEXCOORD_ATTRIBUTE);
+
     for(int i = 0; i < objObject->NF(); ++i)
     {
-        cyTriMesh::cyTriFace face = objObject->F(i);
+        const cyTriMesh::cyTriFace& face = objObject->F(i);
+        const cyTriMesh::cyTriFace& faceNormal = objObject->FN(i);
+        const cyTriMesh::cyTriFace& faceTex = objObject->FT(i);
 
-        for(int i = 0; i < 3; ++i)
+        for(int j = 0; j < 3; ++j)
         {
-            cyPoint3f vertex = objObject->V(face.v[i]);
-            verticesList.append(QVector3D(vertex.x, vertex.y, vertex.z));
+            const cyPoint3f& vertex = objObject->V(face.v[j]);
+            const cyPoint3f& normal = objObject->VN(faceNormal.v[j]);
+            const cyPoint3f& tex = objObject->VT(faceTex.v[j]);
+            int corner = 3 * i + j;
+
+            vertices[3 * corner] = vertex.x;
+            vertices[3 * corner + 1] = vertex.y;
+            vertices[3 * corner + 2] = vertex.z;
+
+            normals[3 * corner] = normal.x;
+            normals[3 * corner + 1] = normal.y;
+            normals[3 * corner + 2] = normal.z;
+
+            texCoords[2 * corner] = tex.x;
+            texCoords[2 * corner + 1] = tex.y;
         }
+    }
+
+    computeTangents();
 
-        cyTriMesh::cyTriFace faceNormal = objObject->FN(i);
+    delete objObject;
+    objObject = NULL;
+}
+
+//------------------------------------------------------------------------------------------
+// MikkTSpace-style tangent frames: the per-triangle tangents are weighted by the corner
+// angle and accumulated over the corners sharing the same position and texture
+// coordinate, then orthogonalized against the vertex normal. The w component stores the
+// handedness of the bitangent.
+//------------------------------------------------------------------------------------------
+void OBJLoader::computeTangents()
+{
+    int numFaces = objObject->NF();
+    QHash<quint64, int> cornerMap;
+    QVector<int> cornerIndices(numFaces * 3);
+    QVector<QVector3D> tangents;
+    QVector<QVector3D> btangents;
 
-        for(int i = 0; i < 3; ++i)
+    for(int i = 0; i < numFaces; ++i)
+    {
+        const cyTriMesh::cyTriFace& face = objObject->F(i);
+        const cyTriMesh::cyTriFace& faceTex = objObject->FT(i);
+
+        for(int j = 0; j < 3; ++j)
+        {
+            quint64 key = ((quint64)face.v[j] << 32) | faceTex.v[j];
+            QHash<quint64, int>::const_iterator it = cornerMap.constFind(key);
+
+            if(it == cornerMap.constEnd())
+            {
+                it = cornerMap.insert(key, tangents.size());
+                tangents.append(QVector3D(0, 0, 0));
+                btangents.append(QVector3D(0, 0, 0));
+            }
+
+            cornerIndices[i * 3 + j] = it.value();
+        }
+    }
+
+    const GLfloat* vertices = geometry.getAttribute(POSITION_ATTRIBUTE);
+    const GLfloat* normals = geometry.getAttribute(NORMAL_ATTRIBUTE);
+    const GLfloat* texCoords = geometry.getAttribute(TEXCOORD_ATTRIBUTE);
+    GLfloat* cornerTangents = geometry.getAttribute(TANGENT_ATTRIBUTE);
+
+    for(int i = 0; i < numFaces; ++i)
+    {
+        QVector3D v[3];
+        QVector2D vt[3];
+
+        for(int j = 0; j < 3; ++j)
         {
-            cyPoint3f normal = objObject->VN(faceNormal.v[i]);
-            normalsList.append(QVector3D(normal.x, normal.y, normal.z));
+            const GLfloat* vertex = vertices + 3 * (i * 3 + j);
+            const GLfloat* texCoord = texCoords + 2 * (i * 3 + j);
+            v[j] = QVector3D(vertex[0], vertex[1], vertex[2]);
+            vt[j] = QVector2D(texCoord[0], texCoord[1]);
         }
 
+        QVector3D e1 = v[1] - v[0];
+        QVector3D e2 = v[2] - v[0];
+        float s1 = vt[1].x() - vt[0].x();
+        float s2 = vt[2].x() - vt[0].x();
+        float t1 = vt[1].y() - vt[0].y();
+        float t2 = vt[2].y() - vt[0].y();
 
-        cyTriMesh::cyTriFace faceTex = objObject->FT(i);
+        float det = s1 * t2 - s2 * t1;
 
-        for(int i = 0; i < 3; ++i)
+        if(fabs(det) < 1e-12f)
         {
-            cyPoint3f tex = objObject->VT(faceTex.v[i]);
-            texCoordList.append(QVector2D(tex.x, tex.y));
+            continue;
         }
 
+        float r = 1.0f / det;
+        QVector3D tangent = ((t2 * e1 - t1 * e2) * r).normalized();
+        QVector3D btangent = ((s1 * e2 - s2 * e1) * r).normalized();
 
+        for(int j = 0; j < 3; ++j)
+        {
+            QVector3D edge0 = (v[(j + 1) % 3] - v[j]).normalized();
+            QVector3D edge1 = (v[(j + 2) % 3] - v[j]).normalized();
+            float angle = acos(qBound(-1.0f, QVector3D::dotProduct(edge0, edge1), 1.0f));
+
+            int corner = cornerIndices[i * 3 + j];
+            tangents[corner] += angle * tangent;
+            btangents[corner] += angle * btangent;
+        }
     }
 
-    return true;
+    for(int i = 0; i < numFaces * 3; ++i)
+    {
+        QVector3D normal = QVector3D(normals[3 * i], normals[3 * i + 1],
+                                     normals[3 * i + 2]).normalized();
+        QVector3D tangent = tangents[cornerIndices[i]];
+        tangent = (tangent - normal * QVector3D::dotProduct(normal, tangent));
+
+        if(tangent.lengthSquared() < 1e-12f)
+        {
+            // degenerated texture mapping, pick any direction perpendicular to the normal
+            tangent = QVector3D::crossProduct(normal, fabs(normal.x()) < 0.9f ?
+                                              QVector3D(1, 0, 0) : QVector3D(0, 1, 0));
+        }
+
+        tangent.normalize();
+
+        float handedness = (QVector3D::dotProduct(QVector3D::crossProduct(normal, tangent),
+                                                  btangents[cornerIndices[i]]) < 0.0f) ? -1.0f : 1.0f;
+        cornerTangents[4 * i] = tangent.x();
+        cornerTangents[4 * i + 1] = tangent.y();
+        cornerTangents[4 * i + 2] = tangent.z();
+        cornerTangents[4 * i + 3] = handedness;
+    }
 }
 
 //------------------------------------------------------------------------------------------
 OBJLoader::~OBJLoader()
 {
-    clearData();
     delete objObject;
 }
 
 //------------------------------------------------------------------------------------------
 int OBJLoader::getNumVertices()
 {
-    return verticesList.size();
+    return geometry.getNumVertices();
 }
 
 //------------------------------------------------------------------------------------------
@@ -105,36 +265,64 @@ float OBJLoader::getLowestYCoordinate()
     return (boxMin.y / getScalingFactor());
 }
 
+//------------------------------------------------------------------------------------------
+QVector3D OBJLoader::getBoundingBoxMin()
+{
+    return QVector3D(boxMin.x, boxMin.y, boxMin.z);
+}
+
+//------------------------------------------------------------------------------------------
+QVector3D OBJLoader::getBoundingBoxMax()
+{
+    return QVector3D(boxMax.x, boxMax.y, boxMax.z);
+}
+
 //------------------------------------------------------------------------------------------
 int OBJLoader::getTexCoordOffset()
 {
     return (sizeof(GLfloat) * getNumVertices() * 2);
 }
 
+//------------------------------------------------------------------------------------------
+int OBJLoader::getTangentOffset()
+{
+    return (sizeof(GLfloat) * getNumVertices() * 4);
+}
+
 //------------------------------------------------------------------------------------------
 GLfloat* OBJLoader::getVertices()
 {
-    return (GLfloat*)verticesList.data();
+    return geometry.getAttribute(POSITION_ATTRIBUTE);
 }
 
 //------------------------------------------------------------------------------------------
 GLfloat* OBJLoader::getNormals()
 {
-    return (GLfloat*)normalsList.data();
+    return geometry.getAttribute(NORMAL_ATTRIBUTE);
 }
 
 //------------------------------------------------------------------------------------------
 GLfloat* OBJLoader::getTexureCoordinates()
 {
-    return (GLfloat*)texCoordList.data();
+    return geometry.getAttribute(TEXCOORD_ATTRIBUTE);
+}
+
+
+//------------------------------------------------------------------------------------------
+GLfloat* OBJLoader::getTangents()
+{
+    return geometry.getAttribute(TANGENT_ATTRIBUTE);
 }
 
+//------------------------------------------------------------------------------------------
+GeometryBuffer& OBJLoader::getGeometry()
+{
+    return geometry;
+}
 
 //------------------------------------------------------------------------------------------
 void OBJLoader::clearData()
 {
-    verticesList.clear();
-    normalsList.clear();
-    texCoordList.clear();
+    geometry.release();
 }
 
@@ -12,9 +12,12 @@
 #include <QList>
 #include <QVector3D>
 #include <QVector2D>
+#include <QVector4D>
 #include <math.h>
 
 #include "cyTriMesh.h"
+#include "stressmesh.h"
+#include "geometrybuffer.h"
 
 class OBJLoader
 {
@@ -23,27 +26,35 @@ public:
     ~OBJLoader();
 
     bool loadObjFile(const char *_fileName);
+    bool loadStressMesh(StressMeshType _type, int _level);
 
     int getNumVertices();
     int getVertexOffset();
     int getTexCoordOffset();
+    int getTangentOffset();
     float getScalingFactor();
     float getLowestYCoordinate();
+    QVector3D getBoundingBoxMin();
+    QVector3D getBoundingBoxMax();
 
     GLfloat* getVertices();
     GLfloat* getNormals();
     GLfloat* getTexureCoordinates();
+    GLfloat* getTangents();
+
+    // the per-corner attributes, to be moved out or released after use
+    GeometryBuffer& getGeometry();
+    void clearData();
 
 private:
     cyTriMesh* objObject;
     cyPoint3f boxMin;
     cyPoint3f boxMax;
 
-    void clearData();
+    void buildVertexData();
+    void computeTangents();
 
-    QVector<QVector3D> verticesList;
-    QVector<QVector3D> normalsList;
-    QVector<QVector2D> texCoordList;
+    GeometryBuffer geometry;
 };
 
 #endif // OBJLOADER_H
@@ -0,0 +1,697 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+#include <algorithm>
+#include <math.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "occlusionculler.h"
+
+//------------------------------------------------------------------------------------------
+OcclusionCuller::OcclusionCuller():
+    depthBuffer(NULL)
+{
+    QSize size(HIZ_WIDTH, HIZ_HEIGHT);
+    levelSizes.append(size);
+
+    while(size.width() > 1 || size.height() > 1)
+    {
+        size = QSize(qMax(1, size.width() / 2), qMax(1, size.height() / 2));
+        levelSizes.append(size);
+    }
+
+    minDepthLevels.resize(levelSizes.size());
+    maxDepthLevels.resize(levelSizes.size());
+
+    for(int level = 1; level < levelSizes.size(); ++level)
+    {
+        minDepthLevels[level].resize(levelSizes[level].width() * levelSizes[level].height());
+        maxDepthLevels[level].resize(levelSizes[level].width() * levelSizes[level].height());
+    }
+
+    bandTriangles.resize(HIZ_NUM_BANDS);
+
+    // the calling thread rasterizes the first band
+    threadPool.setMaxThreadCount(HIZ_NUM_BANDS - 1);
+}
+
+//------------------------------------------------------------------------------------------
+// the proxy is made of the boxes of the grid cells lying entirely inside the mesh, so it
+// never covers a pixel the mesh leaves open, however concave the mesh is
+//------------------------------------------------------------------------------------------
+void OcclusionCuller::setOccluderMesh(int _meshIndex, const float* _vertices,
+                                      int _numVertices, const unsigned int* _indices,
+                                      int _numIndices, const AABB& _bounds)
+{
+    Q_UNUSED(_numVertices);
+
+    if(occluderProxies.size() <= _meshIndex)
+    {
+        occluderProxies.resize(_meshIndex + 1);
+    }
+
+    OccluderProxy& proxy = occluderProxies[_meshIndex];
+    proxy.vertices.clear();
+    proxy.indices.clear();
+
+    QVector<char> cells;
+    markInteriorCells(_vertices, _indices, _numIndices, _bounds, cells);
+    addInteriorBoxes(cells, _bounds, proxy);
+
+    qDebug() << "Occluder proxy of mesh" << _meshIndex << ":" << _numIndices / 3 << "->"
+             << proxy.indices.size() / 3 << "triangles";
+}
+
+//------------------------------------------------------------------------------------------
+// the cells overlapped by the bounding box of a triangle may contain the surface, the
+// other cells reached from the border of the grid without crossing them are outside, the
+// remaining ones are enclosed by the surface; a hole larger than a cell opens the inside
+// to the outside, which only loses occluders
+//------------------------------------------------------------------------------------------
+void OcclusionCuller::markInteriorCells(const float* _vertices,
+                                        const unsigned int* _indices, int _numIndices,
+                                        const AABB& _bounds, QVector<char>& _cells)
+{
+    const int N = OCCLUDER_PROXY_GRID;
+    _cells.fill(INTERIOR_CELL, N * N * N);
+
+    QVector3D size = _bounds.maxPoint - _bounds.minPoint;
+
+    if(size.x() <= 0.0f || size.y() <= 0.0f || size.z() <= 0.0f)
+    {
+        _cells.fill(OUTSIDE_CELL);
+        return;
+    }
+
+    /////////////////////////////////////////////////////////////////
+    // the surface cells, slightly enlarged against the rounding errors
+    for(int i = 0; i + 2 < _numIndices; i += 3)
+    {
+        int minCell[3], maxCell[3];
+
+        for(int j = 0; j < 3; ++j)
+        {
+            float minCoord = FLT_MAX, maxCoord = -FLT_MAX;
+
+            for(int k = 0; k < 3; ++k)
+            {
+                float coord = _vertices[3 * _indices[i + k] + j];
+                minCoord = qMin(minCoord, coord);
+                maxCoord = qMax(maxCoord, coord);
+            }
+
+            minCoord = (minCoord - _bounds.minPoint[j]) / size[j] * N - 1e-3f;
+            maxCoord = (maxCoord - _bounds.minPoint[j]) / size[j] * N + 1e-3f;
+            minCell[j] = qBound(0, (int) floor(minCoord), N - 1);
+            maxCell[j] = qBound(0, (int) floor(maxCoord), N - 1);
+        }
+
+        for(int z = minCell[2]; z <= maxCell[2]; ++z)
+        {
+            for(int y = minCell[1]; y <= maxCell[1]; ++y)
+            {
+                for(int x = minCell[0]; x <= maxCell[0]; ++x)
+                {
+                    _cells[(z * N + y) * N + x] = SURFACE_CELL;
+                }
+            }
+        }
+    }
+
+    /////////////////////////////////////////////////////////////////
+    // flood the outside from the border of the grid
+    QVector<int> stack;
+
+    for(int z = 0; z < N; ++z)
+    {
+        for(int y = 0; y < N; ++y)
+        {
+            for(int x = 0; x < N; ++x)
+            {
+                int cell = (z * N + y) * N + x;
+                bool border = (x == 0 || y == 0 || z == 0 || x == N - 1 || y == N - 1 ||
+                               z == N - 1);
+
+                if(border && _cells[cell] == INTERIOR_CELL)
+                {
+                    _cells[cell] = OUTSIDE_CELL;
+                    stack.append(cell);
+                }
+            }
+        }
+    }
+
+    while(!stack.isEmpty())
+    {
+        int cell = stack.last();
+        stack.removeLast();
+
+        int x = cell % N;
+        int y = (cell / N) % N;
+        int z = cell / (N * N);
+        int neighbors[6] = {x > 0 ? cell - 1 : -1, x < N - 1 ? cell + 1 : -1,
+                            y > 0 ? cell - N : -1, y < N - 1 ? cell + N : -1,
+                            z > 0 ? cell - N * N : -1, z < N - 1 ? cell + N * N : -1
+                           };
+
+        for(int i = 0; i < 6; ++i)
+        {
+            if(neighbors[i] >= 0 && _cells[neighbors[i]] == INTERIOR_CELL)
+            {
+                _cells[neighbors[i]] = OUTSIDE_CELL;
+                stack.append(neighbors[i]);
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// merge the interior cells greedily into boxes, along x, then y, then z, and triangulate
+// them with the front faces counter-clockwise
+//------------------------------------------------------------------------------------------
+void OcclusionCuller::addInteriorBoxes(QVector<char>& _cells, const AABB& _bounds,
+                                       OccluderProxy& _proxy)
+{
+    const int N = OCCLUDER_PROXY_GRID;
+    // the corners are indexed by their (x, y, z) bits
+    static const unsigned int boxIndices[36] =
+    {
+        0, 4, 6, 0, 6, 2, // -x
+        1, 3, 7, 1, 7, 5, // +x
+        0, 1, 5, 0, 5, 4, // -y
+        2, 6, 7, 2, 7, 3, // +y
+        0, 2, 3, 0, 3, 1, // -z
+        4, 5, 7, 4, 7, 6  // +z
+    };
+
+    QVector3D cellSize = (_bounds.maxPoint - _bounds.minPoint) / (float) N;
+
+    for(int z = 0; z < N; ++z)
+    {
+        for(int y = 0; y < N; ++y)
+        {
+            for(int x = 0; x < N; ++x)
+            {
+                if(_cells[(z * N + y) * N + x] != INTERIOR_CELL)
+                {
+                    continue;
+                }
+
+                /////////////////////////////////////////////////////////////////
+                // grow the box while all its new cells are free interior cells
+                int maxX = x, maxY = y, maxZ = z;
+
+                while(maxX + 1 < N && _cells[(z * N + y) * N + maxX + 1] == INTERIOR_CELL)
+                {
+                    ++maxX;
+                }
+
+                for(bool grow = true; grow && maxY + 1 < N;)
+                {
+                    for(int i = x; i <= maxX && grow; ++i)
+                    {
+                        grow = (_cells[(z * N + maxY + 1) * N + i] == INTERIOR_CELL);
+                    }
+
+                    maxY += grow ? 1 : 0;
+                }
+
+                for(bool grow = true; grow && maxZ + 1 < N;)
+                {
+                    for(int j = y; j <= maxY && grow; ++j)
+                    {
+                        for(int i = x; i <= maxX && grow; ++i)
+                        {
+                            grow = (_cells[((maxZ + 1) * N + j) * N + i] == INTERIOR_CELL);
+                        }
+                    }
+
+                    maxZ += grow ? 1 : 0;
+                }
+
+                for(int k = z; k <= maxZ; ++k)
+                {
+                    for(int j = y; j <= maxY; ++j)
+                    {
+                        for(int i = x; i <= maxX; ++i)
+                        {
+                            _cells[(k * N + j) * N + i] = USED_CELL;
+                        }
+                    }
+                }
+
+                /////////////////////////////////////////////////////////////////
+                // the box triangles
+                QVector3D minPoint = _bounds.minPoint + cellSize * QVector3D(x, y, z);
+                QVector3D maxPoint = _bounds.minPoint +
+                                     cellSize * QVector3D(maxX + 1, maxY + 1, maxZ + 1);
+                unsigned int firstVertex = _proxy.vertices.size();
+
+                for(int i = 0; i < 8; ++i)
+                {
+                    _proxy.vertices.append(QVector3D((i & 1) ? maxPoint.x() : minPoint.x(),
+                                                     (i & 2) ? maxPoint.y() : minPoint.y(),
+                                                     (i & 4) ? maxPoint.z() : minPoint.z()));
+                }
+
+                for(int i = 0; i < 36; ++i)
+                {
+                    _proxy.indices.append(firstVertex + boxIndices[i]);
+                }
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+void OcclusionCuller::cull(const Scene& _scene, const QMatrix4x4& _viewProjectionMatrix,
+                           const QVector3D& _cameraPosition, QVector<int>& _visibleObjects)
+{
+    stats = OcclusionStats();
+    QElapsedTimer timer;
+    timer.start();
+
+    /////////////////////////////////////////////////////////////////
+    // clear the depth buffer, it must not be shared with the max pyramid while it is written
+    maxDepthLevels[0] = QVector<float>();
+    minDepthLevels[0].fill(1.0f, HIZ_WIDTH * HIZ_HEIGHT);
+    depthBuffer = minDepthLevels[0].data();
+
+    setupOccluders(_scene, _viewProjectionMatrix, _cameraPosition, _visibleObjects);
+
+    /////////////////////////////////////////////////////////////////
+    // rasterize one band of rows per thread, this thread takes the first band
+    QList<QFuture<void> > futures;
+
+    for(int band = 1; band < HIZ_NUM_BANDS; ++band)
+    {
+        futures.append(QtConcurrent::run(&threadPool, this, &OcclusionCuller::rasterizeBand,
+                                         band));
+    }
+
+    rasterizeBand(0);
+
+    for(int i = 0; i < futures.size(); ++i)
+    {
+        futures[i].waitForFinished();
+    }
+
+    buildPyramid();
+    stats.rasterTimeNs = timer.nsecsElapsed();
+
+    /////////////////////////////////////////////////////////////////
+    // test the objects, keeping their order
+    timer.restart();
+    int numVisible = 0;
+
+    for(int i = 0; i < _visibleObjects.size(); ++i)
+    {
+        if(isBoxVisible(_scene.getObject(_visibleObjects[i]).bounds, _viewProjectionMatrix))
+        {
+            _visibleObjects[numVisible++] = _visibleObjects[i];
+        }
+    }
+
+    stats.numTested = _visibleObjects.size();
+    stats.numOccluded = _visibleObjects.size() - numVisible;
+    _visibleObjects.resize(numVisible);
+    stats.testTimeNs = timer.nsecsElapsed();
+}
+
+//------------------------------------------------------------------------------------------
+const OcclusionStats& OcclusionCuller::getStats() const
+{
+    return stats;
+}
+
+//------------------------------------------------------------------------------------------
+// the nearest visible objects are the occluders
+//------------------------------------------------------------------------------------------
+void OcclusionCuller::setupOccluders(const Scene& _scene,
+                                     const QMatrix4x4& _viewProjectionMatrix,
+                                     const QVector3D& _cameraPosition,
+                                     const QVector<int>& _visibleObjects)
+{
+    QVector<QPair<float, int> > candidates;
+    candidates.reserve(_visibleObjects.size());
+
+    for(int i = 0; i < _visibleObjects.size(); ++i)
+    {
+        const SceneObject& object = _scene.getObject(_visibleObjects[i]);
+
+        if(object.meshIndex >= occluderProxies.size())
+        {
+            continue;
+        }
+
+        float distance = (object.bounds.getCenter() - _cameraPosition).lengthSquared();
+        candidates.append(qMakePair(distance, _visibleObjects[i]));
+    }
+
+    int numOccluders = qMin(candidates.size(), OCCLUSION_MAX_OCCLUDERS);
+    std::partial_sort(candidates.begin(), candidates.begin() + numOccluders,
+                      candidates.end());
+
+    triangles.resize(0);
+
+    for(int i = 0; i < numOccluders; ++i)
+    {
+        const SceneObject& object = _scene.getObject(candidates[i].second);
+        const OccluderProxy& proxy = occluderProxies[object.meshIndex];
+        QMatrix4x4 mvpMatrix = _viewProjectionMatrix * object.transform;
+        QVector<QVector4D> clipVertices(proxy.vertices.size());
+
+        for(int j = 0; j < proxy.vertices.size(); ++j)
+        {
+            clipVertices[j] = mvpMatrix * QVector4D(proxy.vertices[j], 1.0f);
+        }
+
+        for(int j = 0; j < proxy.indices.size(); j += 3)
+        {
+            setupTriangle(clipVertices[proxy.indices[j]], clipVertices[proxy.indices[j + 1]],
+                          clipVertices[proxy.indices[j + 2]]);
+        }
+    }
+
+    /////////////////////////////////////////////////////////////////
+    // bin the triangles by band
+    for(int band = 0; band < HIZ_NUM_BANDS; ++band)
+    {
+        bandTriangles[band].resize(0);
+    }
+
+    for(int i = 0; i < triangles.size(); ++i)
+    {
+        int firstBand = triangles[i].minY * HIZ_NUM_BANDS / HIZ_HEIGHT;
+        int lastBand = triangles[i].maxY * HIZ_NUM_BANDS / HIZ_HEIGHT;
+
+        for(int band = firstBand; band <= lastBand; ++band)
+        {
+            bandTriangles[band].append(i);
+        }
+    }
+
+    stats.numOccluders = numOccluders;
+    stats.numOccluderTriangles = triangles.size();
+}
+
+//------------------------------------------------------------------------------------------
+// triangles crossing the near plane are dropped: missing occluders are always safe
+//------------------------------------------------------------------------------------------
+void OcclusionCuller::setupTriangle(const QVector4D& _v0, const QVector4D& _v1,
+                                    const QVector4D& _v2)
+{
+    const float nearW = 1e-3f;
+
+    if(_v0.w() < nearW || _v1.w() < nearW || _v2.w() < nearW)
+    {
+        return;
+    }
+
+    const QVector4D* clip[3] = {&_v0, &_v1, &_v2};
+    float x[3], y[3], z[3];
+
+    for(int i = 0; i < 3; ++i)
+    {
+        float invW = 1.0f / clip[i]->w();
+        x[i] = (clip[i]->x() * invW * 0.5f + 0.5f) * HIZ_WIDTH;
+        y[i] = (clip[i]->y() * invW * 0.5f + 0.5f) * HIZ_HEIGHT;
+        z[i] = clip[i]->z() * invW * 0.5f + 0.5f;
+    }
+
+    // back faces and degenerated triangles
+    float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+
+    if(area <= 0.0f)
+    {
+        return;
+    }
+
+    ScreenTriangle triangle;
+
+    // pixel centers inside the bounding box
+    triangle.minX = qMax(0, (int) ceil(qMin(x[0], qMin(x[1], x[2])) - 0.5f));
+    triangle.maxX = qMin(HIZ_WIDTH - 1, (int) floor(qMax(x[0], qMax(x[1], x[2])) - 0.5f));
+    triangle.minY = qMax(0, (int) ceil(qMin(y[0], qMin(y[1], y[2])) - 0.5f));
+    triangle.maxY = qMin(HIZ_HEIGHT - 1, (int) floor(qMax(y[0], qMax(y[1], y[2])) - 0.5f));
+
+    if(triangle.minX > triangle.maxX || triangle.minY > triangle.maxY)
+    {
+        return;
+    }
+
+    for(int i = 0; i < 3; ++i)
+    {
+        int j = (i + 1) % 3;
+        triangle.edgeA[i] = y[i] - y[j];
+        triangle.edgeB[i] = x[j] - x[i];
+        triangle.edgeC[i] = -(triangle.edgeA[i] * x[i] + triangle.edgeB[i] * y[i]);
+    }
+
+    float invArea = 1.0f / area;
+    triangle.depthA = ((z[1] - z[0]) * (y[2] - y[0]) - (z[2] - z[0]) * (y[1] - y[0])) * invArea;
+    triangle.depthB = ((z[2] - z[0]) * (x[1] - x[0]) - (z[1] - z[0]) * (x[2] - x[0])) * invArea;
+    triangle.depthC = z[0] - triangle.depthA * x[0] - triangle.depthB * y[0];
+
+    triangles.append(triangle);
+}
+
+//------------------------------------------------------------------------------------------
+void OcclusionCuller::rasterizeBand(int _band)
+{
+    int minRow = _band * HIZ_HEIGHT / HIZ_NUM_BANDS;
+    int maxRow = (_band + 1) * HIZ_HEIGHT / HIZ_NUM_BANDS - 1;
+    const QVector<int>& bandList = bandTriangles[_band];
+
+    for(int i = 0; i < bandList.size(); ++i)
+    {
+        rasterizeTriangle(triangles[bandList[i]], minRow, maxRow);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// keep the nearest depth of the pixels whose centers are inside the triangle, 4 pixels
+// at a time
+//------------------------------------------------------------------------------------------
+void OcclusionCuller::rasterizeTriangle(const ScreenTriangle& _triangle, int _minRow,
+                                        int _maxRow)
+{
+    int minY = qMax(_minRow, _triangle.minY);
+    int maxY = qMin(_maxRow, _triangle.maxY);
+    int minX = _triangle.minX & ~3;
+
+#ifdef __SSE2__
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 pixelOffsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+    __m128 edgeA[3];
+
+    for(int i = 0; i < 3; ++i)
+    {
+        edgeA[i] = _mm_set1_ps(_triangle.edgeA[i]);
+    }
+
+    __m128 depthA = _mm_set1_ps(_triangle.depthA);
+
+    for(int y = minY; y <= maxY; ++y)
+    {
+        float centerY = y + 0.5f;
+        __m128 edgeRow[3];
+
+        for(int i = 0; i < 3; ++i)
+        {
+            edgeRow[i] = _mm_set1_ps(_triangle.edgeB[i] * centerY + _triangle.edgeC[i]);
+        }
+
+        __m128 depthRow = _mm_set1_ps(_triangle.depthB * centerY + _triangle.depthC);
+        float* row = depthBuffer + y * HIZ_WIDTH;
+
+        for(int x = minX; x <= _triangle.maxX; x += 4)
+        {
+            __m128 centerX = _mm_add_ps(_mm_set1_ps((float) x), pixelOffsets);
+            __m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeA[0], centerX), edgeRow[0]),
+                                         zero);
+            inside = _mm_and_ps(inside,
+                                _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeA[1], centerX),
+                                                        edgeRow[1]), zero));
+            inside = _mm_and_ps(inside,
+                                _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeA[2], centerX),
+                                                        edgeRow[2]), zero));
+
+            if(!_mm_movemask_ps(inside))
+            {
+                continue;
+            }
+
+            __m128 depth = _mm_add_ps(_mm_mul_ps(depthA, centerX), depthRow);
+            __m128 current = _mm_loadu_ps(row + x);
+            __m128 nearest = _mm_min_ps(current, depth);
+            _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest),
+                                             _mm_andnot_ps(inside, current)));
+        }
+    }
+#else
+    for(int y = minY; y <= maxY; ++y)
+    {
+        float centerY = y + 0.5f;
+        float* row = depthBuffer + y * HIZ_WIDTH;
+
+        for(int x = minX; x <= _triangle.maxX; ++x)
+        {
+            float centerX = x + 0.5f;
+            bool inside = true;
+
+            for(int i = 0; i < 3; ++i)
+            {
+                inside = inside && (_triangle.edgeA[i] * centerX + _triangle.edgeB[i] * centerY +
+                                    _triangle.edgeC[i] >= 0.0f);
+            }
+
+            if(inside)
+            {
+                float depth = _triangle.depthA * centerX + _triangle.depthB * centerY +
+                              _triangle.depthC;
+                row[x] = qMin(row[x], depth);
+            }
+        }
+    }
+#endif
+}
+
+//------------------------------------------------------------------------------------------
+void OcclusionCuller::buildPyramid()
+{
+    maxDepthLevels[0] = minDepthLevels[0];
+
+    for(int level = 1; level < levelSizes.size(); ++level)
+    {
+        const QSize& size = levelSizes[level];
+        const QSize& prevSize = levelSizes[level - 1];
+        const float* prevMin = minDepthLevels[level - 1].constData();
+        const float* prevMax = maxDepthLevels[level - 1].constData();
+        float* levelMin = minDepthLevels[level].data();
+        float* levelMax = maxDepthLevels[level].data();
+
+        for(int y = 0; y < size.height(); ++y)
+        {
+            int y0 = qMin(2 * y, prevSize.height() - 1) * prevSize.width();
+            int y1 = qMin(2 * y + 1, prevSize.height() - 1) * prevSize.width();
+
+            for(int x = 0; x < size.width(); ++x)
+            {
+                int x0 = qMin(2 * x, prevSize.width() - 1);
+                int x1 = qMin(2 * x + 1, prevSize.width() - 1);
+
+                levelMin[y * size.width() + x] =
+                    qMin(qMin(prevMin[y0 + x0], prevMin[y0 + x1]),
+                         qMin(prevMin[y1 + x0], prevMin[y1 + x1]));
+                levelMax[y * size.width() + x] =
+                    qMax(qMax(prevMax[y0 + x0], prevMax[y0 + x1]),
+                         qMax(prevMax[y1 + x0], prevMax[y1 + x1]));
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// boxes crossing the near plane are always visible
+//------------------------------------------------------------------------------------------
+bool OcclusionCuller::isBoxVisible(const AABB& _box, const QMatrix4x4& _viewProjectionMatrix)
+{
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+    float nearestDepth = FLT_MAX;
+
+    for(int i = 0; i < 8; ++i)
+    {
+        QVector4D corner((i & 1) ? _box.maxPoint.x() : _box.minPoint.x(),
+                         (i & 2) ? _box.maxPoint.y() : _box.minPoint.y(),
+                         (i & 4) ? _box.maxPoint.z() : _box.minPoint.z(), 1.0f);
+        QVector4D clip = _viewProjectionMatrix * corner;
+
+        if(clip.w() < 1e-3f)
+        {
+            return true;
+        }
+
+        float invW = 1.0f / clip.w();
+        float x = (clip.x() * invW * 0.5f + 0.5f) * HIZ_WIDTH;
+        float y = (clip.y() * invW * 0.5f + 0.5f) * HIZ_HEIGHT;
+
+        minX = qMin(minX, x);
+        maxX = qMax(maxX, x);
+        minY = qMin(minY, y);
+        maxY = qMax(maxY, y);
+        nearestDepth = qMin(nearestDepth, clip.z() * invW * 0.5f + 0.5f);
+    }
+
+    int pixelMinX = qMax(0, (int) floor(minX));
+    int pixelMaxX = qMin(HIZ_WIDTH - 1, (int) floor(maxX));
+    int pixelMinY = qMax(0, (int) floor(minY));
+    int pixelMaxY = qMin(HIZ_HEIGHT - 1, (int) floor(maxY));
+
+    if(pixelMinX > pixelMaxX || pixelMinY > pixelMaxY)
+    {
+        return false;
+    }
+
+    /////////////////////////////////////////////////////////////////
+    // start at the level where the rectangle spans at most 2x2 texels
+    int extent = qMax(pixelMaxX - pixelMinX, pixelMaxY - pixelMinY) + 1;
+    int level = 0;
+
+    while((1 << level) < extent && level < levelSizes.size() - 1)
+    {
+        ++level;
+    }
+
+    return isRegionVisible(level, pixelMinX, pixelMinY, pixelMaxX, pixelMaxY, nearestDepth);
+}
+
+//------------------------------------------------------------------------------------------
+// the region is given in pixels of level 0
+//------------------------------------------------------------------------------------------
+bool OcclusionCuller::isRegionVisible(int _level, int _minX, int _minY, int _maxX,
+                                      int _maxY, float _depth)
+{
+    const QSize& size = levelSizes[_level];
+    const float* levelMin = minDepthLevels[_level].constData();
+    const float* levelMax = maxDepthLevels[_level].constData();
+    int texelMinX = qMin(_minX >> _level, size.width() - 1);
+    int texelMaxX = qMin(_maxX >> _level, size.width() - 1);
+    int texelMinY = qMin(_minY >> _level, size.height() - 1);
+    int texelMaxY = qMin(_maxY >> _level, size.height() - 1);
+
+    for(int y = texelMinY; y <= texelMaxY; ++y)
+    {
+        for(int x = texelMinX; x <= texelMaxX; ++x)
+        {
+            // in front of all occluders of the texel
+            if(_depth <= levelMin[y * size.width() + x])
+            {
+                return true;
+            }
+
+            // behind all occluders of the texel
+            if(_depth > levelMax[y * size.width() + x] || _level == 0)
+            {
+                continue;
+            }
+
+            if(isRegionVisible(_level - 1,
+                               qMax(_minX, x << _level), qMax(_minY, y << _level),
+                               qMin(_maxX, ((x + 1) << _level) - 1),
+                               qMin(_maxY, ((y + 1) << _level) - 1), _depth))
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
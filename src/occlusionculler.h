@@ -0,0 +1,130 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#ifndef OCCLUSIONCULLER_H
+#define OCCLUSIONCULLER_H
+
+#include <QtGui>
+#include <QtConcurrent>
+
+#include "scene.h"
+
+#define HIZ_WIDTH               256
+#define HIZ_HEIGHT              128
+#define HIZ_NUM_BANDS           8
+#define OCCLUSION_MAX_OCCLUDERS 16
+#define OCCLUDER_PROXY_GRID     16 // cells per axis of the mesh bounds
+
+//------------------------------------------------------------------------------------------
+struct OcclusionStats
+{
+    OcclusionStats():
+        numOccluders(0),
+        numOccluderTriangles(0),
+        numTested(0),
+        numOccluded(0),
+        rasterTimeNs(0),
+        testTimeNs(0) {}
+
+    int numOccluders;
+    int numOccluderTriangles;
+    int numTested;
+    int numOccluded;
+    qint64 rasterTimeNs;
+    qint64 testTimeNs;
+};
+
+//------------------------------------------------------------------------------------------
+// Software hierarchical-Z occlusion culling: the nearest visible objects are rasterized
+// as proxies made of boxes inside their meshes into a small depth buffer (SSE, one band
+// of rows per thread of its own pool), a min/max depth pyramid is built on top, then the
+// screen rectangle of each object bounding box is tested against the pyramid, from the
+// coarse level down only where the result is ambiguous. The objects behind the occluders
+// are removed from the visible list.
+//------------------------------------------------------------------------------------------
+class OcclusionCuller
+{
+public:
+    OcclusionCuller();
+
+    // build the occluder proxy of the mesh, _indices are relative to _vertices
+    void setOccluderMesh(int _meshIndex, const float* _vertices, int _numVertices,
+                         const unsigned int* _indices, int _numIndices,
+                         const AABB& _bounds);
+
+    void cull(const Scene& _scene, const QMatrix4x4& _viewProjectionMatrix,
+              const QVector3D& _cameraPosition, QVector<int>& _visibleObjects);
+    const OcclusionStats& getStats() const;
+
+private:
+    // cells of the grid over the mesh bounds
+    enum ProxyCell
+    {
+        INTERIOR_CELL = 0,
+        SURFACE_CELL,
+        OUTSIDE_CELL,
+        USED_CELL // merged into a box
+    };
+
+    struct OccluderProxy
+    {
+        QVector<QVector3D> vertices;
+        QVector<unsigned int> indices;
+    };
+
+    static void markInteriorCells(const float* _vertices, const unsigned int* _indices,
+                                  int _numIndices, const AABB& _bounds,
+                                  QVector<char>& _cells);
+    static void addInteriorBoxes(QVector<char>& _cells, const AABB& _bounds,
+                                 OccluderProxy& _proxy);
+
+    // edge functions and depth plane, in pixel units: f(x, y) = a * x + b * y + c
+    struct ScreenTriangle
+    {
+        float edgeA[3];
+        float edgeB[3];
+        float edgeC[3];
+        float depthA;
+        float depthB;
+        float depthC;
+        int minX;
+        int maxX;
+        int minY;
+        int maxY;
+    };
+
+    void setupOccluders(const Scene& _scene, const QMatrix4x4& _viewProjectionMatrix,
+                        const QVector3D& _cameraPosition,
+                        const QVector<int>& _visibleObjects);
+    void setupTriangle(const QVector4D& _v0, const QVector4D& _v1, const QVector4D& _v2);
+    void rasterizeBand(int _band);
+    void rasterizeTriangle(const ScreenTriangle& _triangle, int _minRow, int _maxRow);
+    void buildPyramid();
+    bool isBoxVisible(const AABB& _box, const QMatrix4x4& _viewProjectionMatrix);
+    bool isRegionVisible(int _level, int _minX, int _minY, int _maxX, int _maxY,
+                         float _depth);
+
+    QVector<OccluderProxy> occluderProxies;
+    QVector<ScreenTriangle> triangles;
+    QVector<QVector<int> > bandTriangles;
+
+    // level 0 is the depth buffer, the nearest occluder depth of each pixel, which is
+    // shared by the min and max pyramids
+    QVector<QSize> levelSizes;
+    QVector<QVector<float> > minDepthLevels;
+    QVector<QVector<float> > maxDepthLevels;
+    float* depthBuffer;
+
+    // the rasterization waits for its bands every frame, so it does not share the global
+    // pool with the texture decoding
+    QThreadPool threadPool;
+
+    OcclusionStats stats;
+};
+
+#endif // OCCLUSIONCULLER_H
@@ -12,6 +12,8 @@ Renderer::Renderer(QWidget* _parent):
     QOpenGLWidget(_parent),
     initializedScene(false),
     initializedTestScene(false),
+    renderedFirstFrame(false),
+    useUberShader(false),
     enabledRenderSilhouette(false),
     specialKeyPressed(Renderer::NO_KEY),
     mouseButtonPressed(Renderer::NO_BUTTON),
@@ -21,6 +23,10 @@ Renderer::Renderer(QWidget* _parent):
     rotationLag(0.0f, 0.0f, 0.0f),
     zooming(0.0f),
     objLoader(NULL),
+    toonDiffuseRamp(DEFAULT_TOON_DIFFUSE_BANDS),
+    toonSpecularRamp(DEFAULT_TOON_SPECULAR_BANDS),
+    toonDiffuseRampTexture(NULL),
+    toonSpecularRampTexture(NULL),
     cameraPosition(DEFAULT_CAMERA_POSITION),
     cameraFocus(DEFAULT_CAMERA_FOCUS),
     cameraUpDirection(0.0f, 1.0f, 0.0f),
@@ -32,6 +38,38 @@ Renderer::Renderer(QWidget* _parent):
     retinaScale = devicePixelRatio();
     setFocusPolicy(Qt::StrongFocus);
 
+    for(int i = 0; i < NUM_PROGRAMS; ++i)
+    {
+        glslPrograms[i] = NULL;
+        programFeatures[i] = 0;
+        programReady[i] = false;
+    }
+
+    for(int i = 0; i < NumMetalTextures; ++i)
+    {
+        normalMapIDs[i] = -1;
+        colorMapIDs[i] = -1;
+    }
+
+    colorTextureArrayID = -1;
+    normalTextureArrayID = -1;
+    numSceneObjects = 1;
+    numVisibleObjects = 0;
+    animateSceneObjects = false;
+    gpuCullingSupported = false;
+    useGpuCulling = false;
+    enabledOcclusionCulling = false;
+    enabledDepthPrepass = true;
+    numDepthPrepassObjects = 0;
+    shadowCastersChanged = true;
+    shadowMap.setNumCascades(DEFAULT_SHADOW_CASCADES);
+    enabledGpuProfiler = false;
+    frameTimeScale = 1.0f;
+    renderingContinuously = false;
+    lastSceneStatsTime = 0;
+    meshBufferGeneration = -1;
+    sceneTimer.start();
+
     ////////////////////////////////////////////////////////////////////////////////
     // mesh object texture
     strListMeshObjectTexture = new QStringList;
@@ -45,6 +83,15 @@ Renderer::Renderer(QWidget* _parent):
     TRUE_OR_DIE(strListMeshObjectTexture->size() == NumMetalTextures,
                 "Ohh, you forget to initialize some floor texture...");
 
+    TRUE_OR_DIE(NUM_MESH_OBJECT - FIRST_STRESS_MESH_OBJECT == NUM_STRESS_MESH,
+                "Each procedural mesh needs its mesh object...");
+    const int defaultStressMeshLevels[NUM_STRESS_MESH] = DEFAULT_STRESS_MESH_LEVELS;
+
+    for(int i = 0; i < NUM_STRESS_MESH; ++i)
+    {
+        stressMeshLevels[i] = defaultStressMeshLevels[i];
+    }
+
 }
 
 //------------------------------------------------------------------------------------------
@@ -131,51 +178,30 @@ void Renderer::initTestScene()
 //------------------------------------------------------------------------------------------
 void Renderer::initScene()
 {
-    TRUE_OR_DIE(initShaderPrograms(), "Cannot initialize shaders. Exit...");
+    TRACE_SCOPE("initScene");
+
+    // the texture formats select the shader variants, the shaders are then compiled
+    // by the driver while we are loading the other data
     initTexture();
+    TRUE_OR_DIE(initShaderPrograms(), "Cannot initialize shaders. Exit...");
+    initToonRampTextures();
     initSceneMemory();
-    initVertexArrayObjects();
     initSharedBlockUniform();
+    initGpuCulling();
+    initGpuProfiler();
+    shadowMap.initialize();
     initSceneMatrices();
+
+    // without parallel compile support, the status queries would block anyway
+    TRUE_OR_DIE(updateShaderPrograms(!shaderCompiler.hasParallelCompile()),
+                "Cannot initialize shaders. Exit...");
 }
 //------------------------------------------------------------------------------------------
 bool Renderer::initPhongShadingProgram()
 {
-    QOpenGLShaderProgram* program;
+    QOpenGLShaderProgram* program = glslPrograms[PhongShading];
     GLint location;
 
-    /////////////////////////////////////////////////////////////////
-    glslPrograms[PhongShading] = new QOpenGLShaderProgram;
-    program = glslPrograms[PhongShading];
-    bool success;
-
-    success = program->addShaderFromSourceFile(QOpenGLShader::Vertex,
-                                               vertexShaderSourceMap.value(PhongShading));
-    TRUE_OR_DIE(success, "Cannot compile shader from file.");
-
-    success = program->addShaderFromSourceFile(QOpenGLShader::Fragment,
-                                               fragmentShaderSourceMap.value(PhongShading));
-    TRUE_OR_DIE(success, "Cannot compile shader from file.");
-
-    success = program->addShaderFromSourceFile(QOpenGLShader::Geometry,
-                                               ":/shaders/phong-shading.gs.glsl");
-    TRUE_OR_DIE(success, "Cannot compile shader from file.");
-
-    success = program->link();
-    TRUE_OR_DIE(success, "Cannot link GLSL program.");
-
-    location = program->attributeLocation("v_coord");
-    TRUE_OR_DIE(location >= 0, "Cannot bind attribute vertex coordinate.");
-    attrVertex[PhongShading] = location;
-
-    location = program->attributeLocation("v_normal");
-    TRUE_OR_DIE(location >= 0, "Cannot bind attribute vertex normal.");
-    attrNormal[PhongShading] = location;
-
-    location = program->attributeLocation("v_texCoord");
-    TRUE_OR_DIE(location >= 0, "Cannot bind attribute vertex texCoord.");
-    attrTexCoord[PhongShading] = location;
-
     location = glGetUniformBlockIndex(program->programId(), "Matrices");
     TRUE_OR_DIE(location >= 0, "Cannot bind block uniform.");
     uniMatrices[PhongShading] = location;
@@ -196,25 +222,15 @@ bool Renderer::initPhongShadingProgram()
     TRUE_OR_DIE(location >= 0, "Cannot bind uniform ambientLight.");
     uniAmbientLight[PhongShading] = location;
 
-    location = program->uniformLocation("objTex");
-    TRUE_OR_DIE(location >= 0, "Cannot bind uniform objTex.");
-    uniObjTexture[PhongShading] = location;
-
-    location = program->uniformLocation("hasObjTex");
-    TRUE_OR_DIE(location >= 0, "Cannot bind uniform hasObjTex.");
-    uniHasObjTexture[PhongShading] = location;
-
-    location = program->uniformLocation("normalTex");
-    TRUE_OR_DIE(location >= 0, "Cannot bind uniform normalTex.");
-    uniNormalTexture[PhongShading] = location;
-
-    location = program->uniformLocation("hasNormalTex");
-    TRUE_OR_DIE(location >= 0, "Cannot bind uniform hasNormalTex.");
-    uniHasNormalTexture[PhongShading] = location;
-
-    location = program->uniformLocation("needTangent");
-    TRUE_OR_DIE(location >= 0, "Cannot bind uniform needTangent.");
-    uniNeedTangent[PhongShading] = location;
+    // the samplers and feature flags exist only in some variants
+    uniObjTexture[PhongShading] = program->uniformLocation("objTex");
+    uniNormalTexture[PhongShading] = program->uniformLocation("normalTex");
+    uniHasObjTexture[PhongShading] = program->uniformLocation("hasObjTex");
+    uniHasNormalTexture[PhongShading] = program->uniformLocation("hasNormalTex");
+    uniNeedTangent[PhongShading] = program->uniformLocation("needTangent");
+    uniShadow[PhongShading] = glGetUniformBlockIndex(program->programId(), "Shadow");
+    uniDepthTexture[PhongShading] = program->uniformLocation("depthTex");
+    uniHasDepthTexture[PhongShading] = program->uniformLocation("hasDepthTex");
 
     return true;
 }
@@ -222,33 +238,9 @@ bool Renderer::initPhongShadingProgram()
 //------------------------------------------------------------------------------------------
 bool Renderer::initToonShadingProgram()
 {
-    QOpenGLShaderProgram* program;
+    QOpenGLShaderProgram* program = glslPrograms[ToonShading];
     GLint location;
 
-    /////////////////////////////////////////////////////////////////
-    glslPrograms[ToonShading] = new QOpenGLShaderProgram;
-    program = glslPrograms[ToonShading];
-    bool success;
-
-    success = program->addShaderFromSourceFile(QOpenGLShader::Vertex,
-                                               vertexShaderSourceMap.value(ToonShading));
-    TRUE_OR_DIE(success, "Cannot compile shader from file.");
-
-    success = program->addShaderFromSourceFile(QOpenGLShader::Fragment,
-                                               fragmentShaderSourceMap.value(ToonShading));
-    TRUE_OR_DIE(success, "Cannot compile shader from file.");
-
-    success = program->link();
-    TRUE_OR_DIE(success, "Cannot link GLSL program.");
-
-    location = program->attributeLocation("v_coord");
-    TRUE_OR_DIE(location >= 0, "Cannot bind attribute vertex coordinate.");
-    attrVertex[ToonShading] = location;
-
-    location = program->attributeLocation("v_normal");
-    TRUE_OR_DIE(location >= 0, "Cannot bind attribute vertex normal.");
-    attrNormal[ToonShading] = location;
-
     location = glGetUniformBlockIndex(program->programId(), "Matrices");
     TRUE_OR_DIE(location >= 0, "Cannot bind block uniform.");
     uniMatrices[ToonShading] = location;
@@ -269,6 +261,19 @@ bool Renderer::initToonShadingProgram()
     TRUE_OR_DIE(location >= 0, "Cannot bind uniform ambientLight.");
     uniAmbientLight[ToonShading] = location;
 
+    location = program->uniformLocation("diffuseRamp");
+    TRUE_OR_DIE(location >= 0, "Cannot bind uniform diffuseRamp.");
+    uniDiffuseRamp = location;
+
+    location = program->uniformLocation("specularRamp");
+    TRUE_OR_DIE(location >= 0, "Cannot bind uniform specularRamp.");
+    uniSpecularRamp = location;
+
+    // the shadows exist only in some variants
+    uniShadow[ToonShading] = glGetUniformBlockIndex(program->programId(), "Shadow");
+    uniDepthTexture[ToonShading] = program->uniformLocation("depthTex");
+    uniHasDepthTexture[ToonShading] = program->uniformLocation("hasDepthTex");
+
     return true;
 }
 
@@ -276,33 +281,25 @@ bool Renderer::initToonShadingProgram()
 //------------------------------------------------------------------------------------------
 bool Renderer::initRenderSilhouetteProgram()
 {
-    GLint location;
-    glslPrograms[ProgramRenderSilhouette] = new QOpenGLShaderProgram;
     QOpenGLShaderProgram* program = glslPrograms[ProgramRenderSilhouette];
-    bool success;
-
-    success = program->addShaderFromSourceFile(QOpenGLShader::Vertex,
-                                               vertexShaderSourceMap.value(ProgramRenderSilhouette));
-    TRUE_OR_DIE(success, "Cannot compile shader from file.");
-
-    success = program->addShaderFromSourceFile(QOpenGLShader::Fragment,
-                                               fragmentShaderSourceMap.value(ProgramRenderSilhouette));
-    TRUE_OR_DIE(success, "Cannot compile shader from file.");
+    GLint location;
 
-    success = program->link();
-    TRUE_OR_DIE(success, "Cannot link GLSL program.");
+    location = glGetUniformBlockIndex(program->programId(), "Matrices");
+    TRUE_OR_DIE(location >= 0, "Cannot bind block uniform.");
+    uniMatrices[ProgramRenderSilhouette] = location;
 
-    location = program->attributeLocation("v_coord");
-    TRUE_OR_DIE(location >= 0, "Cannot bind attribute vertex coordinate.");
-    attrVertex[ProgramRenderSilhouette] = location;
+    return true;
+}
 
-    location = program->attributeLocation("v_normal");
-    TRUE_OR_DIE(location >= 0, "Cannot bind attribute vertex normal.");
-    attrNormal[ProgramRenderSilhouette] = location;
+//------------------------------------------------------------------------------------------
+bool Renderer::initDepthPrepassProgram()
+{
+    QOpenGLShaderProgram* program = glslPrograms[ProgramDepthPrepass];
+    GLint location;
 
     location = glGetUniformBlockIndex(program->programId(), "Matrices");
     TRUE_OR_DIE(location >= 0, "Cannot bind block uniform.");
-    uniMatrices[ProgramRenderSilhouette] = location;
+    uniMatrices[ProgramDepthPrepass] = location;
 
     return true;
 }
@@ -314,16 +311,229 @@ bool Renderer::initShaderPrograms()
     vertexShaderSourceMap.insert(PhongShading, ":/shaders/phong-shading.vs.glsl");
     vertexShaderSourceMap.insert(ProgramRenderSilhouette,
                                  ":/shaders/silhouette.vs.glsl");
+    vertexShaderSourceMap.insert(ProgramDepthPrepass, ":/shaders/depth-prepass.vs.glsl");
 
     fragmentShaderSourceMap.insert(ToonShading, ":/shaders/toon-shading.fs.glsl");
     fragmentShaderSourceMap.insert(PhongShading, ":/shaders/phong-shading.fs.glsl");
     fragmentShaderSourceMap.insert(ProgramRenderSilhouette,
                                    ":/shaders/silhouette.fs.glsl");
+    fragmentShaderSourceMap.insert(ProgramDepthPrepass, ":/shaders/depth-prepass.fs.glsl");
+
+    geometryShaderSourceMap.insert(PhongShading, ":/shaders/phong-shading.gs.glsl");
+
+    /////////////////////////////////////////////////////////////////
+    // issue all the compile commands before querying any status,
+    // such that the programs can be compiled concurrently
+    shaderCompiler.initialize();
+
+    for(int i = 0; i < NUM_PROGRAMS; ++i)
+    {
+        ShadingProgram shadingMode = static_cast<ShadingProgram>(i);
+
+        // the textured variants are needed as soon as the textures are loaded
+        if(!compileProgramVariant(shadingMode, getShaderFeatures(shadingMode, false)) ||
+           !compileProgramVariant(shadingMode, getShaderFeatures(shadingMode, true)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+// the features required by the current mesh object and texture state
+//------------------------------------------------------------------------------------------
+int Renderer::getShaderFeatures(ShadingProgram _shadingMode)
+{
+    return getShaderFeatures(_shadingMode, isMeshObjectTextureReady());
+}
+
+//------------------------------------------------------------------------------------------
+// without textures, the mesh object is rendered with its flat material color
+//------------------------------------------------------------------------------------------
+int Renderer::getShaderFeatures(ShadingProgram _shadingMode, bool _texturesReady)
+{
+    int features = 0;
+
+    switch(_shadingMode)
+    {
+    case PhongShading:
+        if(!_texturesReady)
+        {
+            break;
+        }
+
+        features = FEATURE_OBJ_TEX | FEATURE_NORMAL_TEX | FEATURE_TANGENT;
+
+        if(textureLoader.getTextureFormat(normalMapIDs[currentMeshObjectTexture]) ==
+           GL_COMPRESSED_RG_RGTC2)
+        {
+            features |= FEATURE_RG_NORMAL_TEX;
+        }
+
+        break;
+
+    default:
+        break;
+    }
+
+    if((_shadingMode == PhongShading || _shadingMode == ToonShading) &&
+       shadowMap.getNumCascades() > 0)
+    {
+        features |= FEATURE_DEPTH_TEX;
+    }
+
+    // the uber-shader keeps computing the tangents in the geometry stage
+    if(useUberShader && _shadingMode != ProgramRenderSilhouette &&
+       _shadingMode != ProgramDepthPrepass)
+    {
+        features |= FEATURE_UBER_SHADER;
+    }
+    else if(features & FEATURE_TANGENT)
+    {
+        features |= FEATURE_VERTEX_TANGENT;
+    }
+
+    return features;
+}
+
+//------------------------------------------------------------------------------------------
+QStringList Renderer::getShaderDefines(int _features)
+{
+    QStringList defines;
+
+    if(_features & FEATURE_UBER_SHADER)
+    {
+        defines.append("UBER_SHADER 1");
+    }
+
+    defines.append(QString("HAS_OBJ_TEX %1").arg((_features & FEATURE_OBJ_TEX) ? 1 : 0));
+    defines.append(QString("HAS_NORMAL_TEX %1").arg((_features & FEATURE_NORMAL_TEX) ? 1 : 0));
+    defines.append(QString("NEED_TANGENT %1").arg((_features & FEATURE_TANGENT) ? 1 : 0));
+    defines.append(QString("HAS_DEPTH_TEX %1").arg((_features & FEATURE_DEPTH_TEX) ? 1 : 0));
+    defines.append(QString("VERTEX_TANGENT %1").arg((_features & FEATURE_VERTEX_TANGENT) ? 1 :
+                                                    0));
+    defines.append(QString("RG_NORMAL_TEX %1").arg((_features & FEATURE_RG_NORMAL_TEX) ? 1 :
+                                                   0));
+    bool geometryTangent = (_features & FEATURE_TANGENT) &&
+                           !(_features & FEATURE_VERTEX_TANGENT);
+    defines.append(QString("GEOMETRY_TANGENT %1").arg(geometryTangent ? 1 : 0));
+    defines.append(QString("NUM_MATERIALS %1").arg(NUM_MESH_OBJECT_MATERIALS));
+    defines.append(QString("SHADOW_MAX_CASCADES %1").arg(SHADOW_MAX_CASCADES));
+
+    defines.append(QString("ATTRIB_VERTEX %1").arg(ATTRIB_VERTEX));
+    defines.append(QString("ATTRIB_NORMAL %1").arg(ATTRIB_NORMAL));
+    defines.append(QString("ATTRIB_TEXCOORD %1").arg(ATTRIB_TEXCOORD));
+    defines.append(QString("ATTRIB_TANGENT %1").arg(ATTRIB_TANGENT));
+    defines.append(QString("ATTRIB_INSTANCE_MODEL_MATRIX %1").arg(ATTRIB_INSTANCE_MODEL_MATRIX));
+    defines.append(QString("ATTRIB_INSTANCE_NORMAL_MATRIX %1")
+                   .arg(ATTRIB_INSTANCE_NORMAL_MATRIX));
+    defines.append(QString("ATTRIB_INSTANCE_MATERIAL %1").arg(ATTRIB_INSTANCE_MATERIAL));
+
+    return defines;
+}
+
+//------------------------------------------------------------------------------------------
+// only the uber-shader computes the tangent frames of the normal maps per triangle, the
+// variants without normal map do not need them at all
+//------------------------------------------------------------------------------------------
+bool Renderer::hasGeometryStage(ShadingProgram _shadingMode, int _features)
+{
+    return geometryShaderSourceMap.contains(_shadingMode) &&
+           (_features & FEATURE_TANGENT) && !(_features & FEATURE_VERTEX_TANGENT);
+}
+
+//------------------------------------------------------------------------------------------
+// build the program variant if it is not cached yet, without waiting for it
+//------------------------------------------------------------------------------------------
+QOpenGLShaderProgram* Renderer::compileProgramVariant(ShadingProgram _shadingMode,
+                                                      int _features)
+{
+    if(programVariants[_shadingMode].contains(_features))
+    {
+        return programVariants[_shadingMode].value(_features);
+    }
+
+    QMap<GLenum, QString> shaderFiles;
+    shaderFiles.insert(GL_VERTEX_SHADER, vertexShaderSourceMap.value(_shadingMode));
+    shaderFiles.insert(GL_FRAGMENT_SHADER, fragmentShaderSourceMap.value(_shadingMode));
+
+    if(hasGeometryStage(_shadingMode, _features))
+    {
+        shaderFiles.insert(GL_GEOMETRY_SHADER, geometryShaderSourceMap.value(_shadingMode));
+    }
+
+    QOpenGLShaderProgram* program = shaderCompiler.beginCompile(shaderFiles,
+                                                                getShaderDefines(_features));
+
+    if(program)
+    {
+        programVariants[_shadingMode].insert(_features, program);
+    }
+
+    return program;
+}
+
+//------------------------------------------------------------------------------------------
+// switch to the program variants matching the current state as soon as they finished
+// compiling, they all share the vertex array object of the mesh pool
+//------------------------------------------------------------------------------------------
+bool Renderer::updateShaderPrograms(bool _waitForCompletion)
+{
+    bool success = true;
+
+    for(int i = 0; i < NUM_PROGRAMS; ++i)
+    {
+        ShadingProgram shadingMode = static_cast<ShadingProgram>(i);
+        int features = getShaderFeatures(shadingMode);
+
+        if(programReady[i] && programFeatures[i] == features)
+        {
+            continue;
+        }
+
+        QOpenGLShaderProgram* program = compileProgramVariant(shadingMode, features);
+        TRUE_OR_DIE(program, "Cannot create GLSL program.");
+
+        // keep rendering with the previous variant until the new one is ready
+        if(!_waitForCompletion && !shaderCompiler.isProgramReady(program))
+        {
+            continue;
+        }
+
+        TRUE_OR_DIE(shaderCompiler.finishCompile(program),
+                    "Cannot compile GLSL program.");
+
+        glslPrograms[i] = program;
+        programFeatures[i] = features;
+
+        switch(i)
+        {
+        case PhongShading:
+            success = success && initPhongShadingProgram();
+            break;
+
+        case ToonShading:
+            success = success && initToonShadingProgram();
+            break;
+
+        case ProgramRenderSilhouette:
+            success = success && initRenderSilhouetteProgram();
+            break;
+
+        case ProgramDepthPrepass:
+            success = success && initDepthPrepassProgram();
+            break;
 
+        default:
+            break;
+        }
+
+        programReady[i] = true;
+    }
 
-    return (initRenderSilhouetteProgram() &&
-            initToonShadingProgram() &&
-            initPhongShadingProgram());
+    return success;
 }
 
 //------------------------------------------------------------------------------------------
@@ -386,19 +596,66 @@ void Renderer::initSharedBlockUniform()
     glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
     glGenBuffers(1, &UBOMeshObjectMaterial);
-    glBindBuffer(GL_UNIFORM_BUFFER, UBOMeshObjectMaterial);
-    glBufferData(GL_UNIFORM_BUFFER, meshObjectMaterial.getStructSize(),
-                 &meshObjectMaterial, GL_STREAM_DRAW);
+    uploadMeshObjectMaterials();
+
+    // no cascade until the first shadow map update
+    glGenBuffers(1, &UBOShadow);
+    glBindBuffer(GL_UNIFORM_BUFFER, UBOShadow);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(ShadowCascadeData), &shadowMap.getCascadeData(),
+                 GL_STREAM_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    // the Matrices block of the shadow pass, only its view-projection matrix is used
+    glGenBuffers(1, &UBOShadowMatrices);
+    glBindBuffer(GL_UNIFORM_BUFFER, UBOShadowMatrices);
+    glBufferData(GL_UNIFORM_BUFFER, 4 * SIZE_OF_MAT4, NULL, GL_STREAM_DRAW);
     glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+//------------------------------------------------------------------------------------------
+// the first material is the one set from the GUI, the other ones vary its diffuse color
+//------------------------------------------------------------------------------------------
+void Renderer::uploadMeshObjectMaterials()
+{
+    QVector<Material> materials(NUM_MESH_OBJECT_MATERIALS, meshObjectMaterial);
+
+    for(int i = 1; i < NUM_MESH_OBJECT_MATERIALS; ++i)
+    {
+        QColor color = QColor::fromHsvF((qreal)(i - 1) / (NUM_MESH_OBJECT_MATERIALS - 1),
+                                        0.6, 0.9);
+        materials[i].setDiffuse(QVector4D(color.redF(), color.greenF(), color.blueF(), 1.0f));
+    }
 
+    // the std140 array stride matches the struct size, a multiple of vec4
+    glBindBuffer(GL_UNIFORM_BUFFER, UBOMeshObjectMaterial);
+    glBufferData(GL_UNIFORM_BUFFER, NUM_MESH_OBJECT_MATERIALS * meshObjectMaterial.getStructSize(),
+                 materials.constData(), GL_STREAM_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
 }
 
 //------------------------------------------------------------------------------------------
 void Renderer::initTexture()
 {
+    TRACE_SCOPE("initTexture");
+
+    textureLoader.initialize();
 
     ////////////////////////////////////////////////////////////////////////////////
-    // mesh object texture
+    // all the metal textures have the same size, thus they share two texture arrays
+    // (color, normal) whose layers are loaded in the background on first use
+    QSize textureSize = QImageReader(QString(":/textures/metals/%1-ColorMap.png").
+                                     arg(strListMeshObjectTexture->at(0))).size();
+    TRUE_OR_DIE(textureSize.isValid(), "Cannot load texture from file.");
+
+    colorTextureArrayID = textureLoader.addTextureArray(textureSize,
+                                                        TextureCache::COMPRESSION_COLOR_BC1,
+                                                        TEXTURE_MEMORY_BUDGET / 2,
+                                                        NumMetalTextures);
+    normalTextureArrayID = textureLoader.addTextureArray(textureSize,
+                                                         TextureCache::COMPRESSION_NORMAL_BC5,
+                                                         TEXTURE_MEMORY_BUDGET / 2,
+                                                         NumMetalTextures);
+
     for(int tex = 0; tex < NumMetalTextures; ++tex)
     {
         QString normalTexFile = QString(":/textures/metals/%1-NormalMap.png").
@@ -408,21 +665,84 @@ void Renderer::initTexture()
                        arg(strListMeshObjectTexture->at(tex));
         TRUE_OR_DIE(QFile::exists(colorTexFile), "Cannot load texture from file.");
 
-        normalMapsMeshObject[tex] = new QOpenGLTexture(QImage(normalTexFile).mirrored());
-        normalMapsMeshObject[tex]->setMinificationFilter(QOpenGLTexture::LinearMipMapLinear);
-        normalMapsMeshObject[tex]->setMagnificationFilter(QOpenGLTexture::LinearMipMapLinear);
-        normalMapsMeshObject[tex]->setWrapMode(QOpenGLTexture::Repeat);
+        normalMapIDs[tex] = textureLoader.addTexture(normalTexFile, normalTextureArrayID);
+        colorMapIDs[tex] = textureLoader.addTexture(colorTexFile, colorTextureArrayID);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// the metal textures are only sampled by the Phong shading
+//------------------------------------------------------------------------------------------
+void Renderer::updateMeshObjectTextures(bool _waitForUpload)
+{
+    textureLoader.beginFrame();
+
+    if(currentShadingMode == PhongShading)
+    {
+        textureLoader.useTexture(colorMapIDs[currentMeshObjectTexture]);
+        textureLoader.useTexture(normalMapIDs[currentMeshObjectTexture]);
+    }
+
+    textureLoader.uploadFinishedTextures(_waitForUpload);
 
-        colorMapsMeshObject[tex] = new QOpenGLTexture(QImage(colorTexFile).mirrored());
-        colorMapsMeshObject[tex]->setMinificationFilter(QOpenGLTexture::LinearMipMapLinear);
-        colorMapsMeshObject[tex]->setMagnificationFilter(QOpenGLTexture::LinearMipMapLinear);
-        colorMapsMeshObject[tex]->setWrapMode(QOpenGLTexture::Repeat);
+    /////////////////////////////////////////////////////////////////
+    // switching the texture is only a material change
+    GLint colorLayer = textureLoader.getTextureLayer(colorMapIDs[currentMeshObjectTexture]);
+    GLint normalLayer = textureLoader.getTextureLayer(normalMapIDs[currentMeshObjectTexture]);
+
+    if(colorLayer != meshObjectMaterial.colorLayer ||
+       normalLayer != meshObjectMaterial.normalLayer)
+    {
+        meshObjectMaterial.colorLayer = colorLayer;
+        meshObjectMaterial.normalLayer = normalLayer;
+        uploadMeshObjectMaterials();
+    }
+}
+
+//------------------------------------------------------------------------------------------
+bool Renderer::isMeshObjectTextureReady()
+{
+    return (meshObjectMaterial.colorLayer >= 0 && meshObjectMaterial.normalLayer >= 0);
+}
+
+//------------------------------------------------------------------------------------------
+void Renderer::initToonRampTextures()
+{
+    toonDiffuseRampTexture = new QOpenGLTexture(QOpenGLTexture::Target1D);
+    toonSpecularRampTexture = new QOpenGLTexture(QOpenGLTexture::Target1D);
+
+    QOpenGLTexture* rampTextures[2] = {toonDiffuseRampTexture, toonSpecularRampTexture};
+
+    for(int i = 0; i < 2; ++i)
+    {
+        rampTextures[i]->setSize(TOON_RAMP_RESOLUTION);
+        rampTextures[i]->setFormat(QOpenGLTexture::R8_UNorm);
+        rampTextures[i]->allocateStorage();
+        rampTextures[i]->setMinificationFilter(QOpenGLTexture::Nearest);
+        rampTextures[i]->setMagnificationFilter(QOpenGLTexture::Nearest);
+        rampTextures[i]->setWrapMode(QOpenGLTexture::ClampToEdge);
     }
+
+    uploadToonRamp(toonDiffuseRampTexture, toonDiffuseRamp);
+    uploadToonRamp(toonSpecularRampTexture, toonSpecularRamp);
+}
+
+//------------------------------------------------------------------------------------------
+void Renderer::uploadToonRamp(QOpenGLTexture* _rampTexture, ToonRamp& _ramp)
+{
+    QVector<GLubyte> ramp = _ramp.generateRamp(TOON_RAMP_RESOLUTION);
+    _rampTexture->setData(QOpenGLTexture::Red, QOpenGLTexture::UInt8, ramp.constData());
 }
 
 //------------------------------------------------------------------------------------------
 void Renderer::initSceneMemory()
 {
+    // referenced by the vertex array object, allocated once the scene objects are known
+    vboMeshObjectInstances.create();
+    vboMeshObjectInstances.setUsagePattern(QOpenGLBuffer::StreamDraw);
+    vboShadowCasterInstances.create();
+    vboShadowCasterInstances.setUsagePattern(QOpenGLBuffer::DynamicDraw);
+
     initMeshObjectMemory();
 }
 
@@ -434,45 +754,90 @@ void Renderer::initMeshObjectMemory()
         objLoader = new OBJLoader;
     }
 
-    bool result = false;
+    // the meshes are registered in the order of MeshObject, and only loaded once shown
+    const char* objFiles[FIRST_STRESS_MESH_OBJECT] = {":/obj/teapot.obj", ":/obj/bunny.obj"};
+    meshPool.initialize();
+    meshPool.clear();
 
-    switch (currentMeshObject)
+    for(int i = 0; i < NUM_MESH_OBJECT; ++i)
     {
-    case TEAPOT_OBJ:
-        result = objLoader->loadObjFile(":/obj/teapot.obj");
-        break;
+        if(i < FIRST_STRESS_MESH_OBJECT)
+        {
+            meshPool.addMesh(objFiles[i]);
+        }
+        else
+        {
+            StressMeshType type = (StressMeshType)(i - FIRST_STRESS_MESH_OBJECT);
+            meshPool.addMesh(MeshPool::getStressMeshAssetPath(type, stressMeshLevels[type]));
+        }
+    }
 
-    case BUNNY_OBJ:
-        result = objLoader->loadObjFile(":/obj/bunny.obj");
-        break;
+    makeMeshObjectResident(currentMeshObject);
+}
 
-    default:
-        break;
+//------------------------------------------------------------------------------------------
+// a cached mesh only refreshes its use, a new one is loaded and may evict others; the
+// vertex array objects follow the buffers if they had to grow
+//------------------------------------------------------------------------------------------
+bool Renderer::makeMeshObjectResident(MeshObject _meshObject)
+{
+    if(!meshPool.makeResident(_meshObject, objLoader))
+    {
+        QMessageBox::critical(NULL, "Error", "Could not load mesh object " +
+                              getMeshObjectName(_meshObject) + "!");
+        return false;
     }
 
-    if(!result)
+    if(meshPool.hasGeometry(_meshObject))
     {
-        QMessageBox::critical(NULL, "Error", "Could not load OBJ file!");
-        return;
+        const MeshRange& range = meshPool.getMeshRange(_meshObject);
+        const GeometryBuffer& geometry = meshPool.getGeometry(_meshObject);
+        occlusionCuller.setOccluderMesh(_meshObject, geometry.getAttribute(POSITION_ATTRIBUTE),
+                                        range.numVertices,
+                                        (const GLuint*) geometry.getIndices(),
+                                        range.indexCount, range.bounds);
+
+        // the GPU has the only copy of the mesh from here
+        meshPool.releaseGeometry();
+
+        if(gpuCuller.isInitialized())
+        {
+            gpuCuller.setMeshes(meshPool);
+        }
     }
 
-    if(vboMeshObject.isCreated())
+    if(meshBufferGeneration != meshPool.getBufferGeneration())
     {
-        vboMeshObject.destroy();
+        meshBufferGeneration = meshPool.getBufferGeneration();
+        initVertexArrayObjects();
     }
 
-    ////////////////////////////////////////////////////////////////////////////////
-    // init memory for sphere
-    vboMeshObject.create();
-    vboMeshObject.bind();
-    vboMeshObject.allocate(2 * objLoader->getVertexOffset() +
-                           objLoader->getTexCoordOffset());
-    vboMeshObject.write(0, objLoader->getVertices(), objLoader->getVertexOffset());
-    vboMeshObject.write(objLoader->getVertexOffset(), objLoader->getNormals(),
-                        objLoader->getVertexOffset());
-    vboMeshObject.write(2 * objLoader->getVertexOffset(), objLoader->getTexureCoordinates(),
-                        objLoader->getTexCoordOffset());
-    vboMeshObject.release();
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+// the compute shader culling path needs OpenGL 4.3, the CPU culling path is the fallback
+//------------------------------------------------------------------------------------------
+void Renderer::initGpuCulling()
+{
+    gpuCullingSupported = gpuCuller.initialize();
+
+    if(gpuCullingSupported)
+    {
+        gpuCuller.setMeshes(meshPool);
+    }
+
+    useGpuCulling = gpuCullingSupported;
+    qDebug() << "Culling:" << (useGpuCulling ? "GPU (compute + multi-draw indirect)" : "CPU");
+}
+
+//------------------------------------------------------------------------------------------
+// one pass per shading program, in the order of ShadingProgram, then the shadow map
+//------------------------------------------------------------------------------------------
+void Renderer::initGpuProfiler()
+{
+    gpuProfiler.initialize(QStringList() << "Phong" << "Toon" << "Silhouette" <<
+                           "Depth prepass" << "Shadow map");
 }
 
 //------------------------------------------------------------------------------------------
@@ -480,47 +845,78 @@ void Renderer::initMeshObjectMemory()
 //------------------------------------------------------------------------------------------
 void Renderer::initVertexArrayObjects()
 {
-    initMeshObjectVAO(PhongShading);
-    initMeshObjectVAO(ToonShading);
-    initMeshObjectVAO(ProgramRenderSilhouette);
+    initMeshObjectVAO(vaoMeshObject, vboMeshObjectInstances);
+    initMeshObjectVAO(vaoShadowCasters, vboShadowCasterInstances);
 }
 
 //------------------------------------------------------------------------------------------
-void Renderer::initMeshObjectVAO(ShadingProgram _shadingMode)
+// all programs read the mesh pool format at the same attribute locations, so the VAO does
+// not depend on them and is only rebuilt when the mesh buffers are recreated; the
+// attributes a program variant does not declare are simply not fetched; the instances are
+// read from the given buffer
+//------------------------------------------------------------------------------------------
+void Renderer::initMeshObjectVAO(QOpenGLVertexArrayObject& _vao,
+                                 QOpenGLBuffer& _instanceBuffer)
 {
-    if(vaoMeshObject[_shadingMode].isCreated())
+    if(_vao.isCreated())
     {
-        vaoMeshObject[_shadingMode].destroy();
+        _vao.destroy();
     }
 
-    QOpenGLShaderProgram* program = glslPrograms[_shadingMode];
+    _vao.create();
+    _vao.bind();
 
-    vaoMeshObject[_shadingMode].create();
-    vaoMeshObject[_shadingMode].bind();
+    meshPool.getVertexBuffer().bind();
+    meshPool.getIndexBuffer().bind();
 
-    vboMeshObject.bind();
-    program->enableAttributeArray(attrVertex[_shadingMode]);
-    program->setAttributeBuffer(attrVertex[_shadingMode], GL_FLOAT, 0, 3);
+    glEnableVertexAttribArray(ATTRIB_VERTEX);
+    glVertexAttribPointer(ATTRIB_VERTEX, 3, GL_FLOAT, GL_FALSE, 0, (const GLvoid*) 0);
 
-    if(_shadingMode == PhongShading || _shadingMode == ToonShading
-       || _shadingMode == ProgramRenderSilhouette)
-    {
-        program->enableAttributeArray(attrNormal[_shadingMode]);
-        program->setAttributeBuffer(attrNormal[_shadingMode], GL_FLOAT,
-                                    objLoader->getVertexOffset(), 3);
-    }
+    glEnableVertexAttribArray(ATTRIB_NORMAL);
+    glVertexAttribPointer(ATTRIB_NORMAL, 3, GL_FLOAT, GL_FALSE, 0,
+                          (const GLvoid*)(qintptr) meshPool.getNormalOffset());
 
-    if(_shadingMode == PhongShading)
-    {
-        program->enableAttributeArray(attrTexCoord[_shadingMode]);
-        program->setAttributeBuffer(attrTexCoord[_shadingMode], GL_FLOAT,
-                                    2 * objLoader->getVertexOffset(), 2);
-    }
+    glEnableVertexAttribArray(ATTRIB_TEXCOORD);
+    glVertexAttribPointer(ATTRIB_TEXCOORD, 2, GL_FLOAT, GL_FALSE, 0,
+                          (const GLvoid*)(qintptr) meshPool.getTexCoordOffset());
 
+    glEnableVertexAttribArray(ATTRIB_TANGENT);
+    glVertexAttribPointer(ATTRIB_TANGENT, 4, GL_FLOAT, GL_FALSE, 0,
+                          (const GLvoid*)(qintptr) meshPool.getTangentOffset());
+
+    /////////////////////////////////////////////////////////////////
+    // per-instance attributes, a matrix takes one location per column
+    _instanceBuffer.bind();
+
+    for(int column = 0; column < 4; ++column)
+    {
+        GLuint location = ATTRIB_INSTANCE_MODEL_MATRIX + column;
+        glEnableVertexAttribArray(location);
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                              (const GLvoid*)(offsetof(InstanceData, modelMatrix) +
+                                              4 * column * sizeof(GLfloat)));
+        glVertexAttribDivisor(location, 1);
+    }
+
+    for(int column = 0; column < 3; ++column)
+    {
+        GLuint location = ATTRIB_INSTANCE_NORMAL_MATRIX + column;
+        glEnableVertexAttribArray(location);
+        glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                              (const GLvoid*)(offsetof(InstanceData, normalMatrix) +
+                                              3 * column * sizeof(GLfloat)));
+        glVertexAttribDivisor(location, 1);
+    }
+
+    glEnableVertexAttribArray(ATTRIB_INSTANCE_MATERIAL);
+    glVertexAttribIPointer(ATTRIB_INSTANCE_MATERIAL, 1, GL_INT, sizeof(InstanceData),
+                           (const GLvoid*) offsetof(InstanceData, materialIndex));
+    glVertexAttribDivisor(ATTRIB_INSTANCE_MATERIAL, 1);
 
     // release vao before vbo and ibo
-    vaoMeshObject[_shadingMode].release();
-    vboMeshObject.release();
+    _vao.release();
+    _instanceBuffer.release();
+    meshPool.getIndexBuffer().release();
 }
 
 //------------------------------------------------------------------------------------------
@@ -528,16 +924,17 @@ void Renderer::initSceneMatrices()
 {
     /////////////////////////////////////////////////////////////////
     // mesh object
-    TRUE_OR_DIE(objLoader, "OBJLoader must be initialized first");
+    TRUE_OR_DIE(meshPool.getNumMeshes() == NUM_MESH_OBJECT, "Meshes must be loaded first");
+    const MeshRange& meshRange = meshPool.getMeshRange(currentMeshObject);
     meshObjectModelMatrix.setToIdentity();
     meshObjectModelMatrix.translate(DEFAULT_MESH_OBJECT_POSITION);
     meshObjectModelMatrix.scale(3.0f);
 
     if(currentMeshObject != TEAPOT_OBJ)
-        meshObjectModelMatrix.translate(QVector3D(0, -2.0f * objLoader->getLowestYCoordinate(),
+        meshObjectModelMatrix.translate(QVector3D(0, -2.0f * meshRange.lowestYCoordinate,
                                                   0));
 
-    meshObjectModelMatrix.scale(2.0f / objLoader->getScalingFactor());
+    meshObjectModelMatrix.scale(2.0f / meshRange.scalingFactor);
 
     if(currentMeshObject == TEAPOT_OBJ)
     {
@@ -546,12 +943,254 @@ void Renderer::initSceneMatrices()
 
     meshObjectNormalMatrix = QMatrix4x4(meshObjectModelMatrix.normalMatrix());
 
+    initSceneObjects();
+}
+
+//------------------------------------------------------------------------------------------
+// all objects share the current mesh, the first one stays at the mesh object position
+// and the others fill a grid behind it
+//------------------------------------------------------------------------------------------
+void Renderer::initSceneObjects()
+{
+    scene.clear();
+
+    for(int i = 0; i < meshPool.getNumMeshes(); ++i)
+    {
+        scene.setMeshBounds(i, meshPool.getMeshRange(i).bounds);
+    }
+
+    float time = (float) sceneTimer.elapsed() * 1e-3f;
+
+    for(int i = 0; i < numSceneObjects; ++i)
+    {
+        scene.addObject(getSceneObjectTransform(i, time), currentMeshObject,
+                        i % NUM_MESH_OBJECT_MATERIALS);
+    }
+
+    int instanceCapacity = numSceneObjects;
+
+    if(gpuCullingSupported)
+    {
+        gpuCuller.uploadObjects(scene);
+        instanceCapacity = qMax(instanceCapacity, gpuCuller.getInstanceCapacity());
+    }
+
+    // the buffer object stays the same, the vertex array objects remain valid
+    vboMeshObjectInstances.bind();
+    vboMeshObjectInstances.allocate(instanceCapacity * sizeof(InstanceData));
+    vboMeshObjectInstances.release();
+
+    visibleObjects.reserve(numSceneObjects);
+    smallVisibleObjects.reserve(numSceneObjects);
+    visibleInstances.reserve(numSceneObjects);
+    numVisibleObjects = 0;
+    shadowCastersChanged = true;
+}
+
+//------------------------------------------------------------------------------------------
+QMatrix4x4 Renderer::getSceneObjectTransform(int _objectIndex, float _time)
+{
+    int gridSize = (int) ceil(sqrt((double) numSceneObjects));
+    int row = _objectIndex / gridSize;
+    int column = _objectIndex % gridSize;
+    float x = INSTANCE_SPACING * ((column + 1) / 2) * ((column & 1) ? 1.0f : -1.0f);
+    float y = 0.0f;
+
+    if(animateSceneObjects && _objectIndex > 0)
+    {
+        y = 2.0f * sin(_time * 2.0f + 0.7f * _objectIndex);
+    }
+
+    QMatrix4x4 transform;
+    transform.translate(x, y, -INSTANCE_SPACING * row);
+    transform *= meshObjectModelMatrix;
+
+    return transform;
+}
+
+//------------------------------------------------------------------------------------------
+// move the animated objects, cull the scene against the camera and stream the visible
+// objects into the instance buffer
+//------------------------------------------------------------------------------------------
+void Renderer::updateSceneObjects()
+{
+    if(animateSceneObjects)
+    {
+        float time = (float) sceneTimer.elapsed() * 1e-3f;
+
+        for(int i = 1; i < scene.getNumObjects(); ++i)
+        {
+            scene.setObjectTransform(i, getSceneObjectTransform(i, time));
+        }
+
+        if(gpuCullingSupported)
+        {
+            gpuCuller.uploadObjects(scene);
+        }
+
+        shadowCastersChanged = true;
+    }
+
+    if(useGpuCulling)
+    {
+        // the occlusion culling runs on the CPU, the compute shader skips what it hides
+        if(enabledOcclusionCulling)
+        {
+            scene.cull(viewProjectionMatrix, visibleObjects);
+            occlusionCuller.cull(scene, viewProjectionMatrix, cameraPosition, visibleObjects);
+            gpuCuller.setObjectVisibility(visibleObjects);
+        }
+        else
+        {
+            gpuCuller.clearObjectVisibility();
+        }
+
+        // the instances and draw commands are written by the compute shader
+        gpuCuller.cull(viewProjectionMatrix, cameraPosition,
+                       vboMeshObjectInstances.bufferId());
+        emitGpuCullingStats();
+        return;
+    }
+
+    scene.cull(viewProjectionMatrix, visibleObjects);
+
+    if(enabledOcclusionCulling)
+    {
+        occlusionCuller.cull(scene, viewProjectionMatrix, cameraPosition, visibleObjects);
+    }
+
+    sortDepthPrepassObjects();
+    numVisibleObjects = visibleObjects.size();
+    visibleInstances.resize(numVisibleObjects);
+
+    for(int i = 0; i < numVisibleObjects; ++i)
+    {
+        const SceneObject& object = scene.getObject(visibleObjects[i]);
+        QMatrix3x3 normalMatrix = object.transform.normalMatrix();
+
+        memcpy(visibleInstances[i].modelMatrix, object.transform.constData(), SIZE_OF_MAT4);
+        memcpy(visibleInstances[i].normalMatrix, normalMatrix.constData(),
+               9 * sizeof(GLfloat));
+        visibleInstances[i].materialIndex = object.materialIndex;
+    }
+
+    if(numVisibleObjects > 0)
+    {
+        vboMeshObjectInstances.bind();
+        vboMeshObjectInstances.write(0, visibleInstances.constData(),
+                                     numVisibleObjects * sizeof(InstanceData));
+        vboMeshObjectInstances.release();
+    }
+
+    /////////////////////////////////////////////////////////////////
+    // report the culling stats a few times per second
+    qint64 currentTime = sceneTimer.elapsed();
+
+    if(currentTime - lastSceneStatsTime >= SCENE_STATS_INTERVAL)
+    {
+        lastSceneStatsTime = currentTime;
+        const CullingStats& stats = scene.getCullingStats();
+
+        emit sceneStatsChanged(QString("Visible: %1/%2, culled: %3, nodes tested: %4, "
+                                       "reinserted: %5, cull time: %6 us, depth pre-pass: %7")
+                               .arg(numVisibleObjects)
+                               .arg(stats.numObjects)
+                               .arg(stats.numObjects - numVisibleObjects)
+                               .arg(stats.numNodesTested)
+                               .arg(stats.numReinserted)
+                               .arg((double) stats.cullTimeNs * 1e-3, 0, 'f', 1)
+                               .arg(numDepthPrepassObjects) +
+                               getOcclusionStatsString() + getMeshCacheStatsString() +
+                               getShadowStatsString());
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// reading back the visible count waits for the culling, so only when the stats are shown
+//------------------------------------------------------------------------------------------
+void Renderer::emitGpuCullingStats()
+{
+    qint64 currentTime = sceneTimer.elapsed();
+
+    if(currentTime - lastSceneStatsTime < SCENE_STATS_INTERVAL)
+    {
+        return;
+    }
+
+    lastSceneStatsTime = currentTime;
+    numVisibleObjects = gpuCuller.readNumVisibleObjects();
+
+    emit sceneStatsChanged(QString("GPU culling, visible: %1/%2, culled: %3, "
+                                   "cull time: %4 us")
+                           .arg(numVisibleObjects)
+                           .arg(numSceneObjects)
+                           .arg(numSceneObjects - numVisibleObjects)
+                           .arg((double) gpuCuller.getCullTimeNs() * 1e-3, 0, 'f', 1) +
+                           getOcclusionStatsString() + getMeshCacheStatsString() +
+                           getShadowStatsString());
+}
+
+//------------------------------------------------------------------------------------------
+QString Renderer::getOcclusionStatsString()
+{
+    if(!enabledOcclusionCulling)
+    {
+        return QString();
+    }
+
+    const OcclusionStats& stats = occlusionCuller.getStats();
+    double occludedRate = (stats.numTested > 0) ?
+                          100.0 * stats.numOccluded / stats.numTested : 0.0;
+
+    return QString("\nOcclusion: %1 occluders (%2 triangles), occluded: %3/%4 (%5%), "
+                   "raster: %6 us, test: %7 us")
+           .arg(stats.numOccluders)
+           .arg(stats.numOccluderTriangles)
+           .arg(stats.numOccluded)
+           .arg(stats.numTested)
+           .arg(occludedRate, 0, 'f', 1)
+           .arg((double) stats.rasterTimeNs * 1e-3, 0, 'f', 1)
+           .arg((double) stats.testTimeNs * 1e-3, 0, 'f', 1);
+}
+
+//------------------------------------------------------------------------------------------
+QString Renderer::getMeshCacheStatsString()
+{
+    const MeshPoolStats& stats = meshPool.getStats();
+
+    return QString("\nMesh cache: %1 resident, %2 MB in use, %3/%4 MB allocated, hits: %5, "
+                   "misses: %6, evictions: %7")
+           .arg(stats.numResidentMeshes)
+           .arg((double) stats.bytesInUse / 1048576.0, 0, 'f', 1)
+           .arg((double) stats.capacityBytes / 1048576.0, 0, 'f', 1)
+           .arg((double) meshPool.getBudget() / 1048576.0, 0, 'f', 1)
+           .arg(stats.numHits)
+           .arg(stats.numMisses)
+           .arg(stats.numEvictions);
+}
+
+//------------------------------------------------------------------------------------------
+QString Renderer::getShadowStatsString()
+{
+    if(shadowMap.getNumCascades() == 0)
+    {
+        return QString();
+    }
+
+    const ShadowStats& stats = shadowMap.getStats();
+
+    return QString("\nShadows: %1 cascade(s), rendered: %2, cached frames: %3/%4")
+           .arg(shadowMap.getNumCascades())
+           .arg(stats.numRenderedCascades)
+           .arg(stats.numCachedUpdates)
+           .arg(stats.numUpdates);
 }
 
 //------------------------------------------------------------------------------------------
 void Renderer::setAmbientLightIntensity(int _ambientLight)
 {
     ambientLight = (float) _ambientLight / 100.0f;
+    update();
 }
 
 //------------------------------------------------------------------------------------------
@@ -583,12 +1222,7 @@ void Renderer::setObjectsSpecularReflection(int _intensity)
     makeCurrent();
     float specular = (float) _intensity / 100.0f;
     meshObjectMaterial.setSpecular(QVector4D(specular, specular, specular, 1.0f));
-
-    glBindBuffer(GL_UNIFORM_BUFFER, UBOMeshObjectMaterial);
-    glBufferData(GL_UNIFORM_BUFFER, meshObjectMaterial.getStructSize(),
-                 &meshObjectMaterial, GL_STREAM_DRAW);
-
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    uploadMeshObjectMaterials();
     doneCurrent();
     update();
 }
@@ -596,6 +1230,8 @@ void Renderer::setObjectsSpecularReflection(int _intensity)
 //------------------------------------------------------------------------------------------
 void Renderer::setMeshObject(int _objectIndex)
 {
+    TRACE_SCOPE("setMeshObject");
+
     if(!isValid())
     {
         return;
@@ -606,34 +1242,19 @@ void Renderer::setMeshObject(int _objectIndex)
         return;
     }
 
-    currentMeshObject = static_cast<MeshObject>(_objectIndex);
+    // a resident mesh is already in the shared buffers, only the objects change
     makeCurrent();
-    initMeshObjectMemory();
-    initMeshObjectVAO(PhongShading);
-    initMeshObjectVAO(ToonShading);
-    initMeshObjectVAO(ProgramRenderSilhouette);
-
-    /////////////////////////////////////////////////////////////////
-    // mesh object
-    TRUE_OR_DIE(objLoader, "OBJLoader must be initialized first");
-    meshObjectModelMatrix.setToIdentity();
-    meshObjectModelMatrix.translate(DEFAULT_MESH_OBJECT_POSITION);
-    meshObjectModelMatrix.scale(3.0f);
 
-    if(currentMeshObject != TEAPOT_OBJ)
-        meshObjectModelMatrix.translate(QVector3D(0, -2.0f * objLoader->getLowestYCoordinate(),
-                                                  0));
-
-    meshObjectModelMatrix.scale(2.0f / objLoader->getScalingFactor());
-
-    if(currentMeshObject == TEAPOT_OBJ)
+    if(!makeMeshObjectResident(static_cast<MeshObject>(_objectIndex)))
     {
-        meshObjectModelMatrix.rotate(-90, 1, 0, 0);
+        doneCurrent();
+        return;
     }
 
-    meshObjectNormalMatrix = QMatrix4x4(meshObjectModelMatrix.normalMatrix());
-
+    currentMeshObject = static_cast<MeshObject>(_objectIndex);
+    initSceneMatrices();
     doneCurrent();
+    update();
 }
 
 //------------------------------------------------------------------------------------------
@@ -652,22 +1273,121 @@ void Renderer::setMeshObjectColor(float _r, float _g, float _b)
 
     meshObjectMaterial.setDiffuse(QVector4D(_r, _g, _b, 1.0f));
     makeCurrent();
-    glBindBuffer(GL_UNIFORM_BUFFER, UBOMeshObjectMaterial);
-    glBufferData(GL_UNIFORM_BUFFER, meshObjectMaterial.getStructSize(),
-                 &meshObjectMaterial, GL_STREAM_DRAW);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    uploadMeshObjectMaterials();
     doneCurrent();
+    update();
 }
 
 //------------------------------------------------------------------------------------------
 void Renderer::setMeshObjectTexture(int _texture)
 {
     currentMeshObjectTexture = _texture;
+    update();
+}
+
+//------------------------------------------------------------------------------------------
+void Renderer::setNumSceneObjects(int _numObjects)
+{
+    numSceneObjects = qBound(1, _numObjects, MAX_INSTANCES);
+
+    if(!isValid() || !initializedScene)
+    {
+        return;
+    }
+
+    makeCurrent();
+    initSceneObjects();
+    doneCurrent();
+    update();
+}
+
+//------------------------------------------------------------------------------------------
+int Renderer::getNumSceneObjects()
+{
+    return numSceneObjects;
+}
+
+//------------------------------------------------------------------------------------------
+void Renderer::enableAnimateSceneObjects(bool _state)
+{
+    animateSceneObjects = _state;
+
+    // put the objects back at rest
+    if(!animateSceneObjects && isValid() && initializedScene)
+    {
+        for(int i = 1; i < scene.getNumObjects(); ++i)
+        {
+            scene.setObjectTransform(i, getSceneObjectTransform(i, 0.0f));
+        }
+
+        shadowCastersChanged = true;
+
+        if(gpuCullingSupported)
+        {
+            makeCurrent();
+            gpuCuller.uploadObjects(scene);
+            doneCurrent();
+        }
+    }
+
+    update();
+}
+
+//------------------------------------------------------------------------------------------
+QString Renderer::getToonDiffuseBands()
+{
+    return toonDiffuseRamp.getBandString();
+}
+
+//------------------------------------------------------------------------------------------
+QString Renderer::getToonSpecularBands()
+{
+    return toonSpecularRamp.getBandString();
+}
+
+//------------------------------------------------------------------------------------------
+bool Renderer::setToonDiffuseBands(const QString& _bands)
+{
+    if(!toonDiffuseRamp.setBands(_bands))
+    {
+        return false;
+    }
+
+    if(isValid() && toonDiffuseRampTexture)
+    {
+        makeCurrent();
+        uploadToonRamp(toonDiffuseRampTexture, toonDiffuseRamp);
+        doneCurrent();
+        update();
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+bool Renderer::setToonSpecularBands(const QString& _bands)
+{
+    if(!toonSpecularRamp.setBands(_bands))
+    {
+        return false;
+    }
+
+    if(isValid() && toonSpecularRampTexture)
+    {
+        makeCurrent();
+        uploadToonRamp(toonSpecularRampTexture, toonSpecularRamp);
+        doneCurrent();
+        update();
+    }
+
+    return true;
 }
 
 //------------------------------------------------------------------------------------------
 void Renderer::updateCamera()
 {
+    TRACE_SCOPE("updateCamera");
+
     zoomCamera();
 
     /////////////////////////////////////////////////////////////////
@@ -698,6 +1418,7 @@ QSize Renderer::minimumSizeHint() const
 //------------------------------------------------------------------------------------------
 void Renderer::initializeGL()
 {
+    startupTimer.start();
     initializeOpenGLFunctions();
     checkOpenGLVersion();
 
@@ -718,19 +1439,55 @@ void Renderer::resizeGL(int w, int h)
 //------------------------------------------------------------------------------------------
 void Renderer::paintGL()
 {
+    TRACE_SCOPE("paintGL");
+
     if(!initializedScene)
     {
         return;
     }
 
+    updateMeshObjectTextures(false);
+    TRUE_OR_DIE(updateShaderPrograms(false), "Cannot initialize shaders. Exit...");
+
+    updateFrameTime();
     translateCamera();
     rotateCamera();
     updateCamera();
-
+    updateSceneObjects();
 
     // render scene
+    bool profiling = enabledGpuProfiler || gpuProfiler.isLogging();
+
+    if(profiling)
+    {
+        gpuProfiler.beginFrame();
+    }
+
     renderScene();
 
+    if(profiling)
+    {
+        gpuProfiler.endFrame();
+    }
+
+    if(enabledGpuProfiler)
+    {
+        drawGpuProfilerHUD();
+    }
+
+    /////////////////////////////////////////////////////////////////
+    // schedule the next frame only while something changes, otherwise wait for an event
+    renderingContinuously = isCameraMoving() || animateSceneObjects ||
+                            !programReady[PhongShading] || !programReady[ToonShading] ||
+                            !programReady[ProgramRenderSilhouette] ||
+                            !programReady[ProgramDepthPrepass] ||
+                            textureLoader.hasPendingTextures();
+
+    if(renderingContinuously)
+    {
+        update();
+    }
+
 }
 
 //-----------------------------------------------------------------------------------------
@@ -833,52 +1590,284 @@ void Renderer::setShadingMode(ShadingProgram _shadingMode)
 }
 
 //------------------------------------------------------------------------------------------
-void Renderer::resetCameraPosition()
-{
-    cameraPosition = DEFAULT_CAMERA_POSITION;
-    cameraFocus = DEFAULT_CAMERA_FOCUS;
-    cameraUpDirection = QVector3D(0.0f, 1.0f, 0.0f);
-
-    update();
-}
-
+// render the Phong pass with the specialized program variant and with the uber-shader,
+// and compare the fragment throughput measured by GPU queries
 //------------------------------------------------------------------------------------------
-void Renderer::enableDepthTest(bool _status)
+void Renderer::benchmarkShaderVariants(int _numFrames)
 {
-    if(!isValid())
+    if(!isValid() || !initializedScene)
     {
         return;
     }
 
     makeCurrent();
 
-    if(_status)
-    {
-        glEnable(GL_DEPTH_TEST);
-    }
-    else
+    ShadingProgram shadingMode = currentShadingMode;
+    currentShadingMode = PhongShading;
+
+    GLuint queries[2];
+    glGenQueries(2, queries);
+
+    for(int variant = 0; variant < 2; ++variant)
     {
-        glDisable(GL_DEPTH_TEST);
+        useUberShader = (variant == 1);
+        updateMeshObjectTextures(true);
+        TRUE_OR_DIE(updateShaderPrograms(true), "Cannot initialize shaders. Exit...");
+        updateCamera();
+
+        // warm up
+        renderScene();
+        glFinish();
+
+        glBeginQuery(GL_TIME_ELAPSED, queries[0]);
+        glBeginQuery(GL_SAMPLES_PASSED, queries[1]);
+
+        for(int frame = 0; frame < _numFrames; ++frame)
+        {
+            renderScene();
+        }
+
+        glEndQuery(GL_SAMPLES_PASSED);
+        glEndQuery(GL_TIME_ELAPSED);
+
+        GLuint64 timeElapsed = 0;
+        GLuint64 numFragments = 0;
+        glGetQueryObjectui64v(queries[0], GL_QUERY_RESULT, &timeElapsed);
+        glGetQueryObjectui64v(queries[1], GL_QUERY_RESULT, &numFragments);
+
+        double seconds = (double) timeElapsed * 1e-9;
+        qDebug() << (useUberShader ? "Uber-shader:" : "Specialized variant:")
+                 << seconds * 1e3 / _numFrames << "ms/frame,"
+                 << (seconds > 0 ? (double) numFragments / seconds * 1e-6 : 0.0)
+                 << "Mfragments/s";
     }
 
+    glDeleteQueries(2, queries);
+
+    useUberShader = false;
+    currentShadingMode = shadingMode;
+    TRUE_OR_DIE(updateShaderPrograms(true), "Cannot initialize shaders. Exit...");
+
     doneCurrent();
     update();
 }
 
 //------------------------------------------------------------------------------------------
-void Renderer::enableRenderSilhouette(bool _state)
-{
-    enabledRenderSilhouette = _state;
-}
-
+// render the scene with an increasing number of objects, the visible objects are drawn as
+// instances so each pass (shading and silhouette) stays a single draw call
 //------------------------------------------------------------------------------------------
-void Renderer::keyPressEvent(QKeyEvent* _event)
+void Renderer::benchmarkInstancing(int _maxInstances, int _numFrames)
 {
-    switch(_event->key())
+    if(!isValid() || !initializedScene)
     {
-    case Qt::Key_Shift:
-        specialKeyPressed = Renderer::SHIFT_KEY;
-        break;
+        return;
+    }
+
+    makeCurrent();
+
+    int numObjects = numSceneObjects;
+    updateMeshObjectTextures(true);
+    TRUE_OR_DIE(updateShaderPrograms(true), "Cannot initialize shaders. Exit...");
+    updateCamera();
+
+    GLuint query;
+    glGenQueries(1, &query);
+
+    for(int count = 1; count <= qMin(_maxInstances, MAX_INSTANCES); count *= 4)
+    {
+        numSceneObjects = count;
+        initSceneObjects();
+        updateSceneObjects();
+
+        if(useGpuCulling)
+        {
+            numVisibleObjects = gpuCuller.readNumVisibleObjects();
+        }
+
+        int numInstances = qMax(numVisibleObjects, 1);
+
+        // warm up
+        renderScene();
+        glFinish();
+
+        glBeginQuery(GL_TIME_ELAPSED, query);
+
+        for(int frame = 0; frame < _numFrames; ++frame)
+        {
+            renderScene();
+        }
+
+        glEndQuery(GL_TIME_ELAPSED);
+
+        GLuint64 timeElapsed = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &timeElapsed);
+
+        double milliseconds = (double) timeElapsed * 1e-6 / _numFrames;
+        const CullingStats& stats = scene.getCullingStats();
+        qDebug() << "Objects:" << count << ", visible:" << numVisibleObjects << ","
+                 << "cull time:" << (double) (useGpuCulling ? gpuCuller.getCullTimeNs() :
+                                              stats.cullTimeNs) * 1e-3 << "us,"
+                 << milliseconds << "ms/frame,"
+                 << milliseconds * 1e3 / numInstances << "us/instance,"
+                 << (double) numVisibleObjects *
+                 meshPool.getMeshRange(currentMeshObject).indexCount / 3 /
+                 milliseconds * 1e-3 << "Mtriangles/s";
+    }
+
+    glDeleteQueries(1, &query);
+
+    numSceneObjects = numObjects;
+    initSceneObjects();
+
+    doneCurrent();
+    update();
+}
+
+//------------------------------------------------------------------------------------------
+// the widget is never shown, so makeCurrent/doneCurrent do nothing and the context of the
+// caller stays current
+//------------------------------------------------------------------------------------------
+void Renderer::initializeHeadless(const QSize& _size, MeshObject _meshObject,
+                                  ShadingProgram _shadingMode, int _numObjects)
+{
+    headlessSize = _size;
+    currentMeshObject = _meshObject;
+    currentShadingMode = _shadingMode;
+    numSceneObjects = qBound(1, _numObjects, MAX_INSTANCES);
+
+    initializeGL();
+    resizeGL(_size.width(), _size.height());
+
+    updateMeshObjectTextures(true);
+    TRUE_OR_DIE(updateShaderPrograms(true), "Cannot initialize shaders. Exit...");
+}
+
+//------------------------------------------------------------------------------------------
+void Renderer::renderHeadlessFrame(const QVector3D& _cameraPosition,
+                                   const QVector3D& _cameraFocus)
+{
+    TRACE_SCOPE("renderHeadlessFrame");
+
+    cameraPosition = _cameraPosition;
+    cameraFocus = _cameraFocus;
+
+    updateMeshObjectTextures(false);
+    updateCamera();
+    updateSceneObjects();
+    renderScene();
+}
+
+//------------------------------------------------------------------------------------------
+void Renderer::setStressMeshLevel(StressMeshType _type, int _level)
+{
+    if(_type < 0 || _type >= NUM_STRESS_MESH)
+    {
+        return;
+    }
+
+    stressMeshLevels[_type] = qMax(0, _level);
+}
+
+//------------------------------------------------------------------------------------------
+int Renderer::getStressMeshLevel(StressMeshType _type)
+{
+    Q_ASSERT(_type >= 0 && _type < NUM_STRESS_MESH);
+    return stressMeshLevels[_type];
+}
+
+//------------------------------------------------------------------------------------------
+void Renderer::setMeshCacheBudget(int _megabytes)
+{
+    meshPool.setBudget((qint64) _megabytes << 20);
+}
+
+//------------------------------------------------------------------------------------------
+const MeshPoolStats& Renderer::getMeshCacheStats()
+{
+    return meshPool.getStats();
+}
+
+//------------------------------------------------------------------------------------------
+const ShadowStats& Renderer::getShadowStats()
+{
+    return shadowMap.getStats();
+}
+
+//------------------------------------------------------------------------------------------
+QString Renderer::getMeshObjectName(MeshObject _meshObject)
+{
+    switch(_meshObject)
+    {
+    case TEAPOT_OBJ:
+        return QString("teapot");
+
+    case BUNNY_OBJ:
+        return QString("bunny");
+
+    default:
+        return StressMesh::getName((StressMeshType)(_meshObject - FIRST_STRESS_MESH_OBJECT));
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// in the last frame, this waits for the GPU culling
+//------------------------------------------------------------------------------------------
+qint64 Renderer::getNumRenderedTriangles()
+{
+    qint64 numObjects = useGpuCulling ? gpuCuller.readNumVisibleObjects() : numVisibleObjects;
+    qint64 numTriangles = numObjects * meshPool.getMeshRange(currentMeshObject).indexCount / 3;
+
+    return enabledRenderSilhouette ? 2 * numTriangles : numTriangles;
+}
+
+//------------------------------------------------------------------------------------------
+void Renderer::resetCameraPosition()
+{
+    cameraPosition = DEFAULT_CAMERA_POSITION;
+    cameraFocus = DEFAULT_CAMERA_FOCUS;
+    cameraUpDirection = QVector3D(0.0f, 1.0f, 0.0f);
+
+    update();
+}
+
+//------------------------------------------------------------------------------------------
+void Renderer::enableDepthTest(bool _status)
+{
+    if(!isValid())
+    {
+        return;
+    }
+
+    makeCurrent();
+
+    if(_status)
+    {
+        glEnable(GL_DEPTH_TEST);
+    }
+    else
+    {
+        glDisable(GL_DEPTH_TEST);
+    }
+
+    doneCurrent();
+    update();
+}
+
+//------------------------------------------------------------------------------------------
+void Renderer::enableRenderSilhouette(bool _state)
+{
+    enabledRenderSilhouette = _state;
+    update();
+}
+
+//------------------------------------------------------------------------------------------
+void Renderer::keyPressEvent(QKeyEvent* _event)
+{
+    switch(_event->key())
+    {
+    case Qt::Key_Shift:
+        specialKeyPressed = Renderer::SHIFT_KEY;
+        break;
 
     case Qt::Key_Plus:
         zooming -= 0.1f;
@@ -904,9 +1893,24 @@ void Renderer::keyPressEvent(QKeyEvent* _event)
         translation += QVector3D(0.5f, 0.0f, 0.0f);
         break;
 
+    case Qt::Key_G:
+        enableGpuCulling(!useGpuCulling);
+        break;
+
+    case Qt::Key_P:
+        enableGpuProfiler(!enabledGpuProfiler);
+        break;
+
+    case Qt::Key_L:
+        enableGpuProfileLogging(!gpuProfiler.isLogging());
+        break;
+
     default:
         QOpenGLWidget::keyPressEvent(_event);
+        return;
     }
+
+    update();
 }
 
 //------------------------------------------------------------------------------------------
@@ -915,10 +1919,34 @@ void Renderer::keyReleaseEvent(QKeyEvent* _event)
     specialKeyPressed = Renderer::NO_KEY;
 }
 
+//------------------------------------------------------------------------------------------
+// the first frame after being idle moves by one reference frame, the camera would jump
+// by the whole idle time otherwise
+//------------------------------------------------------------------------------------------
+void Renderer::updateFrameTime()
+{
+    float frameTime = INERTIA_REFERENCE_FRAME_TIME;
+
+    if(frameTimer.isValid() && renderingContinuously)
+    {
+        frameTime = qMin((float) frameTimer.nsecsElapsed() * 1e-9f, MAX_FRAME_TIME);
+    }
+
+    frameTimer.start();
+    frameTimeScale = frameTime / INERTIA_REFERENCE_FRAME_TIME;
+}
+
+//------------------------------------------------------------------------------------------
+bool Renderer::isCameraMoving()
+{
+    return (translation.lengthSquared() >= 1e-4 || rotation.lengthSquared() >= 1e-4 ||
+            fabs(zooming) >= 1e-4);
+}
+
 //------------------------------------------------------------------------------------------
 void Renderer::translateCamera()
 {
-    translation *= MOVING_INERTIA;
+    translation *= pow(MOVING_INERTIA, frameTimeScale);
 
     if(translation.lengthSquared() < 1e-4)
     {
@@ -927,7 +1955,7 @@ void Renderer::translateCamera()
 
 
     QVector3D eyeVector = cameraFocus - cameraPosition;
-    float scale = sqrt(eyeVector.length()) * 0.01f;
+    float scale = sqrt(eyeVector.length()) * 0.01f * frameTimeScale;
 
     QVector3D u = cameraUpDirection;
 
@@ -943,7 +1971,7 @@ void Renderer::translateCamera()
 //------------------------------------------------------------------------------------------
 void Renderer::rotateCamera()
 {
-    rotation *= MOVING_INERTIA;
+    rotation *= pow(MOVING_INERTIA, frameTimeScale);
 
     if(rotation.lengthSquared() < 1e-4)
     {
@@ -958,7 +1986,7 @@ void Renderer::rotateCamera()
     u.normalize();
     v.normalize();
 
-    float scale = sqrt(nEyeVector.length()) * 0.02f;
+    float scale = sqrt(nEyeVector.length()) * 0.02f * frameTimeScale;
     QQuaternion qRotation = QQuaternion::fromAxisAndAngle(v, rotation.y() * scale) *
                             QQuaternion::fromAxisAndAngle(u, rotation.x() * scale) *
                             QQuaternion::fromAxisAndAngle(nEyeVector, rotation.z() * scale);
@@ -974,7 +2002,7 @@ void Renderer::rotateCamera()
 //------------------------------------------------------------------------------------------
 void Renderer::zoomCamera()
 {
-    zooming *= MOVING_INERTIA;
+    zooming *= pow(MOVING_INERTIA, frameTimeScale);
 
     if(fabs(zooming) < 1e-4)
     {
@@ -985,7 +2013,7 @@ void Renderer::zoomCamera()
     float len = nEyeVector.length();
     nEyeVector.normalize();
 
-    len += sqrt(len) * zooming * 0.3f;
+    len += sqrt(len) * zooming * 0.3f * frameTimeScale;
 
     if(len < 0.5f)
     {
@@ -1016,10 +2044,20 @@ void Renderer::renderTestScene()
 //------------------------------------------------------------------------------------------
 void Renderer::renderScene()
 {
-    glViewport(0, 0, width() * retinaScale, height() * retinaScale);
+    if(headlessSize.isValid())
+    {
+        glViewport(0, 0, headlessSize.width(), headlessSize.height());
+    }
+    else
+    {
+        glViewport(0, 0, width() * retinaScale, height() * retinaScale);
+    }
+
+    glEnable(GL_DEPTH_TEST);
+    updateShadowMap();
+
     glClearColor(0.8f, 0.8f, 0.8f, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glEnable(GL_DEPTH_TEST);
 
     renderObjects();
 }
@@ -1027,9 +2065,64 @@ void Renderer::renderScene()
 //------------------------------------------------------------------------------------------
 void Renderer::renderObjects()
 {
+    TRACE_SCOPE("renderObjects");
+
     QOpenGLShaderProgram* program;
 
-    if(currentShadingMode == PhongShading)
+    /////////////////////////////////////////////////////////////////
+    // render with whatever program is ready while the others are being compiled
+    ShadingProgram shadingMode = currentShadingMode;
+
+    if(!programReady[shadingMode])
+    {
+        shadingMode = programReady[PhongShading] ? PhongShading : ToonShading;
+    }
+
+    if(!programReady[shadingMode])
+    {
+        return;
+    }
+
+    if(!vaoMeshObject.isCreated())
+    {
+        qDebug() << "vaoMeshObject is not created!";
+        return;
+    }
+
+    if(!renderedFirstFrame)
+    {
+        qDebug() << "Time to first frame:" << startupTimer.elapsed() << "ms";
+        renderedFirstFrame = true;
+    }
+
+    // the shading and silhouette passes read the same vertex state
+    vaoMeshObject.bind();
+
+    /////////////////////////////////////////////////////////////////
+    // the expensive shading only runs on the front-most fragments of the objects drawn in
+    // the depth pre-pass, and does not write the depth if they are all drawn; the depth is
+    // only guaranteed to be equal when the position is transformed in the vertex stage as
+    // in the pre-pass, invariance does not hold across a geometry stage
+    bool depthPrepass = (shadingMode == PhongShading) && useDepthPrepass() &&
+                        (useGpuCulling || numDepthPrepassObjects > 0);
+
+    if(depthPrepass)
+    {
+        renderDepthPrepass();
+
+        if((useGpuCulling || numDepthPrepassObjects == numVisibleObjects) &&
+           !hasGeometryStage(PhongShading, programFeatures[PhongShading]))
+        {
+            glDepthFunc(GL_EQUAL);
+            glDepthMask(GL_FALSE);
+        }
+        else
+        {
+            glDepthFunc(GL_LEQUAL);
+        }
+    }
+
+    if(shadingMode == PhongShading)
     {
         program = glslPrograms[PhongShading];
         program->bind();
@@ -1048,7 +2141,9 @@ void Renderer::renderObjects()
         glBindBufferBase(GL_UNIFORM_BUFFER, UBOBindingIndex[BINDING_LIGHT],
                          UBOLight);
 
-        renderMeshObject(program);
+        gpuProfiler.beginPass(PhongShading);
+        renderMeshObject(program, PhongShading);
+        gpuProfiler.endPass(PhongShading);
 
         program->release();
     }
@@ -1069,13 +2164,22 @@ void Renderer::renderObjects()
         glBindBufferBase(GL_UNIFORM_BUFFER, UBOBindingIndex[BINDING_LIGHT],
                          UBOLight);
 
-        renderMeshObject(program);
+        gpuProfiler.beginPass(ToonShading);
+        renderMeshObject(program, ToonShading);
+        gpuProfiler.endPass(ToonShading);
         program->release();
 
     }
 
+    if(depthPrepass)
+    {
+        glDepthFunc(GL_LESS);
+        glDepthMask(GL_TRUE);
+    }
 
-    if(enabledRenderSilhouette)
+    // the silhouette hulls are tested against the depth of the pre-pass
+
+    if(enabledRenderSilhouette && programReady[ProgramRenderSilhouette])
     {
         program = glslPrograms[ProgramRenderSilhouette];
         program->bind();
@@ -1092,86 +2196,453 @@ void Renderer::renderObjects()
         glCullFace(GL_FRONT);
         glEnable(GL_DEPTH_TEST);
 
+        gpuProfiler.beginPass(ProgramRenderSilhouette);
         renderSilhouetteMeshObject();
+        gpuProfiler.endPass(ProgramRenderSilhouette);
 
         glDisable(GL_CULL_FACE);
         program->release();
     }
+
+    vaoMeshObject.release();
 }
 
 //------------------------------------------------------------------------------------------
-void Renderer::renderMeshObject(QOpenGLShaderProgram* _program)
+// the vertex array object must be bound
+//------------------------------------------------------------------------------------------
+void Renderer::renderMeshObject(QOpenGLShaderProgram* _program,
+                                ShadingProgram _shadingMode)
 {
-    if(!vaoMeshObject[currentShadingMode].isCreated())
-    {
-        qDebug() << "vaoMeshObject is not created!";
-        return;
-    }
-
-    /////////////////////////////////////////////////////////////////
-    // flush the model and normal matrices
-    glBindBuffer(GL_UNIFORM_BUFFER, UBOMatrices);
-    glBufferSubData(GL_UNIFORM_BUFFER, 0, SIZE_OF_MAT4,
-                    meshObjectModelMatrix.constData());
-    glBufferSubData(GL_UNIFORM_BUFFER, SIZE_OF_MAT4, SIZE_OF_MAT4,
-                    meshObjectNormalMatrix.constData());
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
-
-    glUniformBlockBinding(_program->programId(), uniMaterial[currentShadingMode],
+    glUniformBlockBinding(_program->programId(), uniMaterial[_shadingMode],
                           UBOBindingIndex[BINDING_MESH_OBJECT_MATERIAL]);
     glBindBufferBase(GL_UNIFORM_BUFFER, UBOBindingIndex[BINDING_MESH_OBJECT_MATERIAL],
                      UBOMeshObjectMaterial);
 
-    if(currentShadingMode == ToonShading)
+    /////////////////////////////////////////////////////////////////
+    // the shadow cascades, the sampler is set even where unused since it must not share
+    // the texture unit of a sampler of another type
+    bool shadowed = (programFeatures[_shadingMode] & FEATURE_DEPTH_TEX) &&
+                    shadowMap.isInitialized();
+    _program->setUniformValue(uniDepthTexture[_shadingMode], 2);
+
+    if(programFeatures[_shadingMode] & FEATURE_UBER_SHADER)
+    {
+        _program->setUniformValue(uniHasDepthTexture[_shadingMode],
+                                  shadowed ? GL_TRUE : GL_FALSE);
+    }
+
+    if(shadowed && uniShadow[_shadingMode] >= 0)
+    {
+        glUniformBlockBinding(_program->programId(), uniShadow[_shadingMode],
+                              UBOBindingIndex[BINDING_SHADOW]);
+        glBindBufferBase(GL_UNIFORM_BUFFER, UBOBindingIndex[BINDING_SHADOW], UBOShadow);
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, shadowMap.getDepthTexture());
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    if(_shadingMode == ToonShading)
     {
-        vaoMeshObject[currentShadingMode].bind();
-        glDrawArrays(GL_TRIANGLES, 0, objLoader->getNumVertices());
-        vaoMeshObject[currentShadingMode].release();
+        _program->setUniformValue(uniDiffuseRamp, 3);
+        _program->setUniformValue(uniSpecularRamp, 4);
+
+        toonDiffuseRampTexture->bind(3);
+        toonSpecularRampTexture->bind(4);
+        drawMeshObjectInstances();
+        toonSpecularRampTexture->release(4);
+        toonDiffuseRampTexture->release(3);
     }
     else
     {
         /////////////////////////////////////////////////////////////////
-        // set the uniform
-        _program->setUniformValue(uniHasObjTexture[currentShadingMode], GL_TRUE);
-        _program->setUniformValue(uniHasNormalTexture[currentShadingMode], GL_TRUE);
-        _program->setUniformValue(uniNeedTangent[currentShadingMode], GL_TRUE);
+        // set the uniform, only the uber-shader branches on them at runtime
+        bool textured = (programFeatures[_shadingMode] & FEATURE_OBJ_TEX) &&
+                        isMeshObjectTextureReady();
+
+        if(programFeatures[_shadingMode] & FEATURE_UBER_SHADER)
+        {
+            GLint flag = textured ? GL_TRUE : GL_FALSE;
+            _program->setUniformValue(uniHasObjTexture[_shadingMode], flag);
+            _program->setUniformValue(uniHasNormalTexture[_shadingMode], flag);
+            _program->setUniformValue(uniNeedTangent[_shadingMode], flag);
+        }
 
         /////////////////////////////////////////////////////////////////
-        // render the mesh object
-        vaoMeshObject[currentShadingMode].bind();
-        colorMapsMeshObject[currentMeshObjectTexture]->bind(0);
-        normalMapsMeshObject[currentMeshObjectTexture]->bind(1);
-        glDrawArrays(GL_TRIANGLES, 0, objLoader->getNumVertices());
-        normalMapsMeshObject[currentMeshObjectTexture]->release();
-        colorMapsMeshObject[currentMeshObjectTexture]->release();
-        vaoMeshObject[currentShadingMode].release();
+        // render the mesh object, with its flat color while the textures are loading
+        if(textured)
+        {
+            textureLoader.getTextureArray(colorTextureArrayID)->bind(0);
+            textureLoader.getTextureArray(normalTextureArrayID)->bind(1);
+        }
+
+        drawMeshObjectInstances();
+
+        if(textured)
+        {
+            textureLoader.getTextureArray(normalTextureArrayID)->release(1);
+            textureLoader.getTextureArray(colorTextureArrayID)->release(0);
+        }
     }
 
+    if(shadowed && uniShadow[_shadingMode] >= 0)
+    {
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+        glActiveTexture(GL_TEXTURE0);
+    }
 }
 
+//------------------------------------------------------------------------------------------
+// the vertex array object must be bound
 //------------------------------------------------------------------------------------------
 void Renderer::renderSilhouetteMeshObject()
 {
-    if(!vaoMeshObject[ProgramRenderSilhouette].isCreated())
+    drawMeshObjectInstances();
+
+    glDisable(GL_CULL_FACE);
+}
+
+//------------------------------------------------------------------------------------------
+// the toon shading costs about as much as the pre-pass itself, only the normal-mapped
+// Phong shading benefits from it
+//------------------------------------------------------------------------------------------
+bool Renderer::useDepthPrepass()
+{
+    return enabledDepthPrepass && currentShadingMode == PhongShading &&
+           programReady[ProgramDepthPrepass];
+}
+
+//------------------------------------------------------------------------------------------
+// fraction of the viewport covered by the screen rectangle of a world bounding box
+//------------------------------------------------------------------------------------------
+float Renderer::getScreenCoverage(const AABB& _bounds)
+{
+    QVector2D minPoint(1.0f, 1.0f);
+    QVector2D maxPoint(-1.0f, -1.0f);
+
+    for(int i = 0; i < 8; ++i)
+    {
+        QVector4D corner((i & 1) ? _bounds.maxPoint.x() : _bounds.minPoint.x(),
+                         (i & 2) ? _bounds.maxPoint.y() : _bounds.minPoint.y(),
+                         (i & 4) ? _bounds.maxPoint.z() : _bounds.minPoint.z(), 1.0f);
+        QVector4D clipCorner = viewProjectionMatrix * corner;
+
+        // the box crosses the camera plane, it fills the view
+        if(clipCorner.w() <= 0.0f)
+        {
+            return 1.0f;
+        }
+
+        QVector2D ndcCorner = clipCorner.toVector2DAffine();
+        minPoint = QVector2D(qMin(minPoint.x(), ndcCorner.x()), qMin(minPoint.y(),
+                                                                     ndcCorner.y()));
+        maxPoint = QVector2D(qMax(maxPoint.x(), ndcCorner.x()), qMax(maxPoint.y(),
+                                                                     ndcCorner.y()));
+    }
+
+    float width = qBound(-1.0f, maxPoint.x(), 1.0f) - qBound(-1.0f, minPoint.x(), 1.0f);
+    float height = qBound(-1.0f, maxPoint.y(), 1.0f) - qBound(-1.0f, minPoint.y(), 1.0f);
+
+    return 0.25f * qMax(0.0f, width) * qMax(0.0f, height);
+}
+
+//------------------------------------------------------------------------------------------
+// the large objects on screen have the most self-occlusion and hide the others, they are
+// moved to the front of the visible objects to be drawn in the pre-pass; for the small
+// ones, the pre-pass would cost more vertex work than the shading it saves
+//------------------------------------------------------------------------------------------
+void Renderer::sortDepthPrepassObjects()
+{
+    numDepthPrepassObjects = 0;
+
+    if(!useDepthPrepass())
     {
-        qDebug() << "vaoMeshObject is not created!";
         return;
     }
 
-    /////////////////////////////////////////////////////////////////
-    // flush the model and normal matrices
-    glBindBuffer(GL_UNIFORM_BUFFER, UBOMatrices);
-    glBufferSubData(GL_UNIFORM_BUFFER, 0, SIZE_OF_MAT4,
-                    meshObjectModelMatrix.constData());
-    glBufferSubData(GL_UNIFORM_BUFFER, SIZE_OF_MAT4, SIZE_OF_MAT4,
-                    meshObjectNormalMatrix.constData());
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    smallVisibleObjects.resize(0);
 
-    vaoMeshObject[ProgramRenderSilhouette].bind();
-    glDrawArrays(GL_TRIANGLES, 0, objLoader->getNumVertices());
-    vaoMeshObject[ProgramRenderSilhouette].release();
+    for(int i = 0; i < visibleObjects.size(); ++i)
+    {
+        int objectIndex = visibleObjects[i];
 
-    glDisable(GL_CULL_FACE);
+        if(getScreenCoverage(scene.getObject(objectIndex).bounds) >= DEPTH_PREPASS_MIN_COVERAGE)
+        {
+            visibleObjects[numDepthPrepassObjects++] = objectIndex;
+        }
+        else
+        {
+            smallVisibleObjects.append(objectIndex);
+        }
+    }
+
+    if(!smallVisibleObjects.isEmpty())
+    {
+        memcpy(visibleObjects.data() + numDepthPrepassObjects, smallVisibleObjects.constData(),
+               smallVisibleObjects.size() * sizeof(int));
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// depth only, from the positions block of the mesh pool; the visible instances of the GPU
+// culling stay on the GPU, they are all drawn
+//------------------------------------------------------------------------------------------
+void Renderer::renderDepthPrepass()
+{
+    QOpenGLShaderProgram* program = glslPrograms[ProgramDepthPrepass];
+    program->bind();
+
+    glUniformBlockBinding(program->programId(), uniMatrices[ProgramDepthPrepass],
+                          UBOBindingIndex[BINDING_MATRICES]);
+    glBindBufferBase(GL_UNIFORM_BUFFER, UBOBindingIndex[BINDING_MATRICES], UBOMatrices);
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+
+    gpuProfiler.beginPass(ProgramDepthPrepass);
+
+    if(useGpuCulling)
+    {
+        gpuCuller.drawCommands();
+    }
+    else
+    {
+        const MeshRange& meshRange = meshPool.getMeshRange(currentMeshObject);
+        glDrawElementsInstancedBaseVertex(GL_TRIANGLES, meshRange.indexCount,
+                                          GL_UNSIGNED_INT,
+                                          (const GLvoid*)(meshRange.firstIndex * sizeof(GLuint)),
+                                          numDepthPrepassObjects, meshRange.baseVertex);
+    }
+
+    gpuProfiler.endPass(ProgramDepthPrepass);
+
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    program->release();
+}
+
+//------------------------------------------------------------------------------------------
+// every scene object casts shadows, not only the visible ones
+//------------------------------------------------------------------------------------------
+void Renderer::updateShadowCasters()
+{
+    int numObjects = scene.getNumObjects();
+    AABB bounds;
+    shadowCasterInstances.resize(numObjects);
+
+    for(int i = 0; i < numObjects; ++i)
+    {
+        const SceneObject& object = scene.getObject(i);
+        QMatrix3x3 normalMatrix = object.transform.normalMatrix();
+
+        memcpy(shadowCasterInstances[i].modelMatrix, object.transform.constData(),
+               SIZE_OF_MAT4);
+        memcpy(shadowCasterInstances[i].normalMatrix, normalMatrix.constData(),
+               9 * sizeof(GLfloat));
+        shadowCasterInstances[i].materialIndex = object.materialIndex;
+        bounds = bounds.merged(object.bounds);
+    }
+
+    // the buffer object stays the same, the vertex array object remains valid
+    vboShadowCasterInstances.bind();
+    vboShadowCasterInstances.allocate(shadowCasterInstances.constData(),
+                                      numObjects * sizeof(InstanceData));
+    vboShadowCasterInstances.release();
+
+    shadowMap.setCasterBounds(bounds);
+    shadowMap.invalidate();
+    shadowCastersChanged = false;
+}
+
+//------------------------------------------------------------------------------------------
+// render the cascades the cache cannot reuse, with the depth pre-pass program, and upload
+// the cascades for the shading programs if they changed
+//------------------------------------------------------------------------------------------
+void Renderer::updateShadowMap()
+{
+    if(!shadowMap.isInitialized() || shadowMap.getNumCascades() == 0 ||
+       !programReady[ProgramDepthPrepass] || !vaoShadowCasters.isCreated())
+    {
+        return;
+    }
+
+    if(shadowCastersChanged)
+    {
+        updateShadowCasters();
+    }
+
+    shadowMap.setLightDirection(light.direction.toVector3D());
+    int cascadeMask = shadowMap.beginUpdate(viewMatrix, projectionMatrix);
+
+    if(cascadeMask != 0)
+    {
+        QOpenGLShaderProgram* program = glslPrograms[ProgramDepthPrepass];
+        program->bind();
+
+        glUniformBlockBinding(program->programId(), uniMatrices[ProgramDepthPrepass],
+                              UBOBindingIndex[BINDING_MATRICES]);
+        glBindBufferBase(GL_UNIFORM_BUFFER, UBOBindingIndex[BINDING_MATRICES],
+                         UBOShadowMatrices);
+
+        // push the depth back instead of biasing the comparison in every fragment
+        glEnable(GL_POLYGON_OFFSET_FILL);
+        glPolygonOffset(SHADOW_POLYGON_OFFSET_FACTOR, SHADOW_POLYGON_OFFSET_UNITS);
+
+        const MeshRange& meshRange = meshPool.getMeshRange(currentMeshObject);
+        vaoShadowCasters.bind();
+        gpuProfiler.beginPass(GPU_PASS_SHADOW_MAP);
+
+        for(int i = 0; i < shadowMap.getNumCascades(); ++i)
+        {
+            if(!(cascadeMask & (1 << i)))
+            {
+                continue;
+            }
+
+            const QMatrix4x4& lightMatrix = shadowMap.beginCascade(i);
+
+            glBindBuffer(GL_UNIFORM_BUFFER, UBOShadowMatrices);
+            glBufferSubData(GL_UNIFORM_BUFFER, 2 * SIZE_OF_MAT4, SIZE_OF_MAT4,
+                            lightMatrix.constData());
+            glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+            glDrawElementsInstancedBaseVertex(GL_TRIANGLES, meshRange.indexCount,
+                                              GL_UNSIGNED_INT,
+                                              (const GLvoid*)(meshRange.firstIndex *
+                                                              sizeof(GLuint)),
+                                              shadowCasterInstances.size(),
+                                              meshRange.baseVertex);
+        }
+
+        gpuProfiler.endPass(GPU_PASS_SHADOW_MAP);
+        vaoShadowCasters.release();
+
+        glDisable(GL_POLYGON_OFFSET_FILL);
+        program->release();
+        shadowMap.endUpdate();
+    }
+
+    if(shadowMap.hasCascadeDataChanged())
+    {
+        glBindBuffer(GL_UNIFORM_BUFFER, UBOMatrices);
+        glBufferSubData(GL_UNIFORM_BUFFER, 3 * SIZE_OF_MAT4, SIZE_OF_MAT4,
+                        shadowMap.getShadowMatrix().constData());
+        glBindBuffer(GL_UNIFORM_BUFFER, UBOShadow);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(ShadowCascadeData),
+                        &shadowMap.getCascadeData());
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// the vertex array object of the pass must be bound
+//------------------------------------------------------------------------------------------
+void Renderer::drawMeshObjectInstances()
+{
+    if(useGpuCulling)
+    {
+        gpuCuller.drawCommands();
+        return;
+    }
+
+    if(numVisibleObjects == 0)
+    {
+        return;
+    }
+
+    const MeshRange& meshRange = meshPool.getMeshRange(currentMeshObject);
+    glDrawElementsInstancedBaseVertex(GL_TRIANGLES, meshRange.indexCount, GL_UNSIGNED_INT,
+                                      (const GLvoid*)(meshRange.firstIndex * sizeof(GLuint)),
+                                      numVisibleObjects, meshRange.baseVertex);
+}
+
+//------------------------------------------------------------------------------------------
+void Renderer::enableOcclusionCulling(bool _state)
+{
+    enabledOcclusionCulling = _state;
+    update();
+}
+
+//------------------------------------------------------------------------------------------
+void Renderer::enableDepthPrepass(bool _state)
+{
+    enabledDepthPrepass = _state;
+    update();
+}
+
+//------------------------------------------------------------------------------------------
+// 0 disables the shadows, the shading programs switch to the matching variants
+//------------------------------------------------------------------------------------------
+void Renderer::setNumShadowCascades(int _numCascades)
+{
+    shadowMap.setNumCascades(_numCascades);
+    update();
+}
+
+//------------------------------------------------------------------------------------------
+void Renderer::enableGpuCulling(bool _state)
+{
+    useGpuCulling = _state && gpuCullingSupported;
+    qDebug() << "Culling:" << (useGpuCulling ? "GPU (compute + multi-draw indirect)" : "CPU");
+    update();
+}
+
+//------------------------------------------------------------------------------------------
+void Renderer::enableGpuProfiler(bool _state)
+{
+    enabledGpuProfiler = _state;
+    update();
 }
 
+//------------------------------------------------------------------------------------------
+// the rows are only written for the frames being rendered, which is on demand
+//------------------------------------------------------------------------------------------
+void Renderer::enableGpuProfileLogging(bool _state)
+{
+    if(!_state)
+    {
+        gpuProfiler.stopLogging();
+        return;
+    }
+
+    if(gpuProfiler.isInitialized())
+    {
+        gpuProfiler.startLogging(GPU_PROFILE_LOG_FILE);
+        update();
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// the averages are read back a few frames late, the HUD is drawn on top of the scene
+//------------------------------------------------------------------------------------------
+void Renderer::drawGpuProfilerHUD()
+{
+    QStringList lines;
+    lines.append(QString("GPU passes, average of %1 frames%2")
+                 .arg(GPU_PROFILER_AVERAGE_FRAMES)
+                 .arg(gpuProfiler.isLogging() ? ", logging to " GPU_PROFILE_LOG_FILE : ""));
+    lines.append(gpuProfiler.getSummary());
+
+    if(gpuProfiler.getNumDroppedFrames() > 0)
+    {
+        lines.append(QString("Dropped frames: %1").arg(gpuProfiler.getNumDroppedFrames()));
+    }
+
+    QFont font("Monospace");
+    font.setStyleHint(QFont::TypeWriter);
+    QFontMetrics metrics(font);
 
+    int textWidth = 0;
+
+    for(int i = 0; i < lines.size(); ++i)
+    {
+        textWidth = qMax(textWidth, metrics.width(lines[i]));
+    }
+
+    QRect textRect(10, 10, textWidth + 10, lines.size() * metrics.lineSpacing() + 10);
+
+    QPainter painter(this);
+    painter.setFont(font);
+    painter.fillRect(textRect, QColor(0, 0, 0, 160));
+    painter.setPen(Qt::white);
+    painter.drawText(textRect.adjusted(5, 5, -5, -5), Qt::AlignLeft | Qt::AlignTop,
+                     lines.join("\n"));
+    painter.end();
+}
@@ -17,6 +17,16 @@
 #include "unitsphere.h"
 #include "unitplane.h"
 #include "objloader.h"
+#include "shadercompiler.h"
+#include "toonramp.h"
+#include "textureloader.h"
+#include "scene.h"
+#include "meshpool.h"
+#include "gpuculler.h"
+#include "occlusionculler.h"
+#include "shadowmap.h"
+#include "gpuprofiler.h"
+#include "tracer.h"
 
 //------------------------------------------------------------------------------------------
 #define PRINT_LINE \
@@ -50,13 +60,29 @@
 #define SIZE_OF_MAT4 (4 * 4 *sizeof(GLfloat))
 #define SIZE_OF_VEC4 (4 * sizeof(GLfloat))
 //------------------------------------------------------------------------------------------
-#define MOVING_INERTIA 0.9f
+#define MOVING_INERTIA 0.9f                 // velocity kept after each reference frame
+#define INERTIA_REFERENCE_FRAME_TIME 0.01f  // seconds
+#define MAX_FRAME_TIME 0.1f
 #define SILHOUETTE_OFSET 0.05f
 #define SILHOUETTE_COLOR QVector3D(1, 0.5, 0)
 #define DEFAULT_CAMERA_POSITION QVector3D(0.0f,  6.5f, 25.0f)
 #define DEFAULT_CAMERA_FOCUS QVector3D(0.0f,  6.5f, 0.0f)
+#define TEXTURE_MEMORY_BUDGET (2 * 1024 * 1024)
+#define NUM_MESH_OBJECT_MATERIALS 8
+#define MAX_INSTANCES 65536
+#define INSTANCE_SPACING 8.0f
+#define SCENE_STATS_INTERVAL 250
+#define DEPTH_PREPASS_MIN_COVERAGE 0.02f // screen fraction of an object bounding box
+#define GPU_PROFILE_LOG_FILE "gpu_profile.csv"
 #define DEFAULT_LIGHT_DIRECTION QVector4D(1.0f, -1.0f, -1.0f, 1.0f)
+#define DEFAULT_SHADOW_CASCADES 1
 #define DEFAULT_MESH_OBJECT_POSITION QVector3D(0.0f, 0.001f, 0.0f)
+#define FIRST_STRESS_MESH_OBJECT ICOSPHERE_MESH
+// StressMesh levels of the procedural mesh objects: icosphere, blob, high genus and thin
+// features, around 100K triangles each
+#define DEFAULT_STRESS_MESH_LEVELS {6, 6, 8, 4}
+#define DEFAULT_TOON_DIFFUSE_BANDS "0.05:0.35, 0.5:0.7, 0.95:1.0"
+#define DEFAULT_TOON_SPECULAR_BANDS "0.4:0.35, 0.8:0.7, 0.98:1.0"
 
 struct Light
 {
@@ -81,11 +107,13 @@ struct Material
         diffuseColor(-10.0f, 1.0f, 0.0f, 1.0f),
         specularColor(1.0f, 1.0f, 1.0f, 1.0f),
         reflection(0.0f),
-        shininess(10.0f) {}
+        shininess(10.0f),
+        colorLayer(-1),
+        normalLayer(-1) {}
 
     int getStructSize()
     {
-        return (2 * 4 + 2) * sizeof(GLfloat);
+        return (2 * 4 + 2) * sizeof(GLfloat) + 2 * sizeof(GLint);
     }
 
     void setDiffuse(QVector4D _diffuse)
@@ -107,6 +135,18 @@ struct Material
     QVector4D specularColor;
     GLfloat reflection;
     GLfloat shininess;
+
+    // layers in the color/normal texture arrays, -1 while the textures are not loaded
+    GLint colorLayer;
+    GLint normalLayer;
+};
+
+// per-instance vertex attributes, the materials are indices into the material UBO
+struct InstanceData
+{
+    GLfloat modelMatrix[16];
+    GLfloat normalMatrix[9];
+    GLint materialIndex;
 };
 
 
@@ -126,6 +166,10 @@ enum MeshObject
 {
     TEAPOT_OBJ = 0,
     BUNNY_OBJ,
+    ICOSPHERE_MESH, // procedural meshes, in the order of StressMeshType
+    BLOB_MESH,
+    HIGH_GENUS_MESH,
+    THIN_FEATURES_MESH,
     NUM_MESH_OBJECT
 };
 
@@ -134,14 +178,46 @@ enum ShadingProgram
     PhongShading = 0,
     ToonShading,
     ProgramRenderSilhouette,
+    ProgramDepthPrepass,
     NUM_PROGRAMS
 };
 
+#define GPU_PASS_SHADOW_MAP NUM_PROGRAMS
+
+// compile-time feature flags of the shader programs, a program variant is built
+// and cached for each combination in use
+enum ShaderFeature
+{
+    FEATURE_OBJ_TEX = (1 << 0),
+    FEATURE_NORMAL_TEX = (1 << 1),
+    FEATURE_TANGENT = (1 << 2),
+    FEATURE_DEPTH_TEX = (1 << 3),
+    FEATURE_VERTEX_TANGENT = (1 << 4), // no geometry stage, tangents come from the mesh
+    FEATURE_UBER_SHADER = (1 << 5), // branch on uniforms instead, for benchmarking
+    FEATURE_RG_NORMAL_TEX = (1 << 6) // two-channel compressed normal map
+};
+
+// attribute locations shared by all mesh object programs, set in the shaders with
+// layout(location = ...) from the injected defines, so one vertex array object serves
+// every program
+enum VertexAttribute
+{
+    ATTRIB_VERTEX = 0,
+    ATTRIB_NORMAL,
+    ATTRIB_TEXCOORD,
+    ATTRIB_TANGENT,
+    ATTRIB_INSTANCE_MODEL_MATRIX, // one location per column
+    ATTRIB_INSTANCE_NORMAL_MATRIX = ATTRIB_INSTANCE_MODEL_MATRIX + 4,
+    ATTRIB_INSTANCE_MATERIAL = ATTRIB_INSTANCE_NORMAL_MATRIX + 3,
+    NUM_VERTEX_ATTRIBUTES
+};
+
 enum UBOBinding
 {
     BINDING_MATRICES = 0,
     BINDING_LIGHT,
     BINDING_MESH_OBJECT_MATERIAL,
+    BINDING_SHADOW,
     NUM_BINDING_POINTS
 };
 
@@ -175,8 +251,31 @@ public:
     void wheelEvent(QWheelEvent* _event);
 
     void setShadingMode(ShadingProgram _shadingMode);
+    void benchmarkShaderVariants(int _numFrames = 200);
+    void benchmarkInstancing(int _maxInstances = 4096, int _numFrames = 50);
+
+    // render without showing the widget, the caller makes its context current and binds
+    // a framebuffer object of the given size
+    void initializeHeadless(const QSize& _size, MeshObject _meshObject,
+                            ShadingProgram _shadingMode, int _numObjects);
+    void renderHeadlessFrame(const QVector3D& _cameraPosition,
+                             const QVector3D& _cameraFocus);
+    qint64 getNumRenderedTriangles();
+    int getNumSceneObjects();
+
+    // size of a procedural mesh object, applied when the meshes are (re)loaded
+    void setStressMeshLevel(StressMeshType _type, int _level);
+    int getStressMeshLevel(StressMeshType _type);
+    static QString getMeshObjectName(MeshObject _meshObject);
+
+    // GPU memory for the resident meshes, the least recently used ones are evicted above
+    void setMeshCacheBudget(int _megabytes);
+    const MeshPoolStats& getMeshCacheStats();
+    const ShadowStats& getShadowStats();
 
     QStringList* getStrListMeshObjectTexture();
+    QString getToonDiffuseBands();
+    QString getToonSpecularBands();
 
 public slots:
     void enableDepthTest(bool _status);
@@ -187,9 +286,22 @@ public slots:
     void setMeshObject(int _objectIndex);
     void setMeshObjectColor(float _r, float _g, float _b);
     void setMeshObjectTexture(int _texture);
+    void setNumSceneObjects(int _numObjects);
+    void enableAnimateSceneObjects(bool _state);
+    void enableGpuCulling(bool _state);
+    void enableOcclusionCulling(bool _state);
+    void enableDepthPrepass(bool _state);
+    void setNumShadowCascades(int _numCascades);
+    void enableGpuProfiler(bool _state);
+    void enableGpuProfileLogging(bool _state);
+    bool setToonDiffuseBands(const QString& _bands);
+    bool setToonSpecularBands(const QString& _bands);
 
     void resetCameraPosition();
 
+signals:
+    void sceneStatsChanged(const QString& _stats);
+
 protected:
     void initializeGL();
     void resizeGL(int w, int h);
@@ -204,20 +316,44 @@ private:
     void initTestScene();
     void initScene();
     bool initShaderPrograms();
+    int getShaderFeatures(ShadingProgram _shadingMode);
+    int getShaderFeatures(ShadingProgram _shadingMode, bool _texturesReady);
+    QStringList getShaderDefines(int _features);
+    bool hasGeometryStage(ShadingProgram _shadingMode, int _features);
+    QOpenGLShaderProgram* compileProgramVariant(ShadingProgram _shadingMode, int _features);
+    bool updateShaderPrograms(bool _waitForCompletion);
     bool validateShaderPrograms(ShadingProgram _shadingMode);
     bool initPhongShadingProgram();
     bool initToonShadingProgram();
     bool initRenderSilhouetteProgram();
+    bool initDepthPrepassProgram();
 
     void initSharedBlockUniform();
     void initTexture();
+    void updateMeshObjectTextures(bool _waitForUpload);
+    bool isMeshObjectTextureReady();
+    void initToonRampTextures();
+    void uploadToonRamp(QOpenGLTexture* _rampTexture, ToonRamp& _ramp);
     void initSceneMemory();
     void initMeshObjectMemory();
+    bool makeMeshObjectResident(MeshObject _meshObject);
+    void initGpuCulling();
+    void initGpuProfiler();
 
     void initVertexArrayObjects();
-    void initMeshObjectVAO(ShadingProgram _shadingMode);
+    void initMeshObjectVAO(QOpenGLVertexArrayObject& _vao, QOpenGLBuffer& _instanceBuffer);
     void initSceneMatrices();
-
+    void initSceneObjects();
+    QMatrix4x4 getSceneObjectTransform(int _objectIndex, float _time);
+    void updateSceneObjects();
+    void emitGpuCullingStats();
+    QString getOcclusionStatsString();
+    QString getMeshCacheStatsString();
+    QString getShadowStatsString();
+    void uploadMeshObjectMaterials();
+
+    void updateFrameTime();
+    bool isCameraMoving();
     void updateCamera();
     void translateCamera();
     void rotateCamera();
@@ -229,27 +365,48 @@ private:
     void renderScene();
     void renderObjects();
 
-    void renderMeshObject(QOpenGLShaderProgram* _program);
+    void renderMeshObject(QOpenGLShaderProgram* _program, ShadingProgram _shadingMode);
     void renderSilhouetteMeshObject();
-
-    QOpenGLTexture* normalMapsMeshObject[NumMetalTextures];
-    QOpenGLTexture* colorMapsMeshObject[NumMetalTextures];
+    bool useDepthPrepass();
+    float getScreenCoverage(const AABB& _bounds);
+    void sortDepthPrepassObjects();
+    void renderDepthPrepass();
+    void updateShadowCasters();
+    void updateShadowMap();
+    void drawMeshObjectInstances();
+    void drawGpuProfilerHUD();
+
+    TextureLoader textureLoader;
+    int normalMapIDs[NumMetalTextures];
+    int colorMapIDs[NumMetalTextures];
+    int colorTextureArrayID;
+    int normalTextureArrayID;
     QStringList* strListMeshObjectTexture;
 
+    ToonRamp toonDiffuseRamp;
+    ToonRamp toonSpecularRamp;
+    QOpenGLTexture* toonDiffuseRampTexture;
+    QOpenGLTexture* toonSpecularRampTexture;
+
     OBJLoader* objLoader;
+    int stressMeshLevels[NUM_STRESS_MESH];
 
     QMap<ShadingProgram, QString> vertexShaderSourceMap;
     QMap<ShadingProgram, QString> fragmentShaderSourceMap;
+    QMap<ShadingProgram, QString> geometryShaderSourceMap;
+    ShaderCompiler shaderCompiler;
+    QMap<int, QOpenGLShaderProgram*> programVariants[NUM_PROGRAMS];
     QOpenGLShaderProgram* glslPrograms[NUM_PROGRAMS];
+    int programFeatures[NUM_PROGRAMS];
+    bool programReady[NUM_PROGRAMS];
+    bool useUberShader;
     QOpenGLShaderProgram* silhouetteProgram;
     GLuint UBOBindingIndex[NUM_BINDING_POINTS];
     GLuint UBOMatrices;
     GLuint UBOLight;
     GLuint UBOMeshObjectMaterial;
-    GLint attrVertex[NUM_PROGRAMS];
-    GLint attrNormal[NUM_PROGRAMS];
-    GLint attrTexCoord[NUM_PROGRAMS];
-
+    GLuint UBOShadow;
+    GLuint UBOShadowMatrices;
     GLint uniMatrices[NUM_PROGRAMS];
     GLint uniCameraPosition[NUM_PROGRAMS];
     GLint uniLight[NUM_PROGRAMS];
@@ -260,12 +417,49 @@ private:
     GLint uniHasObjTexture[NUM_PROGRAMS];
     GLint uniHasNormalTexture[NUM_PROGRAMS];
     GLint uniNeedTangent[NUM_PROGRAMS];
+    GLint uniShadow[NUM_PROGRAMS];
+    GLint uniDepthTexture[NUM_PROGRAMS];
+    GLint uniHasDepthTexture[NUM_PROGRAMS];
+    GLint uniDiffuseRamp;
+    GLint uniSpecularRamp;
     GLint uniPlaneVector;
 
 
-    QOpenGLVertexArrayObject vaoMeshObject[NUM_PROGRAMS];
-
-    QOpenGLBuffer vboMeshObject;
+    QOpenGLVertexArrayObject vaoMeshObject;
+
+    MeshPool meshPool;
+    int meshBufferGeneration;
+    GpuCuller gpuCuller;
+    bool gpuCullingSupported;
+    bool useGpuCulling;
+    OcclusionCuller occlusionCuller;
+    bool enabledOcclusionCulling;
+
+    // the visible objects drawn in the depth pre-pass come first
+    bool enabledDepthPrepass;
+    int numDepthPrepassObjects;
+    QVector<int> smallVisibleObjects;
+
+    // the depth pre-pass program draws every scene object into the cascades that changed
+    ShadowMap shadowMap;
+    QOpenGLVertexArrayObject vaoShadowCasters;
+    QOpenGLBuffer vboShadowCasterInstances;
+    QVector<InstanceData> shadowCasterInstances;
+    bool shadowCastersChanged;
+
+    // the passes are indexed by their ShadingProgram, the shadow map pass comes last
+    GpuProfiler gpuProfiler;
+    bool enabledGpuProfiler;
+    QOpenGLBuffer vboMeshObjectInstances;
+
+    Scene scene;
+    QVector<int> visibleObjects;
+    QVector<InstanceData> visibleInstances;
+    int numSceneObjects;
+    int numVisibleObjects;
+    bool animateSceneObjects;
+    QElapsedTimer sceneTimer;
+    qint64 lastSceneStatsTime;
 
     Material meshObjectMaterial;
     Light light;
@@ -304,6 +498,14 @@ private:
 
     bool initializedScene;
     bool initializedTestScene;
+    bool renderedFirstFrame;
+    QElapsedTimer startupTimer;
+    QSize headlessSize;
+
+    // frames are rendered on demand, the inertia is scaled by the frame time
+    QElapsedTimer frameTimer;
+    float frameTimeScale;
+    bool renderingContinuously;
 
 };
 
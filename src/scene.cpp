@@ -0,0 +1,102 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+#include <QElapsedTimer>
+
+#include "scene.h"
+
+//------------------------------------------------------------------------------------------
+Scene::Scene():
+    numReinserted(0)
+{
+}
+
+//------------------------------------------------------------------------------------------
+void Scene::clear()
+{
+    objects.clear();
+    bvh.clear();
+    cullingStats = CullingStats();
+    numReinserted = 0;
+}
+
+//------------------------------------------------------------------------------------------
+void Scene::setMeshBounds(int _meshIndex, const AABB& _bounds)
+{
+    if(meshBounds.size() <= _meshIndex)
+    {
+        meshBounds.resize(_meshIndex + 1);
+    }
+
+    meshBounds[_meshIndex] = _bounds;
+}
+
+//------------------------------------------------------------------------------------------
+int Scene::addObject(const QMatrix4x4& _transform, int _meshIndex, int _materialIndex)
+{
+    Q_ASSERT(_meshIndex < meshBounds.size());
+
+    SceneObject object;
+    object.transform = _transform;
+    object.meshIndex = _meshIndex;
+    object.materialIndex = _materialIndex;
+    object.bounds = meshBounds[_meshIndex].transformed(_transform);
+    object.bvhLeaf = bvh.insertLeaf(object.bounds, objects.size());
+
+    objects.append(object);
+
+    return objects.size() - 1;
+}
+
+//------------------------------------------------------------------------------------------
+void Scene::setObjectTransform(int _objectIndex, const QMatrix4x4& _transform)
+{
+    SceneObject& object = objects[_objectIndex];
+    object.transform = _transform;
+    object.bounds = meshBounds[object.meshIndex].transformed(_transform);
+
+    if(bvh.moveLeaf(object.bvhLeaf, object.bounds))
+    {
+        ++numReinserted;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+const SceneObject& Scene::getObject(int _objectIndex) const
+{
+    return objects[_objectIndex];
+}
+
+//------------------------------------------------------------------------------------------
+int Scene::getNumObjects() const
+{
+    return objects.size();
+}
+
+//------------------------------------------------------------------------------------------
+void Scene::cull(const QMatrix4x4& _viewProjectionMatrix, QVector<int>& _visibleObjects)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    _visibleObjects.resize(0);
+    frustum.setFromMatrix(_viewProjectionMatrix);
+    int numNodesTested = bvh.cull(frustum, _visibleObjects);
+
+    cullingStats.cullTimeNs = timer.nsecsElapsed();
+    cullingStats.numObjects = objects.size();
+    cullingStats.numVisible = _visibleObjects.size();
+    cullingStats.numNodesTested = numNodesTested;
+    cullingStats.numReinserted = numReinserted;
+    numReinserted = 0;
+}
+
+//------------------------------------------------------------------------------------------
+const CullingStats& Scene::getCullingStats() const
+{
+    return cullingStats;
+}
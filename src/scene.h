@@ -0,0 +1,78 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <QVector>
+#include <QMatrix4x4>
+
+#include "bvh.h"
+
+//------------------------------------------------------------------------------------------
+struct SceneObject
+{
+    QMatrix4x4 transform;
+    int meshIndex;
+    int materialIndex;
+    AABB bounds;
+    int bvhLeaf;
+};
+
+//------------------------------------------------------------------------------------------
+struct CullingStats
+{
+    CullingStats():
+        numObjects(0),
+        numVisible(0),
+        numNodesTested(0),
+        numReinserted(0),
+        cullTimeNs(0) {}
+
+    int numObjects;
+    int numVisible;
+    int numNodesTested;
+    int numReinserted;
+    qint64 cullTimeNs;
+};
+
+//------------------------------------------------------------------------------------------
+// Objects with a transform, a mesh and a material, kept in a dynamic BVH of their world
+// space bounds so culling does not need to visit every object
+//------------------------------------------------------------------------------------------
+class Scene
+{
+public:
+    Scene();
+
+    void clear();
+
+    // the object space bounds of each mesh, must be set before adding objects of the mesh
+    void setMeshBounds(int _meshIndex, const AABB& _bounds);
+
+    int addObject(const QMatrix4x4& _transform, int _meshIndex, int _materialIndex);
+    void setObjectTransform(int _objectIndex, const QMatrix4x4& _transform);
+
+    const SceneObject& getObject(int _objectIndex) const;
+    int getNumObjects() const;
+
+    // fill the indices of the objects that are not outside the frustum
+    void cull(const QMatrix4x4& _viewProjectionMatrix, QVector<int>& _visibleObjects);
+    const CullingStats& getCullingStats() const;
+
+private:
+    QVector<AABB> meshBounds;
+    QVector<SceneObject> objects;
+    BVH bvh;
+    int numReinserted;
+
+    Frustum frustum;
+    CullingStats cullingStats;
+};
+
+#endif // SCENE_H
@@ -0,0 +1,215 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+#include "shadercompiler.h"
+
+//------------------------------------------------------------------------------------------
+ShaderCompiler::ShaderCompiler():
+    parallelCompile(false)
+{
+}
+
+//------------------------------------------------------------------------------------------
+ShaderCompiler::~ShaderCompiler()
+{
+}
+
+//------------------------------------------------------------------------------------------
+void ShaderCompiler::initialize()
+{
+    initializeOpenGLFunctions();
+
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    MaxShaderCompilerThreadsFunc maxShaderCompilerThreads = NULL;
+
+    if(context->hasExtension("GL_KHR_parallel_shader_compile"))
+    {
+        maxShaderCompilerThreads = reinterpret_cast<MaxShaderCompilerThreadsFunc>
+                                   (context->getProcAddress("glMaxShaderCompilerThreadsKHR"));
+    }
+    else if(context->hasExtension("GL_ARB_parallel_shader_compile"))
+    {
+        maxShaderCompilerThreads = reinterpret_cast<MaxShaderCompilerThreadsFunc>
+                                   (context->getProcAddress("glMaxShaderCompilerThreadsARB"));
+    }
+
+    parallelCompile = (maxShaderCompilerThreads != NULL);
+
+    if(parallelCompile)
+    {
+        // let the driver decide how many threads it uses
+        maxShaderCompilerThreads(0xFFFFFFFF);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+bool ShaderCompiler::hasParallelCompile()
+{
+    return parallelCompile;
+}
+
+//------------------------------------------------------------------------------------------
+const QByteArray& ShaderCompiler::getShaderSource(const QString& _fileName)
+{
+    if(!shaderSourceCache.contains(_fileName))
+    {
+        QFile file(_fileName);
+
+        if(!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        {
+            qDebug() << "Cannot open shader file:" << _fileName;
+        }
+
+        shaderSourceCache.insert(_fileName, file.readAll());
+    }
+
+    return shaderSourceCache[_fileName];
+}
+
+//------------------------------------------------------------------------------------------
+QByteArray ShaderCompiler::injectDefines(const QByteArray& _source,
+                                         const QStringList& _defines)
+{
+    if(_defines.isEmpty())
+    {
+        return _source;
+    }
+
+    // the #version directive must stay the first statement
+    int versionLineEnd = 0;
+
+    if(_source.startsWith("#version"))
+    {
+        versionLineEnd = _source.indexOf('\n') + 1;
+    }
+
+    QByteArray defines;
+
+    foreach(QString define, _defines)
+    {
+        defines += "#define " + define.toLatin1() + "\n";
+    }
+
+    // keep the line numbers of the compile log matching the source file
+    defines += "#line " + QByteArray::number(versionLineEnd > 0 ? 2 : 1) + "\n";
+
+    QByteArray source = _source;
+    source.insert(versionLineEnd, defines);
+
+    return source;
+}
+
+//------------------------------------------------------------------------------------------
+// issue the compile and link commands, but do not query any status
+//------------------------------------------------------------------------------------------
+QOpenGLShaderProgram* ShaderCompiler::beginCompile(const QMap<GLenum, QString>&
+                                                   _shaderFiles, const QStringList& _defines)
+{
+    QOpenGLShaderProgram* program = new QOpenGLShaderProgram;
+
+    if(!program->create())
+    {
+        delete program;
+        return NULL;
+    }
+
+    QVector<GLuint> shaders;
+
+    foreach(GLenum shaderType, _shaderFiles.keys())
+    {
+        QByteArray source = injectDefines(getShaderSource(_shaderFiles.value(shaderType)),
+                                          _defines);
+        const char* sourcePtr = source.constData();
+        GLint sourceLength = source.size();
+
+        GLuint shader = glCreateShader(shaderType);
+        glShaderSource(shader, 1, &sourcePtr, &sourceLength);
+        glCompileShader(shader);
+        glAttachShader(program->programId(), shader);
+
+        shaders.append(shader);
+    }
+
+    glLinkProgram(program->programId());
+    pendingShaders.insert(program, shaders);
+
+    return program;
+}
+
+//------------------------------------------------------------------------------------------
+bool ShaderCompiler::isProgramReady(QOpenGLShaderProgram* _program)
+{
+    if(!pendingShaders.contains(_program) || !parallelCompile)
+    {
+        return true;
+    }
+
+    GLint completed = GL_FALSE;
+    glGetProgramiv(_program->programId(), GL_COMPLETION_STATUS_KHR, &completed);
+
+    return (completed == GL_TRUE);
+}
+
+//------------------------------------------------------------------------------------------
+// blocks if the driver is still compiling the program
+//------------------------------------------------------------------------------------------
+bool ShaderCompiler::finishCompile(QOpenGLShaderProgram* _program)
+{
+    if(!pendingShaders.contains(_program))
+    {
+        return _program->isLinked();
+    }
+
+    QVector<GLuint> shaders = pendingShaders.take(_program);
+    bool success = true;
+    GLint status;
+    GLint logLen;
+
+    foreach(GLuint shader, shaders)
+    {
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+
+        if(status != GL_TRUE)
+        {
+            glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logLen);
+
+            QByteArray log(logLen + 1, '\0');
+            glGetShaderInfoLog(shader, logLen, NULL, log.data());
+            qDebug() << "Cannot compile shader:" << log;
+
+            success = false;
+        }
+    }
+
+    glGetProgramiv(_program->programId(), GL_LINK_STATUS, &status);
+
+    if(status != GL_TRUE)
+    {
+        glGetProgramiv(_program->programId(), GL_INFO_LOG_LENGTH, &logLen);
+
+        QByteArray log(logLen + 1, '\0');
+        glGetProgramInfoLog(_program->programId(), logLen, NULL, log.data());
+        qDebug() << "Cannot link GLSL program:" << log;
+
+        success = false;
+    }
+
+    foreach(GLuint shader, shaders)
+    {
+        glDetachShader(_program->programId(), shader);
+        glDeleteShader(shader);
+    }
+
+    // the program has no QOpenGLShader attached, thus link() only picks up the status
+    // of our own glLinkProgram call
+    if(success)
+    {
+        success = _program->link();
+    }
+
+    return success;
+}
@@ -0,0 +1,59 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#ifndef SHADERCOMPILER_H
+#define SHADERCOMPILER_H
+
+#include <QtGui>
+#include <QOpenGLFunctions_4_0_Core>
+#include <QOpenGLShaderProgram>
+
+//------------------------------------------------------------------------------------------
+// KHR_parallel_shader_compile / ARB_parallel_shader_compile share the same tokens
+#ifndef GL_MAX_SHADER_COMPILER_THREADS_KHR
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#endif
+
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+//------------------------------------------------------------------------------------------
+// Compiles GLSL programs without waiting on the driver: all the compile and link
+// commands are issued first, the status is queried only when the program is needed.
+// With KHR_parallel_shader_compile the driver compiles on its own threads and
+// isProgramReady() can be polled every frame without blocking.
+//------------------------------------------------------------------------------------------
+class ShaderCompiler : protected QOpenGLFunctions_4_0_Core
+{
+public:
+    ShaderCompiler();
+    ~ShaderCompiler();
+
+    void initialize();
+    bool hasParallelCompile();
+
+    // _shaderFiles: shader stage (GL_VERTEX_SHADER...) -> source file
+    // _defines: "NAME VALUE" strings, injected right after the #version line
+    QOpenGLShaderProgram* beginCompile(const QMap<GLenum, QString>& _shaderFiles,
+                                       const QStringList& _defines = QStringList());
+    bool isProgramReady(QOpenGLShaderProgram* _program);
+    bool finishCompile(QOpenGLShaderProgram* _program);
+
+private:
+    const QByteArray& getShaderSource(const QString& _fileName);
+    QByteArray injectDefines(const QByteArray& _source, const QStringList& _defines);
+
+    typedef void (QOPENGLF_APIENTRYP MaxShaderCompilerThreadsFunc)(GLuint count);
+
+    bool parallelCompile;
+    QMap<QString, QByteArray> shaderSourceCache;
+    QMap<QOpenGLShaderProgram*, QVector<GLuint> > pendingShaders;
+};
+
+#endif // SHADERCOMPILER_H
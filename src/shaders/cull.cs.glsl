@@ -0,0 +1,136 @@
+#version 430 core
+//------------------------------------------------------------------------------------------
+// compute shader, frustum culling and LOD selection per object, the visible objects are
+// appended to the instances of the draw command of their LOD
+//------------------------------------------------------------------------------------------
+layout(local_size_x = 64) in;
+
+struct ObjectData
+{
+    mat4 modelMatrix;
+    vec4 boundsMin;
+    vec4 boundsMax;
+    int firstLod;
+    int numLods;
+    int materialIndex;
+    int padding;
+};
+
+struct DrawCommand
+{
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+};
+
+// must match the per-instance vertex attributes
+struct InstanceData
+{
+    float modelMatrix[16];
+    float normalMatrix[9];
+    int materialIndex;
+};
+
+layout(std430, binding = 0) readonly buffer Objects
+{
+    ObjectData objects[];
+};
+
+layout(std430, binding = 1) readonly buffer Lods
+{
+    float lodDistances[];
+};
+
+layout(std430, binding = 2) buffer Commands
+{
+    DrawCommand commands[];
+};
+
+layout(std430, binding = 3) writeonly buffer Instances
+{
+    InstanceData instances[];
+};
+
+// objects already found hidden on the CPU (occlusion culling) are 0
+layout(std430, binding = 4) readonly buffer Visibility
+{
+    uint objectVisibility[];
+};
+
+//------------------------------------------------------------------------------------------
+// uniforms
+uniform vec4 frustumPlanes[6];
+uniform vec3 cameraPosition;
+uniform uint numObjects;
+uniform bool useObjectVisibility;
+
+//------------------------------------------------------------------------------------------
+void main()
+{
+    uint objectIndex = gl_GlobalInvocationID.x;
+
+    if(objectIndex >= numObjects)
+    {
+        return;
+    }
+
+    if(useObjectVisibility && objectVisibility[objectIndex] == 0u)
+    {
+        return;
+    }
+
+    ObjectData object = objects[objectIndex];
+
+    /////////////////////////////////////////////////////////////////
+    // world space bounds, the extent is transformed by the absolute values of the matrix
+    mat3 linearPart = mat3(object.modelMatrix);
+    vec3 center = 0.5f * (object.boundsMin.xyz + object.boundsMax.xyz);
+    vec3 extent = 0.5f * (object.boundsMax.xyz - object.boundsMin.xyz);
+    vec3 worldCenter = (object.modelMatrix * vec4(center, 1.0f)).xyz;
+    vec3 worldExtent = abs(linearPart[0]) * extent.x + abs(linearPart[1]) * extent.y +
+                       abs(linearPart[2]) * extent.z;
+
+    for(int i = 0; i < 6; ++i)
+    {
+        float distance = dot(frustumPlanes[i].xyz, worldCenter) + frustumPlanes[i].w;
+        float radius = dot(abs(frustumPlanes[i].xyz), worldExtent);
+
+        if(distance + radius < 0.0f)
+        {
+            return;
+        }
+    }
+
+    /////////////////////////////////////////////////////////////////
+    // the first LOD whose distance range contains the object, the last one otherwise
+    float cameraDistance = length(worldCenter - cameraPosition);
+    int lod = object.firstLod + object.numLods - 1;
+
+    for(int i = object.firstLod; i < object.firstLod + object.numLods - 1; ++i)
+    {
+        if(cameraDistance < lodDistances[i])
+        {
+            lod = i;
+            break;
+        }
+    }
+
+    /////////////////////////////////////////////////////////////////
+    // output
+    uint instanceIndex = commands[lod].baseInstance + atomicAdd(commands[lod].instanceCount, 1u);
+    mat3 normalMatrix = transpose(inverse(linearPart));
+
+    for(int i = 0; i < 16; ++i)
+    {
+        instances[instanceIndex].modelMatrix[i] = object.modelMatrix[i / 4][i % 4];
+    }
+
+    for(int i = 0; i < 9; ++i)
+    {
+        instances[instanceIndex].normalMatrix[i] = normalMatrix[i / 3][i % 3];
+    }
+
+    instances[instanceIndex].materialIndex = object.materialIndex;
+}
@@ -0,0 +1,9 @@
+#version 400 core
+//------------------------------------------------------------------------------------------
+// fragment shader, depth pre-pass, the color writes are masked
+//------------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------------
+void main()
+{
+}
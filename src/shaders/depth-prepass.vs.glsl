@@ -0,0 +1,33 @@
+#version 400 core
+//------------------------------------------------------------------------------------------
+// vertex shader, depth pre-pass
+//------------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------------
+// uniforms
+layout(std140) uniform Matrices
+{
+    mat4 modelMatrix;
+    mat4 normalMatrix;
+    mat4 viewProjectionMatrix;
+    mat4 shadowMatrix;
+};
+
+//------------------------------------------------------------------------------------------
+// in variables, only the positions are fetched
+layout(location = ATTRIB_VERTEX) in vec3 v_coord;
+
+// per-instance attributes
+layout(location = ATTRIB_INSTANCE_MODEL_MATRIX) in mat4 i_modelMatrix;
+
+//------------------------------------------------------------------------------------------
+// out variables
+// the shading passes compute the same depth, they test it for equality
+invariant gl_Position;
+
+//------------------------------------------------------------------------------------------
+void main()
+{
+    vec4 worldCoord = i_modelMatrix * vec4(v_coord, 1.0);
+    gl_Position = viewProjectionMatrix * worldCoord;
+}
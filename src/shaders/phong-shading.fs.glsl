@@ -12,22 +12,53 @@ layout(std140) uniform Light
     float intensity;
 } light;
 
-layout(std140) uniform Material
+// the material of each instance is picked from the material array
+struct MaterialData
 {
     vec4 diffuseColor;
     vec4 specularColor;
     float reflection;
     float shininess;
-} material;
+    int colorLayer;
+    int normalLayer;
+};
+
+layout(std140) uniform Material
+{
+    MaterialData materials[NUM_MATERIALS];
+};
 
 uniform float ambientLight;
 
 // texture unit: objTex(colorMap) = 0, normalTex = 1, depthTex = 2
-uniform sampler2D objTex;
-uniform sampler2D normalTex;
+// the textures of all the materials are layers of the same arrays
+uniform sampler2DArray objTex;
+uniform sampler2DArray normalTex;
+
+// the cascades of the directional light shadow, the shadow coordinates are relative to the
+// first one, see ShadowCascadeData
+layout(std140) uniform Shadow
+{
+    vec4 cascadeScales[SHADOW_MAX_CASCADES];
+    vec4 cascadeOffsets[SHADOW_MAX_CASCADES];
+    vec4 cascadeSplits;
+    int numCascades;
+};
+
+uniform sampler2DArrayShadow depthTex;
+
+// feature flags are injected as defines, the branches on them are compiled out
+#ifdef UBER_SHADER
 uniform bool hasObjTex;
 uniform bool hasNormalTex;
 uniform bool needTangent;
+uniform bool hasDepthTex;
+#else
+const bool hasObjTex = bool(HAS_OBJ_TEX);
+const bool hasNormalTex = bool(HAS_NORMAL_TEX);
+const bool needTangent = bool(NEED_TANGENT);
+const bool hasDepthTex = bool(HAS_DEPTH_TEX);
+#endif
 
 //------------------------------------------------------------------------------------------
 // in variables
@@ -39,6 +70,7 @@ in GS_OUT
     vec2 f_texCoord;
     vec3 f_tangent;
     vec3 f_btangent;
+    flat int f_materialIndex;
 };
 
 //------------------------------------------------------------------------------------------
@@ -91,11 +123,55 @@ void calculateNormal(in vec3 vertexNormal,  in vec3 normalIn, out vec3 normalOut
     }
 }
 
+//------------------------------------------------------------------------------------------
+// two-channel (RGTC2) normal maps only store x and y, z is reconstructed
+vec3 fetchBumpNormal(in vec2 texCoord, in int layer)
+{
+#if RG_NORMAL_TEX
+    vec2 xy = 2.0 * texture(normalTex, vec3(texCoord, layer)).xy - vec2(1.0);
+    return vec3(xy, sqrt(max(1.0 - dot(xy, xy), 0.0)));
+#else
+    return 2.0 * texture(normalTex, vec3(texCoord, layer)).xyz - vec3(1.0);
+#endif
+}
+
+//------------------------------------------------------------------------------------------
+// the nearest cascade containing the fragment depth, 1 where no caster is mapped
+float computeShadow(in vec4 shadowCoord)
+{
+    if(numCascades == 0)
+    {
+        return 1.0f;
+    }
+
+    int cascade = numCascades - 1;
+
+    for(int i = 0; i < numCascades - 1; ++i)
+    {
+        if(gl_FragCoord.z <= cascadeSplits[i])
+        {
+            cascade = i;
+            break;
+        }
+    }
+
+    vec2 coord = shadowCoord.xy * cascadeScales[cascade].xy + cascadeOffsets[cascade].xy;
+
+    if(any(lessThan(coord, vec2(0.0))) || any(greaterThan(coord, vec2(1.0))) ||
+       shadowCoord.z > 1.0)
+    {
+        return 1.0f;
+    }
+
+    return texture(depthTex, vec4(coord, float(cascade), shadowCoord.z));
+}
+
 //------------------------------------------------------------------------------------------
 // If an object uses texture, it must set "GL_TRUE" to hasObjTex
 //------------------------------------------------------------------------------------------
 void main()
 {
+    MaterialData material = materials[f_materialIndex];
     vec3 normal = normalize(f_normal);
     vec3 lightDir = -normalize(vec3(light.direction));
     vec3 viewDir = normalize(f_viewDir);
@@ -118,13 +194,13 @@ void main()
                 btangent = cross(normal, tangent);
             }
 
-            vec3 bumpMapNormal = 2.0 * texture(normalTex, f_texCoord).xyz - vec3(1.0);
+            vec3 bumpMapNormal = fetchBumpNormal(f_texCoord, material.normalLayer);
             mat3 TBN = mat3(tangent, btangent, normal);
             normal = TBN * bumpMapNormal;
         }
         else
         {
-            calculateNormal(normalize(f_normal), 2.0 * texture(normalTex, f_texCoord).xyz - 1.0, normal);
+            calculateNormal(normalize(f_normal), fetchBumpNormal(f_texCoord, material.normalLayer), normal);
         }
         normal = normalize(normal);
     }
@@ -137,7 +213,7 @@ void main()
 
     if(hasObjTex)
     {
-        vec4 texVal = texture(objTex, f_texCoord);
+        vec4 texVal = texture(objTex, vec3(f_texCoord, material.colorLayer));
 
         surfaceColor = texVal.xyz;
         alpha = texVal.w;
@@ -153,7 +229,14 @@ void main()
     vec3 halfDir = normalize(lightDir + viewDir);
     specular = pow(max(dot(halfDir, normal), 0.0f), material.shininess) * vec3(material.specularColor);
 
+    float isNoShadow = 1.0f;
+
+    if(hasDepthTex)
+    {
+        isNoShadow = computeShadow(f_shadowCoord);
+    }
+
     /////////////////////////////////////////////////////////////////
     // output
-    fragColor = vec4(ambient + light.intensity * (diffuse + specular), alpha);
+    fragColor = vec4(ambient + isNoShadow * light.intensity * (diffuse + specular), alpha);
 }
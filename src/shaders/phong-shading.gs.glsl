@@ -15,7 +15,11 @@ layout(std140) uniform Matrices
     mat4 shadowMatrix;
 };
 
+#ifdef UBER_SHADER
 uniform bool needTangent;
+#else
+const bool needTangent = bool(NEED_TANGENT);
+#endif
 //------------------------------------------------------------------------------------------
 // in variables
 in VS_OUT
@@ -24,6 +28,7 @@ in VS_OUT
     vec3 f_normal;
     vec3 f_viewDir;
     vec2 f_texCoord;
+    flat int f_materialIndex;
 } v_in[];
 
 
@@ -37,6 +42,7 @@ out GS_OUT
     vec2 f_texCoord;
     vec3 f_tangent;
     vec3 f_btangent;
+    flat int f_materialIndex;
 };
 
 //------------------------------------------------------------------------------------------
@@ -84,6 +90,7 @@ void main()
         f_normal = v_in[i].f_normal;
         f_viewDir = v_in[i].f_viewDir;
         f_texCoord = v_in[i].f_texCoord;
+        f_materialIndex = v_in[i].f_materialIndex;
 
         f_tangent = tangent;
         f_btangent = btangent;
@@ -24,32 +24,75 @@ const mat4 scaleMatrix = mat4(vec4(0.5f, 0.0f, 0.0f, 0.0f),
 
 //------------------------------------------------------------------------------------------
 // in variables
-in vec3 v_coord;
-in vec3 v_normal;
-in vec2 v_texCoord;
+layout(location = ATTRIB_VERTEX) in vec3 v_coord;
+layout(location = ATTRIB_NORMAL) in vec3 v_normal;
+layout(location = ATTRIB_TEXCOORD) in vec2 v_texCoord;
+
+// per-instance attributes
+layout(location = ATTRIB_INSTANCE_MODEL_MATRIX) in mat4 i_modelMatrix;
+layout(location = ATTRIB_INSTANCE_NORMAL_MATRIX) in mat3 i_normalMatrix;
+layout(location = ATTRIB_INSTANCE_MATERIAL) in int i_materialIndex;
 
 //------------------------------------------------------------------------------------------
 // out variables
+#if GEOMETRY_TANGENT
+// the geometry stage computes the tangent frames per triangle and transforms the positions
 out VS_OUT
 {
     vec4 f_shadowCoord;
     vec3 f_normal;
     vec3 f_viewDir;
     vec2 f_texCoord;
+    flat int f_materialIndex;
+};
+#else
+#if VERTEX_TANGENT
+// tangent frames are precomputed per vertex, the output goes straight to the
+// fragment shader without the geometry stage
+layout(location = ATTRIB_TANGENT) in vec4 v_tangent;
+#endif
+
+out GS_OUT
+{
+    vec4 f_shadowCoord;
+    vec3 f_normal;
+    vec3 f_viewDir;
+    vec2 f_texCoord;
+    vec3 f_tangent;
+    vec3 f_btangent;
+    flat int f_materialIndex;
 };
+#endif
+
+// the same depth as the depth pre-pass, for the GL_EQUAL depth test
+invariant gl_Position;
 
 //------------------------------------------------------------------------------------------
 void main()
 {
-    vec4 worldCoord = modelMatrix * vec4(v_coord, 1.0);
+    vec4 worldCoord = i_modelMatrix * vec4(v_coord, 1.0);
 
     /////////////////////////////////////////////////////////////////
     // output
     f_shadowCoord = scaleMatrix * shadowMatrix * worldCoord;
     f_shadowCoord.w = 1;
-    f_normal = mat3(normalMatrix) * v_normal;
+    f_normal = i_normalMatrix * v_normal;
     f_viewDir = vec3(cameraPosition) - vec3(worldCoord);
     f_texCoord = v_texCoord;
+    f_materialIndex = i_materialIndex;
 
+#if GEOMETRY_TANGENT
     gl_Position = worldCoord;
+#else
+#if VERTEX_TANGENT
+    f_tangent = mat3(i_modelMatrix) * v_tangent.xyz;
+    f_btangent = v_tangent.w * cross(f_normal, f_tangent);
+#else
+    // no normal map is sampled
+    f_tangent = vec3(1, 0, 0);
+    f_btangent = vec3(0, 1, 0);
+#endif
+
+    gl_Position = viewProjectionMatrix * worldCoord;
+#endif
 }
@@ -15,13 +15,17 @@ layout(std140) uniform Matrices
 
 uniform float offset;
 //------------------------------------------------------------------------------------------
-in vec3 v_coord;
-in vec3 v_normal;
+layout(location = ATTRIB_VERTEX) in vec3 v_coord;
+layout(location = ATTRIB_NORMAL) in vec3 v_normal;
+
+// per-instance attributes
+layout(location = ATTRIB_INSTANCE_MODEL_MATRIX) in mat4 i_modelMatrix;
+layout(location = ATTRIB_INSTANCE_NORMAL_MATRIX) in mat3 i_normalMatrix;
 
 //------------------------------------------------------------------------------------------
 void main()
 {
-    vec4 worldCoord = modelMatrix * vec4(v_coord + offset*mat3(normalMatrix) * v_normal, 1.0f);
+    vec4 worldCoord = i_modelMatrix * vec4(v_coord + offset*i_normalMatrix * v_normal, 1.0f);
 
     /////////////////////////////////////////////////////////////////
     // output
@@ -12,18 +12,45 @@ layout(std140) uniform Light
     float intensity;
 } light;
 
-layout(std140) uniform Material
+// the material of each instance is picked from the material array
+struct MaterialData
 {
     vec4 diffuseColor;
     vec4 specularColor;
     float reflection;
     float shininess;
-} material;
+    int colorLayer;
+    int normalLayer;
+};
+
+layout(std140) uniform Material
+{
+    MaterialData materials[NUM_MATERIALS];
+};
 
 uniform float ambientLight;
 
-uniform sampler2DShadow depthTex;
+// light intensity quantization, texture unit: diffuseRamp = 3, specularRamp = 4
+uniform sampler1D diffuseRamp;
+uniform sampler1D specularRamp;
+
+// the cascades of the directional light shadow, the shadow coordinates are relative to the
+// first one, see ShadowCascadeData
+layout(std140) uniform Shadow
+{
+    vec4 cascadeScales[SHADOW_MAX_CASCADES];
+    vec4 cascadeOffsets[SHADOW_MAX_CASCADES];
+    vec4 cascadeSplits;
+    int numCascades;
+};
+
+uniform sampler2DArrayShadow depthTex;
+
+#ifdef UBER_SHADER
 uniform bool hasDepthTex;
+#else
+const bool hasDepthTex = bool(HAS_DEPTH_TEX);
+#endif
 
 //------------------------------------------------------------------------------------------
 // in variables
@@ -32,15 +59,48 @@ in VS_OUT
     vec4 f_shadowCoord;
     vec3 f_normal;
     vec3 f_viewDir;
+    flat int f_materialIndex;
 };
 
 //------------------------------------------------------------------------------------------
 // out variables
 out vec4 fragColor;
 
+//------------------------------------------------------------------------------------------
+// the nearest cascade containing the fragment depth, 1 where no caster is mapped
+float computeShadow(in vec4 shadowCoord)
+{
+    if(numCascades == 0)
+    {
+        return 1.0f;
+    }
+
+    int cascade = numCascades - 1;
+
+    for(int i = 0; i < numCascades - 1; ++i)
+    {
+        if(gl_FragCoord.z <= cascadeSplits[i])
+        {
+            cascade = i;
+            break;
+        }
+    }
+
+    vec2 coord = shadowCoord.xy * cascadeScales[cascade].xy + cascadeOffsets[cascade].xy;
+
+    if(any(lessThan(coord, vec2(0.0))) || any(greaterThan(coord, vec2(1.0))) ||
+       shadowCoord.z > 1.0)
+    {
+        return 1.0f;
+    }
+
+    return texture(depthTex, vec4(coord, float(cascade), shadowCoord.z));
+}
+
 //------------------------------------------------------------------------------------------
 void main()
 {
+    MaterialData material = materials[f_materialIndex];
     vec3 normal = normalize(f_normal);
     vec3 lightDir = -normalize(vec3(light.direction));
     vec3 viewDir = normalize(f_viewDir);
@@ -48,18 +108,8 @@ void main()
     vec3 surfaceColor = vec3(material.diffuseColor);
     vec3 ambient = ambientLight * surfaceColor;
 
-    float diffuseLight = max(dot(normal, lightDir), 0.0f);
-
-
-    // Discretize the intensity, based on a few cutoff points
-    if (diffuseLight > 0.95)
-        diffuseLight = 1.0;
-    else if (diffuseLight > 0.5)
-        diffuseLight = 0.7;
-    else if (diffuseLight > 0.05)
-        diffuseLight = 0.35;
-    else
-        diffuseLight = 0.0;
+    // Discretize the intensity by the band ramp
+    float diffuseLight = texture(diffuseRamp, max(dot(normal, lightDir), 0.0f)).r;
 
     vec3 diffuse = diffuseLight * surfaceColor;
 
@@ -67,25 +117,14 @@ void main()
     float isNoShadow = 1.0f;
 
     vec3 halfDir = normalize(lightDir + viewDir);
-    float specularLight = pow(max(dot(halfDir, normal), 0.0f), material.shininess);
-
-    if (specularLight > 0.98)
-        specularLight = 1.0;
-    else if (specularLight > 0.8)
-        specularLight = 0.7;
-    else if (specularLight > 0.4)
-        specularLight = 0.35;
-    else
-        specularLight = 0.0;
+    float specularLight = texture(specularRamp,
+                                  pow(max(dot(halfDir, normal), 0.0f), material.shininess)).r;
 
     specular = specularLight * vec3(material.specularColor);
 
     if(hasDepthTex)
     {
-        if(any(lessThan(vec3(f_shadowCoord), vec3(0.0))) )
-            isNoShadow = 1.0f;
-        else
-            isNoShadow = textureProj(depthTex, f_shadowCoord);
+        isNoShadow = computeShadow(f_shadowCoord);
     }
 
 
@@ -24,8 +24,13 @@ const mat4 scaleMatrix = mat4(vec4(0.5f, 0.0f, 0.0f, 0.0f),
 
 //------------------------------------------------------------------------------------------
 // in variables
-in vec3 v_coord;
-in vec3 v_normal;
+layout(location = ATTRIB_VERTEX) in vec3 v_coord;
+layout(location = ATTRIB_NORMAL) in vec3 v_normal;
+
+// per-instance attributes
+layout(location = ATTRIB_INSTANCE_MODEL_MATRIX) in mat4 i_modelMatrix;
+layout(location = ATTRIB_INSTANCE_NORMAL_MATRIX) in mat3 i_normalMatrix;
+layout(location = ATTRIB_INSTANCE_MATERIAL) in int i_materialIndex;
 
 //------------------------------------------------------------------------------------------
 // out variables
@@ -34,19 +39,24 @@ out VS_OUT
     vec4 f_shadowCoord;
     vec3 f_normal;
     vec3 f_viewDir;
+    flat int f_materialIndex;
 };
 
+// the same depth as the depth pre-pass, for the GL_EQUAL depth test
+invariant gl_Position;
+
 //------------------------------------------------------------------------------------------
 void main()
 {
-    vec4 worldCoord = modelMatrix * vec4(v_coord, 1.0);
+    vec4 worldCoord = i_modelMatrix * vec4(v_coord, 1.0);
 
     /////////////////////////////////////////////////////////////////
     // output
     f_shadowCoord = scaleMatrix * shadowMatrix * worldCoord;
     f_shadowCoord.w = 1;
-    f_normal = mat3(normalMatrix) * v_normal;
+    f_normal = i_normalMatrix * v_normal;
     f_viewDir = vec3(cameraPosition) - vec3(worldCoord);
+    f_materialIndex = i_materialIndex;
 
     gl_Position = viewProjectionMatrix * worldCoord;
 }
@@ -0,0 +1,460 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#include "shadowmap.h"
+
+//------------------------------------------------------------------------------------------
+ShadowMap::ShadowMap():
+    initialized(false),
+    resolution(SHADOW_MAP_RESOLUTION),
+    numCascades(1),
+    maxCascades(SHADOW_MAX_CASCADES),
+    dirty(true),
+    lightDirection(1.0f, -1.0f, -1.0f),
+    lightNear(0.0f),
+    lightFar(1.0f),
+    cascadeDataChanged(true),
+    depthTexture(0),
+    framebuffer(0),
+    savedFramebuffer(0)
+{
+    memset(&cascadeData, 0, sizeof(ShadowCascadeData));
+    memset(&stats, 0, sizeof(ShadowStats));
+    memset(savedViewport, 0, sizeof(savedViewport));
+    lightDirection.normalize();
+}
+
+//------------------------------------------------------------------------------------------
+ShadowMap::~ShadowMap()
+{
+}
+
+//------------------------------------------------------------------------------------------
+// an incomplete framebuffer falls back to a single cascade, then disables the shadows
+//------------------------------------------------------------------------------------------
+bool ShadowMap::initialize(int _resolution)
+{
+    initializeOpenGLFunctions();
+    resolution = _resolution;
+
+    GLint currentFramebuffer;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &currentFramebuffer);
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+
+    maxCascades = SHADOW_MAX_CASCADES;
+
+    if(!createDepthTexture(maxCascades))
+    {
+        maxCascades = 1;
+
+        if(!createDepthTexture(maxCascades))
+        {
+            maxCascades = 0;
+        }
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, currentFramebuffer);
+
+    if(maxCascades == 0)
+    {
+        glDeleteFramebuffers(1, &framebuffer);
+        framebuffer = 0;
+        qDebug() << "Shadow map: no complete framebuffer, the shadows are disabled";
+    }
+    else if(maxCascades < SHADOW_MAX_CASCADES)
+    {
+        qDebug() << "Shadow map: falling back to" << maxCascades << "cascade";
+    }
+
+    numCascades = qMin(numCascades, maxCascades);
+    initialized = (maxCascades > 0);
+    dirty = true;
+
+    return initialized;
+}
+
+//------------------------------------------------------------------------------------------
+// with the framebuffer bound, every layer is attached once to check it and clear it, the
+// texture is deleted again if one is incomplete
+//------------------------------------------------------------------------------------------
+bool ShadowMap::createDepthTexture(int _numLayers)
+{
+    glGenTextures(1, &depthTexture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, depthTexture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT32F, resolution, resolution,
+                 _numLayers, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    // nothing is shadowed until the first update
+    glClearDepth(1.0);
+
+    for(int i = 0; i < _numLayers; ++i)
+    {
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthTexture, 0, i);
+        GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+
+        if(status != GL_FRAMEBUFFER_COMPLETE)
+        {
+            qDebug() << "Shadow map: incomplete framebuffer with" << _numLayers <<
+                     "layers, status" << QString::number(status, 16);
+            glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, 0, 0);
+            glDeleteTextures(1, &depthTexture);
+            depthTexture = 0;
+            return false;
+        }
+
+        glClear(GL_DEPTH_BUFFER_BIT);
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+bool ShadowMap::isInitialized()
+{
+    return initialized;
+}
+
+//------------------------------------------------------------------------------------------
+void ShadowMap::setNumCascades(int _numCascades)
+{
+    _numCascades = qBound(0, _numCascades, maxCascades);
+
+    if(_numCascades == numCascades)
+    {
+        return;
+    }
+
+    numCascades = _numCascades;
+    invalidate();
+}
+
+//------------------------------------------------------------------------------------------
+int ShadowMap::getNumCascades()
+{
+    return numCascades;
+}
+
+//------------------------------------------------------------------------------------------
+void ShadowMap::setLightDirection(const QVector3D& _direction)
+{
+    QVector3D direction = _direction.normalized();
+
+    if(direction == lightDirection)
+    {
+        return;
+    }
+
+    lightDirection = direction;
+    invalidate();
+}
+
+//------------------------------------------------------------------------------------------
+void ShadowMap::setCasterBounds(const AABB& _bounds)
+{
+    if(_bounds.minPoint == casterBounds.minPoint &&
+       _bounds.maxPoint == casterBounds.maxPoint)
+    {
+        return;
+    }
+
+    casterBounds = _bounds;
+    invalidate();
+}
+
+//------------------------------------------------------------------------------------------
+void ShadowMap::invalidate()
+{
+    dirty = true;
+}
+
+//------------------------------------------------------------------------------------------
+int ShadowMap::beginUpdate(const QMatrix4x4& _viewMatrix,
+                           const QMatrix4x4& _projectionMatrix)
+{
+    cascadeDataChanged = false;
+
+    if(!initialized || numCascades == 0 ||
+       casterBounds.minPoint.x() > casterBounds.maxPoint.x())
+    {
+        return 0;
+    }
+
+    ++stats.numUpdates;
+
+    /////////////////////////////////////////////////////////////////
+    // the reference frame only depends on the light and the casters
+    if(dirty)
+    {
+        QVector3D up = (qAbs(lightDirection.y()) > 0.99f) ? QVector3D(1.0f, 0.0f, 0.0f) :
+                       QVector3D(0.0f, 1.0f, 0.0f);
+        lightViewMatrix.setToIdentity();
+        lightViewMatrix.lookAt(QVector3D(0.0f, 0.0f, 0.0f), lightDirection, up);
+
+        // the light looks down -z
+        AABB lightBounds = casterBounds.transformed(lightViewMatrix)
+                           .fattened(SHADOW_DEPTH_MARGIN);
+        referenceBox = QVector4D(lightBounds.minPoint.x(), lightBounds.maxPoint.x(),
+                                 lightBounds.minPoint.y(), lightBounds.maxPoint.y());
+        lightNear = -lightBounds.maxPoint.z();
+        lightFar = -lightBounds.minPoint.z();
+
+        shadowMatrix = getLightProjection(referenceBox) * lightViewMatrix;
+        cascadeDataChanged = true;
+    }
+
+    fitCascades(_viewMatrix, _projectionMatrix);
+
+    /////////////////////////////////////////////////////////////////
+    // only the cascades whose fit changed are rendered
+    int cascadeMask = 0;
+
+    for(int i = 0; i < numCascades; ++i)
+    {
+        if(dirty || cascadeBoxes[i] != renderedBoxes[i])
+        {
+            cascadeMask |= (1 << i);
+            cascadeMatrices[i] = getLightProjection(cascadeBoxes[i]) * lightViewMatrix;
+        }
+    }
+
+    dirty = false;
+
+    stats.numRenderedCascades = 0;
+
+    for(int i = 0; i < numCascades; ++i)
+    {
+        if(cascadeMask & (1 << i))
+        {
+            ++stats.numRenderedCascades;
+        }
+    }
+
+    if(cascadeMask == 0)
+    {
+        ++stats.numCachedUpdates;
+        return 0;
+    }
+
+    /////////////////////////////////////////////////////////////////
+    // store the cascade scale and offset relative to the reference texture space
+    for(int i = 0; i < numCascades; ++i)
+    {
+        const QVector4D& box = cascadeBoxes[i];
+        float width = box.y() - box.x();
+        float height = box.w() - box.z();
+
+        cascadeData.scales[i][0] = (referenceBox.y() - referenceBox.x()) / width;
+        cascadeData.scales[i][1] = (referenceBox.w() - referenceBox.z()) / height;
+        cascadeData.scales[i][2] = 1.0f;
+        cascadeData.scales[i][3] = 1.0f;
+
+        cascadeData.offsets[i][0] = (referenceBox.x() - box.x()) / width;
+        cascadeData.offsets[i][1] = (referenceBox.z() - box.z()) / height;
+        cascadeData.offsets[i][2] = 0.0f;
+        cascadeData.offsets[i][3] = 0.0f;
+    }
+
+    cascadeDataChanged = true;
+
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &savedFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, savedViewport);
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, resolution, resolution);
+    glDepthMask(GL_TRUE);
+
+    return cascadeMask;
+}
+
+//------------------------------------------------------------------------------------------
+const QMatrix4x4& ShadowMap::beginCascade(int _cascade)
+{
+    Q_ASSERT(_cascade >= 0 && _cascade < numCascades);
+
+    glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthTexture, 0,
+                              _cascade);
+    glClear(GL_DEPTH_BUFFER_BIT);
+
+    renderedBoxes[_cascade] = cascadeBoxes[_cascade];
+
+    return cascadeMatrices[_cascade];
+}
+
+//------------------------------------------------------------------------------------------
+void ShadowMap::endUpdate()
+{
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, savedFramebuffer);
+    glViewport(savedViewport[0], savedViewport[1], savedViewport[2], savedViewport[3]);
+}
+
+//------------------------------------------------------------------------------------------
+const QMatrix4x4& ShadowMap::getShadowMatrix()
+{
+    return shadowMatrix;
+}
+
+//------------------------------------------------------------------------------------------
+const ShadowCascadeData& ShadowMap::getCascadeData()
+{
+    return cascadeData;
+}
+
+//------------------------------------------------------------------------------------------
+bool ShadowMap::hasCascadeDataChanged()
+{
+    return cascadeDataChanged;
+}
+
+//------------------------------------------------------------------------------------------
+GLuint ShadowMap::getDepthTexture()
+{
+    return depthTexture;
+}
+
+//------------------------------------------------------------------------------------------
+const ShadowStats& ShadowMap::getStats()
+{
+    return stats;
+}
+
+//------------------------------------------------------------------------------------------
+// split the view frustum between the near plane and the farthest caster, blending the
+// logarithmic and uniform split distances; the shadow distance and the cascade sizes are
+// quantized so they stay the same while the camera moves a little
+//------------------------------------------------------------------------------------------
+void ShadowMap::fitCascades(const QMatrix4x4& _viewMatrix,
+                            const QMatrix4x4& _projectionMatrix)
+{
+    float splits[SHADOW_MAX_CASCADES];
+
+    if(numCascades == 1)
+    {
+        cascadeBoxes[0] = referenceBox;
+        splits[0] = 1.0f;
+    }
+    else
+    {
+        float P22 = _projectionMatrix(2, 2);
+        float P23 = _projectionMatrix(2, 3);
+        float cameraNear = P23 / (P22 - 1.0f);
+        float cameraFar = P23 / (P22 + 1.0f);
+
+        QVector3D cameraPosition = _viewMatrix.inverted().map(QVector3D(0.0f, 0.0f, 0.0f));
+        float casterRadius = casterBounds.getExtent().length();
+        float quantum = qMax(casterRadius / 16.0f, cameraNear);
+        float shadowDistance = cameraPosition.distanceToPoint(casterBounds.getCenter()) +
+                               casterRadius;
+        shadowDistance = ceil(shadowDistance / quantum) * quantum;
+        shadowDistance = qBound(2.0f * cameraNear, shadowDistance, cameraFar);
+
+        QMatrix4x4 inverseViewProjection = (_projectionMatrix * _viewMatrix).inverted();
+        float previousDepth = -1.0f;
+
+        for(int i = 0; i < numCascades; ++i)
+        {
+            float t = float(i + 1) / float(numCascades);
+            float logDistance = cameraNear * pow(shadowDistance / cameraNear, t);
+            float uniformDistance = cameraNear + (shadowDistance - cameraNear) * t;
+            float distance = SHADOW_CASCADE_SPLIT_LAMBDA * logDistance +
+                             (1.0f - SHADOW_CASCADE_SPLIT_LAMBDA) * uniformDistance;
+
+            // normalized device depth of the view distance
+            float depth = -P22 + P23 / distance;
+            cascadeBoxes[i] = fitCascade(inverseViewProjection, previousDepth, depth);
+            splits[i] = 0.5f * depth + 0.5f;
+            previousDepth = depth;
+        }
+
+        // the farthest cascade also covers the fragments beyond the shadow distance, their
+        // coordinates fall outside of it when no caster can reach them
+        splits[numCascades - 1] = 1.0f;
+    }
+
+    for(int i = 0; i < SHADOW_MAX_CASCADES; ++i)
+    {
+        float split = (i < numCascades) ? splits[i] : 1.0f;
+
+        if(cascadeData.splits[i] != split)
+        {
+            cascadeData.splits[i] = split;
+            cascadeDataChanged = true;
+        }
+    }
+
+    if(cascadeData.numCascades != numCascades)
+    {
+        cascadeData.numCascades = numCascades;
+        cascadeDataChanged = true;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// the box of the bounding sphere of the frustum slice, in light space: the sphere does not
+// change with the camera rotation, its center is snapped to the texels so the camera
+// translation only moves the map by whole texels
+//------------------------------------------------------------------------------------------
+QVector4D ShadowMap::fitCascade(const QMatrix4x4& _inverseViewProjection, float _nearDepth,
+                                float _farDepth)
+{
+    QVector3D corners[8];
+    QVector3D center(0.0f, 0.0f, 0.0f);
+
+    for(int i = 0; i < 8; ++i)
+    {
+        QVector3D ndc((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f,
+                      (i & 4) ? _farDepth : _nearDepth);
+        corners[i] = _inverseViewProjection.map(ndc);
+        center += corners[i];
+    }
+
+    center /= 8.0f;
+    float radius = 0.0f;
+
+    for(int i = 0; i < 8; ++i)
+    {
+        radius = qMax(radius, center.distanceToPoint(corners[i]));
+    }
+
+    float referenceSize = qMax(referenceBox.y() - referenceBox.x(),
+                               referenceBox.w() - referenceBox.z());
+    float quantum = referenceSize / 64.0f;
+    radius = ceil(radius / quantum) * quantum;
+
+    // no better than the whole casters
+    if(2.0f * radius >= referenceSize)
+    {
+        return referenceBox;
+    }
+
+    float texelSize = 2.0f * radius / float(resolution);
+    QVector3D lightCenter = lightViewMatrix.map(center);
+    float x = floor(lightCenter.x() / texelSize) * texelSize;
+    float y = floor(lightCenter.y() / texelSize) * texelSize;
+
+    return QVector4D(x - radius, x + radius, y - radius, y + radius);
+}
+
+//------------------------------------------------------------------------------------------
+QMatrix4x4 ShadowMap::getLightProjection(const QVector4D& _box)
+{
+    QMatrix4x4 projection;
+    projection.ortho(_box.x(), _box.y(), _box.z(), _box.w(), lightNear, lightFar);
+
+    return projection;
+}
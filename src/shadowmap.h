@@ -0,0 +1,136 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#ifndef SHADOWMAP_H
+#define SHADOWMAP_H
+
+#include <QtGui>
+#include <QOpenGLFunctions_4_0_Core>
+
+#include "frustum.h"
+
+#define SHADOW_MAP_RESOLUTION 2048
+#define SHADOW_MAX_CASCADES 4 // the split depths fit in a vec4
+#define SHADOW_CASCADE_SPLIT_LAMBDA 0.75f // blend of the logarithmic and uniform splits
+#define SHADOW_DEPTH_MARGIN 0.01f // relative to the caster depth range
+#define SHADOW_POLYGON_OFFSET_FACTOR 2.0f
+#define SHADOW_POLYGON_OFFSET_UNITS 4.0f
+
+//------------------------------------------------------------------------------------------
+// std140 layout of the Shadow uniform block of the shading programs: the shadow
+// coordinates are computed in the texture space of the reference shadow matrix, each
+// cascade only scales and offsets them since all share the light orientation and the
+// depth range
+struct ShadowCascadeData
+{
+    GLfloat scales[SHADOW_MAX_CASCADES][4];
+    GLfloat offsets[SHADOW_MAX_CASCADES][4];
+    GLfloat splits[4]; // window depth of the far end of each cascade
+    GLint numCascades;
+    GLint padding[3];
+};
+
+//------------------------------------------------------------------------------------------
+struct ShadowStats
+{
+    int numRenderedCascades; // by the last update
+    int numCachedUpdates;    // nothing had to be rendered
+    int numUpdates;
+};
+
+//------------------------------------------------------------------------------------------
+// Depth maps of a directional light, one layer of a depth texture array per cascade, and
+// the cache deciding when they have to be rendered again.
+// With a single cascade, the map is fitted to the bounds of the casters, so it only
+// depends on the light direction and the casters: it is rendered once and reused until
+// one of them changes. With more cascades, the view frustum is split and each slice gets
+// its own map, fitted to the bounding sphere of the slice so the rotations of the camera
+// do not change its size, and snapped to its texels so the small moves of the camera do
+// not change it either. Only the cascades whose fit changed are rendered, mostly the near
+// ones, while the camera moves.
+// The caller draws the casters of each cascade to be rendered:
+//     int cascades = shadowMap.beginUpdate(viewMatrix, projectionMatrix);
+//     for each bit i of cascades: draw with shadowMap.beginCascade(i)
+//     if(cascades) shadowMap.endUpdate();
+//------------------------------------------------------------------------------------------
+class ShadowMap : protected QOpenGLFunctions_4_0_Core
+{
+public:
+    ShadowMap();
+    ~ShadowMap();
+
+    // with a current OpenGL context, return false if no depth framebuffer is complete
+    bool initialize(int _resolution = SHADOW_MAP_RESOLUTION);
+    bool isInitialized();
+
+    // 0 disables the shadows, clamped to the cascades the framebuffer supports
+    void setNumCascades(int _numCascades);
+    int getNumCascades();
+
+    // the cached depth is rendered again by the next update if they changed
+    void setLightDirection(const QVector3D& _direction);
+    void setCasterBounds(const AABB& _bounds);
+    void invalidate();
+
+    // fit the cascades to the camera, return the bit mask of the cascades to be rendered,
+    // 0 while the cached depth stays valid
+    int beginUpdate(const QMatrix4x4& _viewMatrix, const QMatrix4x4& _projectionMatrix);
+    // bind the layer of the cascade as depth target and clear it, the casters are drawn
+    // with the returned matrix
+    const QMatrix4x4& beginCascade(int _cascade);
+    // restore the framebuffer and viewport of the caller
+    void endUpdate();
+
+    // world to light clip space, of the reference the cascades are relative to
+    const QMatrix4x4& getShadowMatrix();
+    const ShadowCascadeData& getCascadeData();
+    // by the last update, the uniform block must then be uploaded again
+    bool hasCascadeDataChanged();
+
+    // GL_TEXTURE_2D_ARRAY, with the comparison mode for sampler2DArrayShadow
+    GLuint getDepthTexture();
+    const ShadowStats& getStats();
+
+private:
+    bool createDepthTexture(int _numLayers);
+    void fitCascades(const QMatrix4x4& _viewMatrix, const QMatrix4x4& _projectionMatrix);
+    QVector4D fitCascade(const QMatrix4x4& _inverseViewProjection, float _nearDepth,
+                         float _farDepth);
+    QMatrix4x4 getLightProjection(const QVector4D& _box);
+
+    bool initialized;
+    int resolution;
+    int numCascades;
+    int maxCascades;
+    bool dirty;
+
+    QVector3D lightDirection;
+    AABB casterBounds;
+
+    // light space, the boxes are (left, right, bottom, top)
+    QMatrix4x4 lightViewMatrix;
+    QVector4D referenceBox;
+    float lightNear;
+    float lightFar;
+    QMatrix4x4 shadowMatrix;
+
+    QVector4D cascadeBoxes[SHADOW_MAX_CASCADES];
+    QVector4D renderedBoxes[SHADOW_MAX_CASCADES];
+    QMatrix4x4 cascadeMatrices[SHADOW_MAX_CASCADES];
+    ShadowCascadeData cascadeData;
+    bool cascadeDataChanged;
+
+    GLuint depthTexture;
+    GLuint framebuffer;
+    GLint savedFramebuffer;
+    GLint savedViewport[4];
+
+    ShadowStats stats;
+};
+
+#endif // SHADOWMAP_H
@@ -0,0 +1,552 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#include "stressmesh.h"
+#include "tracer.h"
+
+#define HIGH_GENUS_FACE_SUBDIVISION 4
+#define THIN_FEATURE_SPIKE_SIDES 6
+#define THIN_FEATURE_SPIKE_RADIUS 0.012f
+
+//------------------------------------------------------------------------------------------
+void StressMesh::generate(StressMeshType _type, int _level, cyTriMesh* _mesh)
+{
+    TRACE_SCOPE("generateStressMesh");
+
+    switch(_type)
+    {
+    case STRESS_ICOSPHERE:
+        generateIcosphere(_level, _mesh);
+        break;
+
+    case STRESS_BLOB:
+        generateBlob(_level, _mesh);
+        break;
+
+    case STRESS_HIGH_GENUS:
+        generateHighGenus(_level, _mesh);
+        break;
+
+    case STRESS_THIN_FEATURES:
+        generateThinFeatures(_level, _mesh);
+        break;
+
+    default:
+        _mesh->Clear();
+    }
+}
+
+//------------------------------------------------------------------------------------------
+QString StressMesh::getName(StressMeshType _type)
+{
+    switch(_type)
+    {
+    case STRESS_ICOSPHERE:
+        return QString("icosphere");
+
+    case STRESS_BLOB:
+        return QString("blob");
+
+    case STRESS_HIGH_GENUS:
+        return QString("genus");
+
+    case STRESS_THIN_FEATURES:
+        return QString("thin");
+
+    default:
+        return QString();
+    }
+}
+
+//------------------------------------------------------------------------------------------
+qint64 StressMesh::getNumTriangles(StressMeshType _type, int _level)
+{
+    qint64 numIcosphereTriangles = 20LL << (2 * _level);
+
+    switch(_type)
+    {
+    case STRESS_ICOSPHERE:
+    case STRESS_BLOB:
+        return numIcosphereTriangles;
+
+    case STRESS_HIGH_GENUS:
+    {
+        // top and bottom of the solid cells, outer border and walls of the holes
+        qint64 numHoles = 2 * qMax(1, _level);
+        qint64 numCells = 2 * numHoles + 1;
+        qint64 numFaces = 2 * (numCells * numCells - numHoles * numHoles) + 4 * numCells +
+                          4 * numHoles * numHoles;
+        return numFaces * 2 * HIGH_GENUS_FACE_SUBDIVISION * HIGH_GENUS_FACE_SUBDIVISION;
+    }
+
+    case STRESS_THIN_FEATURES:
+        return (numIcosphereTriangles << 4) +
+               (numIcosphereTriangles / 2 + 2) * THIN_FEATURE_SPIKE_SIDES;
+
+    default:
+        return 0;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+void StressMesh::generateIcosphere(int _level, cyTriMesh* _mesh)
+{
+    QVector<cyPoint3f> vertices;
+    QVector<cyTriMesh::cyTriFace> faces;
+    buildIcosphere(_level, vertices, faces);
+
+    QVector<cyPoint3f> texCoords;
+    QVector<cyTriMesh::cyTriFace> texFaces = faces;
+    computeSphericalTexCoords(vertices, texCoords, texFaces);
+
+    setMesh(vertices, faces, texCoords, texFaces, _mesh);
+}
+
+//------------------------------------------------------------------------------------------
+// the displacement is radial, the texture coordinates of the sphere are kept
+//------------------------------------------------------------------------------------------
+void StressMesh::generateBlob(int _level, cyTriMesh* _mesh)
+{
+    QVector<cyPoint3f> vertices;
+    QVector<cyTriMesh::cyTriFace> faces;
+    buildIcosphere(_level, vertices, faces);
+
+    QVector<cyPoint3f> texCoords;
+    QVector<cyTriMesh::cyTriFace> texFaces = faces;
+    computeSphericalTexCoords(vertices, texCoords, texFaces);
+
+    for(int i = 0; i < vertices.size(); ++i)
+    {
+        float noise = fractalNoise(vertices[i] * 3.0f + cyPoint3f(17.3f, 5.1f, 9.7f), 6);
+        vertices[i] *= 1.0f + 0.35f * noise;
+    }
+
+    setMesh(vertices, faces, texCoords, texFaces, _mesh);
+}
+
+//------------------------------------------------------------------------------------------
+// The plate is one cell thick, made of (2 * numHoles + 1)^2 cubic cells where the cells at
+// odd (column, row) are removed. The holes never touch each other along an edge, so the
+// boundary of the solid cells is a closed 2-manifold of genus numHoles^2. The vertices live
+// on a lattice HIGH_GENUS_FACE_SUBDIVISION times finer than the cells.
+//------------------------------------------------------------------------------------------
+void StressMesh::generateHighGenus(int _level, cyTriMesh* _mesh)
+{
+    const int numHoles = 2 * qMax(1, _level);
+    const int numCells = 2 * numHoles + 1;
+    const int s = HIGH_GENUS_FACE_SUBDIVISION;
+    const qint64 latticeSize = (qint64) numCells * s + 1;
+
+    // origin and the two edge directions of the faces of a cell, (a x b) points outward,
+    // in the order +x, -x, +y, -y, +z, -z
+    static const int faceOrigin[6][3] = {{1, 0, 0}, {0, 0, 0}, {0, 1, 0},
+        {0, 0, 0}, {0, 0, 1}, {0, 0, 0}
+    };
+    static const int faceA[6][3] = {{0, 1, 0}, {0, 0, 1}, {0, 0, 1},
+        {1, 0, 0}, {1, 0, 0}, {0, 1, 0}
+    };
+    static const int faceB[6][3] = {{0, 0, 1}, {0, 1, 0}, {1, 0, 0},
+        {0, 0, 1}, {0, 1, 0}, {1, 0, 0}
+    };
+    static const int neighbor[6][2] = {{1, 0}, { -1, 0}, {0, 0}, {0, 0}, {0, 1}, {0, -1}};
+
+    QVector<cyPoint3f> vertices;
+    QVector<cyTriMesh::cyTriFace> faces;
+    QHash<qint64, unsigned int> vertexMap;
+    faces.reserve(getNumTriangles(STRESS_HIGH_GENUS, _level));
+
+    for(int column = 0; column < numCells; ++column)
+    {
+        for(int row = 0; row < numCells; ++row)
+        {
+            if((column & 1) && (row & 1))
+            {
+                continue;
+            }
+
+            for(int face = 0; face < 6; ++face)
+            {
+                // the top and bottom faces are always exposed
+                if(face != 2 && face != 3)
+                {
+                    int neighborColumn = column + neighbor[face][0];
+                    int neighborRow = row + neighbor[face][1];
+
+                    if(neighborColumn >= 0 && neighborColumn < numCells &&
+                       neighborRow >= 0 && neighborRow < numCells &&
+                       !((neighborColumn & 1) && (neighborRow & 1)))
+                    {
+                        continue;
+                    }
+                }
+
+                unsigned int quad[s + 1][s + 1];
+
+                for(int a = 0; a <= s; ++a)
+                {
+                    for(int b = 0; b <= s; ++b)
+                    {
+                        qint64 x = (column + faceOrigin[face][0]) * s + a * faceA[face][0] + b *
+                                   faceB[face][0];
+                        qint64 y = faceOrigin[face][1] * s + a * faceA[face][1] + b * faceB[face][1];
+                        qint64 z = (row + faceOrigin[face][2]) * s + a * faceA[face][2] + b *
+                                   faceB[face][2];
+                        qint64 key = (x * (s + 1) + y) * latticeSize + z;
+
+                        QHash<qint64, unsigned int>::const_iterator it = vertexMap.constFind(key);
+
+                        if(it != vertexMap.constEnd())
+                        {
+                            quad[a][b] = it.value();
+                        }
+                        else
+                        {
+                            quad[a][b] = vertices.size();
+                            vertexMap.insert(key, quad[a][b]);
+                            vertices.append(cyPoint3f(x, y, z) / (float) s);
+                        }
+                    }
+                }
+
+                for(int a = 0; a < s; ++a)
+                {
+                    for(int b = 0; b < s; ++b)
+                    {
+                        cyTriMesh::cyTriFace triangle;
+                        triangle.v[0] = quad[a][b];
+                        triangle.v[1] = quad[a + 1][b];
+                        triangle.v[2] = quad[a + 1][b + 1];
+                        faces.append(triangle);
+
+                        triangle.v[1] = quad[a + 1][b + 1];
+                        triangle.v[2] = quad[a][b + 1];
+                        faces.append(triangle);
+                    }
+                }
+            }
+        }
+    }
+
+    // (x + y, z + y) is not degenerated on any axis aligned face
+    QVector<cyPoint3f> texCoords(vertices.size());
+
+    for(int i = 0; i < vertices.size(); ++i)
+    {
+        texCoords[i] = cyPoint3f(vertices[i].x + vertices[i].y,
+                                 vertices[i].z + vertices[i].y, 0) / (float) numCells;
+        vertices[i] -= cyPoint3f(0.5f * numCells, 0.5f, 0.5f * numCells);
+    }
+
+    setMesh(vertices, faces, texCoords, faces, _mesh);
+}
+
+//------------------------------------------------------------------------------------------
+// The spikes are open cones stuck into the body, a few pixels wide on screen: their
+// silhouettes are thin slivers and their tips are pixel sized.
+//------------------------------------------------------------------------------------------
+void StressMesh::generateThinFeatures(int _level, cyTriMesh* _mesh)
+{
+    QVector<cyPoint3f> vertices;
+    QVector<cyTriMesh::cyTriFace> faces;
+    buildIcosphere(_level + 2, vertices, faces);
+
+    QVector<cyPoint3f> texCoords;
+    QVector<cyTriMesh::cyTriFace> texFaces = faces;
+    computeSphericalTexCoords(vertices, texCoords, texFaces);
+
+    QVector<cyPoint3f> directions;
+    QVector<cyTriMesh::cyTriFace> directionFaces;
+    buildIcosphere(_level, directions, directionFaces);
+
+    const int numSides = THIN_FEATURE_SPIKE_SIDES;
+    const float PI = 3.14159265358979f;
+
+    for(int spike = 0; spike < directions.size(); ++spike)
+    {
+        cyPoint3f direction = directions[spike];
+        cyPoint3f tangent = direction.Cross(fabs(direction.x) < 0.9f ?
+                                            cyPoint3f(1, 0, 0) : cyPoint3f(0, 1, 0)).GetNormalized();
+        cyPoint3f bitangent = direction.Cross(tangent);
+        float length = 0.6f + 0.4f * latticeValue(spike, 0, 0);
+
+        unsigned int firstVertex = vertices.size();
+        unsigned int firstTexCoord = texCoords.size();
+
+        for(int side = 0; side < numSides; ++side)
+        {
+            float angle = 2.0f * PI * side / numSides;
+            vertices.append(direction * 0.95f + (tangent * cos(angle) + bitangent * sin(angle)) *
+                            THIN_FEATURE_SPIKE_RADIUS);
+            texCoords.append(cyPoint3f((float) side / numSides, 0, 0));
+        }
+
+        vertices.append(direction * (1.0f + length));
+        texCoords.append(cyPoint3f(1, 0, 0));
+
+        for(int side = 0; side < numSides; ++side)
+        {
+            texCoords.append(cyPoint3f((side + 0.5f) / numSides, 1, 0));
+        }
+
+        for(int side = 0; side < numSides; ++side)
+        {
+            int next = side + 1;
+
+            cyTriMesh::cyTriFace triangle;
+            triangle.v[0] = firstVertex + side;
+            triangle.v[1] = firstVertex + next % numSides;
+            triangle.v[2] = firstVertex + numSides;
+            faces.append(triangle);
+
+            triangle.v[0] = firstTexCoord + side;
+            triangle.v[1] = firstTexCoord + next;
+            triangle.v[2] = firstTexCoord + numSides + 1 + side;
+            texFaces.append(triangle);
+        }
+    }
+
+    setMesh(vertices, faces, texCoords, texFaces, _mesh);
+}
+
+//------------------------------------------------------------------------------------------
+// unit icosphere, each subdivision splits every triangle in 4 at the edge midpoints
+//------------------------------------------------------------------------------------------
+void StressMesh::buildIcosphere(int _level, QVector<cyPoint3f>& _vertices,
+                                QVector<cyTriMesh::cyTriFace>& _faces)
+{
+    const float t = (1.0f + sqrt(5.0f)) / 2.0f;
+    static const int icosahedronFaces[20][3] =
+    {
+        {0, 11, 5}, {0, 5, 1}, {0, 1, 7}, {0, 7, 10}, {0, 10, 11},
+        {1, 5, 9}, {5, 11, 4}, {11, 10, 2}, {10, 7, 6}, {7, 1, 8},
+        {3, 9, 4}, {3, 4, 2}, {3, 2, 6}, {3, 6, 8}, {3, 8, 9},
+        {4, 9, 5}, {2, 4, 11}, {6, 2, 10}, {8, 6, 7}, {9, 8, 1}
+    };
+
+    _vertices.clear();
+    _vertices.append(cyPoint3f(-1, t, 0));
+    _vertices.append(cyPoint3f(1, t, 0));
+    _vertices.append(cyPoint3f(-1, -t, 0));
+    _vertices.append(cyPoint3f(1, -t, 0));
+    _vertices.append(cyPoint3f(0, -1, t));
+    _vertices.append(cyPoint3f(0, 1, t));
+    _vertices.append(cyPoint3f(0, -1, -t));
+    _vertices.append(cyPoint3f(0, 1, -t));
+    _vertices.append(cyPoint3f(t, 0, -1));
+    _vertices.append(cyPoint3f(t, 0, 1));
+    _vertices.append(cyPoint3f(-t, 0, -1));
+    _vertices.append(cyPoint3f(-t, 0, 1));
+
+    for(int i = 0; i < _vertices.size(); ++i)
+    {
+        _vertices[i].Normalize();
+    }
+
+    _faces.resize(20);
+
+    for(int i = 0; i < 20; ++i)
+    {
+        for(int j = 0; j < 3; ++j)
+        {
+            _faces[i].v[j] = icosahedronFaces[i][j];
+        }
+    }
+
+    for(int level = 0; level < _level; ++level)
+    {
+        // V - E + F = 2 and E = 3F / 2
+        QVector<cyTriMesh::cyTriFace> faces(_faces.size() * 4);
+        QHash<quint64, unsigned int> midpoints;
+        midpoints.reserve(_faces.size() * 3 / 2);
+        _vertices.reserve(_vertices.size() + _faces.size() * 3 / 2);
+
+        for(int i = 0; i < _faces.size(); ++i)
+        {
+            unsigned int midpoint[3];
+
+            for(int j = 0; j < 3; ++j)
+            {
+                unsigned int v0 = _faces[i].v[j];
+                unsigned int v1 = _faces[i].v[(j + 1) % 3];
+                quint64 key = ((quint64) qMin(v0, v1) << 32) | qMax(v0, v1);
+
+                QHash<quint64, unsigned int>::const_iterator it = midpoints.constFind(key);
+
+                if(it != midpoints.constEnd())
+                {
+                    midpoint[j] = it.value();
+                }
+                else
+                {
+                    midpoint[j] = _vertices.size();
+                    midpoints.insert(key, midpoint[j]);
+                    _vertices.append((_vertices[v0] + _vertices[v1]).GetNormalized());
+                }
+            }
+
+            cyTriMesh::cyTriFace* face = faces.data() + 4 * i;
+
+            for(int j = 0; j < 3; ++j)
+            {
+                face[j].v[0] = _faces[i].v[j];
+                face[j].v[1] = midpoint[j];
+                face[j].v[2] = midpoint[(j + 2) % 3];
+            }
+
+            for(int j = 0; j < 3; ++j)
+            {
+                face[3].v[j] = midpoint[j];
+            }
+        }
+
+        _faces.swap(faces);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// longitude and latitude, the triangles across the seam get their own copies of the
+// texture vertices with u + 1 so the texture does not wrap backward over them
+//------------------------------------------------------------------------------------------
+void StressMesh::computeSphericalTexCoords(const QVector<cyPoint3f>& _vertices,
+                                           QVector<cyPoint3f>& _texCoords,
+                                           QVector<cyTriMesh::cyTriFace>& _texFaces)
+{
+    const float PI = 3.14159265358979f;
+    _texCoords.resize(_vertices.size());
+
+    for(int i = 0; i < _vertices.size(); ++i)
+    {
+        cyPoint3f direction = _vertices[i].GetNormalized();
+        _texCoords[i] = cyPoint3f(0.5f + atan2(direction.z, direction.x) / (2.0f * PI),
+                                  acos(qBound(-1.0f, direction.y, 1.0f)) / PI, 0);
+    }
+
+    QHash<unsigned int, unsigned int> wrappedTexCoords;
+
+    for(int i = 0; i < _texFaces.size(); ++i)
+    {
+        float minU = 1.0f;
+        float maxU = 0.0f;
+
+        for(int j = 0; j < 3; ++j)
+        {
+            minU = qMin(minU, _texCoords[_texFaces[i].v[j]].x);
+            maxU = qMax(maxU, _texCoords[_texFaces[i].v[j]].x);
+        }
+
+        if(maxU - minU <= 0.5f)
+        {
+            continue;
+        }
+
+        for(int j = 0; j < 3; ++j)
+        {
+            unsigned int texCoord = _texFaces[i].v[j];
+
+            if(_texCoords[texCoord].x >= 0.5f)
+            {
+                continue;
+            }
+
+            if(!wrappedTexCoords.contains(texCoord))
+            {
+                wrappedTexCoords.insert(texCoord, _texCoords.size());
+                _texCoords.append(_texCoords[texCoord] + cyPoint3f(1, 0, 0));
+            }
+
+            _texFaces[i].v[j] = wrappedTexCoords.value(texCoord);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+void StressMesh::setMesh(const QVector<cyPoint3f>& _vertices,
+                         const QVector<cyTriMesh::cyTriFace>& _faces,
+                         const QVector<cyPoint3f>& _texCoords,
+                         const QVector<cyTriMesh::cyTriFace>& _texFaces, cyTriMesh* _mesh)
+{
+    _mesh->Clear();
+    _mesh->SetNumVertex(_vertices.size());
+    _mesh->SetNumFaces(_faces.size());
+    _mesh->SetNumTexVerts(_texCoords.size());
+
+    memcpy(&_mesh->V(0), _vertices.constData(), _vertices.size() * sizeof(cyPoint3f));
+    memcpy(&_mesh->F(0), _faces.constData(), _faces.size() * sizeof(cyTriMesh::cyTriFace));
+    memcpy(&_mesh->VT(0), _texCoords.constData(), _texCoords.size() * sizeof(cyPoint3f));
+    memcpy(&_mesh->FT(0), _texFaces.constData(),
+           _texFaces.size() * sizeof(cyTriMesh::cyTriFace));
+}
+
+//------------------------------------------------------------------------------------------
+// sum of octaves of value noise, in [-1, 1]
+//------------------------------------------------------------------------------------------
+float StressMesh::fractalNoise(const cyPoint3f& _point, int _numOctaves)
+{
+    float sum = 0.0f;
+    float amplitude = 1.0f;
+    float totalAmplitude = 0.0f;
+    cyPoint3f point = _point;
+
+    for(int octave = 0; octave < _numOctaves; ++octave)
+    {
+        sum += amplitude * valueNoise(point);
+        totalAmplitude += amplitude;
+        amplitude *= 0.5f;
+        point *= 2.0f;
+    }
+
+    return sum / totalAmplitude;
+}
+
+//------------------------------------------------------------------------------------------
+// trilinear interpolation of the lattice values with a smoothstep fade
+//------------------------------------------------------------------------------------------
+float StressMesh::valueNoise(const cyPoint3f& _point)
+{
+    int x = (int) floor(_point.x);
+    int y = (int) floor(_point.y);
+    int z = (int) floor(_point.z);
+    float fx = _point.x - x;
+    float fy = _point.y - y;
+    float fz = _point.z - z;
+
+    fx = fx * fx * (3.0f - 2.0f * fx);
+    fy = fy * fy * (3.0f - 2.0f * fy);
+    fz = fz * fz * (3.0f - 2.0f * fz);
+
+    float value[2][2];
+
+    for(int i = 0; i < 2; ++i)
+    {
+        for(int j = 0; j < 2; ++j)
+        {
+            float v0 = latticeValue(x, y + i, z + j);
+            float v1 = latticeValue(x + 1, y + i, z + j);
+            value[i][j] = v0 + fx * (v1 - v0);
+        }
+    }
+
+    float v0 = value[0][0] + fz * (value[0][1] - value[0][0]);
+    float v1 = value[1][0] + fz * (value[1][1] - value[1][0]);
+
+    return v0 + fy * (v1 - v0);
+}
+
+//------------------------------------------------------------------------------------------
+// integer hash to [-1, 1], the same on every platform
+//------------------------------------------------------------------------------------------
+float StressMesh::latticeValue(int _x, int _y, int _z)
+{
+    quint32 hash = ((quint32) _x * 73856093u) ^ ((quint32) _y * 19349663u) ^
+                   ((quint32) _z * 83492791u);
+    hash ^= hash >> 13;
+    hash *= 0x5bd1e995u;
+    hash ^= hash >> 15;
+
+    return (float)(hash & 0xffffff) / (float) 0x7fffff - 1.0f;
+}
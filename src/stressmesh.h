@@ -0,0 +1,63 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#ifndef STRESSMESH_H
+#define STRESSMESH_H
+
+#include <QtCore>
+
+#include "cyTriMesh.h"
+
+enum StressMeshType
+{
+    STRESS_ICOSPHERE = 0,
+    STRESS_BLOB,
+    STRESS_HIGH_GENUS,
+    STRESS_THIN_FEATURES,
+    NUM_STRESS_MESH
+};
+
+//------------------------------------------------------------------------------------------
+// Procedural test meshes of controllable size, fed to the same pipeline as the OBJ files.
+// The level sets the size of each kind of mesh:
+//     icosphere:     icosahedron subdivided _level times, 20 * 4^level triangles
+//     blob:          icosphere of the same level displaced by fractal noise, lots of
+//                    silhouette edges from every view direction
+//     high genus:    perforated plate with (2 * level)^2 holes, every face split 4x4
+//     thin features: sea urchin, a sphere of level + 2 with 10 * 4^level + 2 long spikes
+// The meshes are deterministic, they have texture coordinates but no normals.
+//------------------------------------------------------------------------------------------
+class StressMesh
+{
+public:
+    static void generate(StressMeshType _type, int _level, cyTriMesh* _mesh);
+
+    static QString getName(StressMeshType _type);
+    static qint64 getNumTriangles(StressMeshType _type, int _level);
+
+private:
+    static void generateIcosphere(int _level, cyTriMesh* _mesh);
+    static void generateBlob(int _level, cyTriMesh* _mesh);
+    static void generateHighGenus(int _level, cyTriMesh* _mesh);
+    static void generateThinFeatures(int _level, cyTriMesh* _mesh);
+
+    static void buildIcosphere(int _level, QVector<cyPoint3f>& _vertices,
+                               QVector<cyTriMesh::cyTriFace>& _faces);
+    static void setMesh(const QVector<cyPoint3f>& _vertices,
+                        const QVector<cyTriMesh::cyTriFace>& _faces,
+                        const QVector<cyPoint3f>& _texCoords,
+                        const QVector<cyTriMesh::cyTriFace>& _texFaces, cyTriMesh* _mesh);
+    static void computeSphericalTexCoords(const QVector<cyPoint3f>& _vertices,
+                                          QVector<cyPoint3f>& _texCoords,
+                                          QVector<cyTriMesh::cyTriFace>& _texFaces);
+    static float fractalNoise(const cyPoint3f& _point, int _numOctaves);
+    static float valueNoise(const cyPoint3f& _point);
+    static float latticeValue(int _x, int _y, int _z);
+};
+
+#endif // STRESSMESH_H
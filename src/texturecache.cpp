@@ -0,0 +1,444 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QStandardPaths>
+#include <QVector3D>
+#include <limits.h>
+#include <string.h>
+
+#include "texturecache.h"
+
+//------------------------------------------------------------------------------------------
+QString TextureCache::getCacheFileName(const QString& _sourceFile)
+{
+    QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) +
+                       "/textures";
+    QDir().mkpath(cacheDir);
+
+    return (cacheDir + "/" + QFileInfo(_sourceFile).completeBaseName() + ".stc");
+}
+
+//------------------------------------------------------------------------------------------
+// FNV-1a hash of the source file, to detect outdated cache files
+//------------------------------------------------------------------------------------------
+quint64 TextureCache::hashSourceFile(const QString& _sourceFile)
+{
+    QFile file(_sourceFile);
+
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        return 0;
+    }
+
+    QByteArray data = file.readAll();
+    quint64 hash = 14695981039346656037ULL;
+
+    for(int i = 0; i < data.size(); ++i)
+    {
+        hash ^= (uchar)data.at(i);
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+//------------------------------------------------------------------------------------------
+GLenum TextureCache::getGLFormat(Compression _compression)
+{
+    switch(_compression)
+    {
+    case COMPRESSION_COLOR_BC1:
+        return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+
+    case COMPRESSION_NORMAL_BC5:
+        return GL_COMPRESSED_RG_RGTC2;
+
+    default:
+        return GL_RGBA8;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+int TextureCache::getLevelSize(int _width, int _height, Compression _compression)
+{
+    int numBlocks = ((_width + 3) / 4) * ((_height + 3) / 4);
+    return numBlocks * (_compression == COMPRESSION_COLOR_BC1 ? 8 : 16);
+}
+
+//------------------------------------------------------------------------------------------
+bool TextureCache::validateCacheData(const uchar* _data, qint64 _dataSize,
+                                     Compression _compression, quint64 _sourceHash)
+{
+    if(!_data || _dataSize < (qint64)sizeof(TextureCacheHeader))
+    {
+        return false;
+    }
+
+    const TextureCacheHeader* header = (const TextureCacheHeader*)_data;
+
+    if(header->magic != TEXTURE_CACHE_MAGIC || header->version != TEXTURE_CACHE_VERSION
+       || header->glFormat != getGLFormat(_compression) || header->sourceHash != _sourceHash
+       || header->numMipLevels == 0 || header->numMipLevels > TEXTURE_CACHE_MAX_MIP_LEVELS)
+    {
+        return false;
+    }
+
+    for(quint32 level = 0; level < header->numMipLevels; ++level)
+    {
+        if((qint64)header->levelOffsets[level] + header->levelSizes[level] > _dataSize)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+QByteArray TextureCache::buildCacheData(const QImage& _image, Compression _compression,
+                                        quint64 _sourceHash)
+{
+    QImage image = _image;
+
+    if(image.format() != QImage::Format_ARGB32 && image.format() != QImage::Format_RGB32)
+    {
+        image = image.convertToFormat(QImage::Format_ARGB32);
+    }
+
+    int width = image.width();
+    int height = image.height();
+
+    QVector<quint32> level(width * height);
+
+    for(int y = 0; y < height; ++y)
+    {
+        memcpy(&level[y * width], image.constScanLine(y), width * sizeof(quint32));
+    }
+
+    TextureCacheHeader header;
+    memset(&header, 0, sizeof(TextureCacheHeader));
+    header.magic = TEXTURE_CACHE_MAGIC;
+    header.version = TEXTURE_CACHE_VERSION;
+    header.glFormat = getGLFormat(_compression);
+    header.width = width;
+    header.height = height;
+    header.sourceHash = _sourceHash;
+
+    QByteArray data((const char*)&header, sizeof(TextureCacheHeader));
+
+    int levelWidth = width;
+    int levelHeight = height;
+    int numMipLevels = 0;
+
+    while(numMipLevels < TEXTURE_CACHE_MAX_MIP_LEVELS)
+    {
+        int levelSize = getLevelSize(levelWidth, levelHeight, _compression);
+        header.levelOffsets[numMipLevels] = data.size();
+        header.levelSizes[numMipLevels] = levelSize;
+
+        data.resize(data.size() + levelSize);
+        compressLevel(level, levelWidth, levelHeight, _compression,
+                      (uchar*)data.data() + header.levelOffsets[numMipLevels]);
+        ++numMipLevels;
+
+        if(levelWidth == 1 && levelHeight == 1)
+        {
+            break;
+        }
+
+        QVector<quint32> nextLevel;
+
+        if(_compression == COMPRESSION_NORMAL_BC5)
+        {
+            downsampleNormal(level, levelWidth, levelHeight, nextLevel);
+        }
+        else
+        {
+            downsampleColor(level, levelWidth, levelHeight, nextLevel);
+        }
+
+        level = nextLevel;
+        levelWidth = qMax(1, levelWidth / 2);
+        levelHeight = qMax(1, levelHeight / 2);
+    }
+
+    header.numMipLevels = numMipLevels;
+    memcpy(data.data(), &header, sizeof(TextureCacheHeader));
+
+    return data;
+}
+
+//------------------------------------------------------------------------------------------
+void TextureCache::downsampleColor(const QVector<quint32>& _src, int _width, int _height,
+                                   QVector<quint32>& _dst)
+{
+    int dstWidth = qMax(1, _width / 2);
+    int dstHeight = qMax(1, _height / 2);
+    _dst.resize(dstWidth * dstHeight);
+
+    for(int y = 0; y < dstHeight; ++y)
+    {
+        for(int x = 0; x < dstWidth; ++x)
+        {
+            int x0 = qMin(2 * x, _width - 1), x1 = qMin(2 * x + 1, _width - 1);
+            int y0 = qMin(2 * y, _height - 1), y1 = qMin(2 * y + 1, _height - 1);
+            quint32 texels[4] = {_src[y0 * _width + x0], _src[y0 * _width + x1],
+                                 _src[y1 * _width + x0], _src[y1 * _width + x1]
+                                };
+            quint32 result = 0;
+
+            for(int shift = 0; shift < 32; shift += 8)
+            {
+                quint32 sum = 2;
+
+                for(int i = 0; i < 4; ++i)
+                {
+                    sum += (texels[i] >> shift) & 0xFF;
+                }
+
+                result |= ((sum / 4) & 0xFF) << shift;
+            }
+
+            _dst[y * dstWidth + x] = result;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// average the normals, not the colors, and renormalize them
+//------------------------------------------------------------------------------------------
+void TextureCache::downsampleNormal(const QVector<quint32>& _src, int _width, int _height,
+                                    QVector<quint32>& _dst)
+{
+    int dstWidth = qMax(1, _width / 2);
+    int dstHeight = qMax(1, _height / 2);
+    _dst.resize(dstWidth * dstHeight);
+
+    for(int y = 0; y < dstHeight; ++y)
+    {
+        for(int x = 0; x < dstWidth; ++x)
+        {
+            int x0 = qMin(2 * x, _width - 1), x1 = qMin(2 * x + 1, _width - 1);
+            int y0 = qMin(2 * y, _height - 1), y1 = qMin(2 * y + 1, _height - 1);
+            quint32 texels[4] = {_src[y0 * _width + x0], _src[y0 * _width + x1],
+                                 _src[y1 * _width + x0], _src[y1 * _width + x1]
+                                };
+            QVector3D normal(0, 0, 0);
+
+            for(int i = 0; i < 4; ++i)
+            {
+                normal += QVector3D((float)((texels[i] >> 16) & 0xFF),
+                                    (float)((texels[i] >> 8) & 0xFF),
+                                    (float)(texels[i] & 0xFF)) / 127.5f - QVector3D(1, 1, 1);
+            }
+
+            normal.normalize();
+            normal = (normal + QVector3D(1, 1, 1)) * 127.5f;
+
+            _dst[y * dstWidth + x] = 0xFF000000 |
+                                     ((quint32)qBound(0, qRound(normal.x()), 255) << 16) |
+                                     ((quint32)qBound(0, qRound(normal.y()), 255) << 8) |
+                                     (quint32)qBound(0, qRound(normal.z()), 255);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+void TextureCache::compressLevel(const QVector<quint32>& _pixels, int _width, int _height,
+                                 Compression _compression, uchar* _output)
+{
+    int blockSize = (_compression == COMPRESSION_COLOR_BC1) ? 8 : 16;
+
+    for(int by = 0; by < _height; by += 4)
+    {
+        for(int bx = 0; bx < _width; bx += 4)
+        {
+            // levels smaller than a block repeat their border texels
+            quint32 block[16];
+
+            for(int i = 0; i < 16; ++i)
+            {
+                int x = qMin(bx + (i & 3), _width - 1);
+                int y = qMin(by + (i >> 2), _height - 1);
+                block[i] = _pixels[y * _width + x];
+            }
+
+            if(_compression == COMPRESSION_COLOR_BC1)
+            {
+                encodeBlockBC1(block, _output);
+            }
+            else
+            {
+                uchar red[16];
+                uchar green[16];
+
+                for(int i = 0; i < 16; ++i)
+                {
+                    red[i] = (block[i] >> 16) & 0xFF;
+                    green[i] = (block[i] >> 8) & 0xFF;
+                }
+
+                encodeBlockBC4(red, _output);
+                encodeBlockBC4(green, _output + 8);
+            }
+
+            _output += blockSize;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// end points from the inset bounding box of the block colors, 4-color mode
+//------------------------------------------------------------------------------------------
+void TextureCache::encodeBlockBC1(const quint32* _block, uchar* _output)
+{
+    int minColor[3] = {255, 255, 255};
+    int maxColor[3] = {0, 0, 0};
+
+    for(int i = 0; i < 16; ++i)
+    {
+        for(int c = 0; c < 3; ++c)
+        {
+            int value = (_block[i] >> (16 - 8 * c)) & 0xFF;
+            minColor[c] = qMin(minColor[c], value);
+            maxColor[c] = qMax(maxColor[c], value);
+        }
+    }
+
+    for(int c = 0; c < 3; ++c)
+    {
+        int inset = (maxColor[c] - minColor[c]) >> 4;
+        minColor[c] += inset;
+        maxColor[c] -= inset;
+    }
+
+    quint16 color0 = ((maxColor[0] >> 3) << 11) | ((maxColor[1] >> 2) << 5) | (maxColor[2] >> 3);
+    quint16 color1 = ((minColor[0] >> 3) << 11) | ((minColor[1] >> 2) << 5) | (minColor[2] >> 3);
+
+    if(color0 < color1)
+    {
+        qSwap(color0, color1);
+    }
+
+    quint32 indices = 0;
+
+    // color0 == color1 would switch to the 3-color mode, all indices 0 are fine there
+    if(color0 != color1)
+    {
+        int palette[4][3];
+        quint16 endPoints[2] = {color0, color1};
+
+        for(int p = 0; p < 2; ++p)
+        {
+            int r = (endPoints[p] >> 11) & 0x1F;
+            int g = (endPoints[p] >> 5) & 0x3F;
+            int b = endPoints[p] & 0x1F;
+            palette[p][0] = (r << 3) | (r >> 2);
+            palette[p][1] = (g << 2) | (g >> 4);
+            palette[p][2] = (b << 3) | (b >> 2);
+        }
+
+        for(int c = 0; c < 3; ++c)
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+
+        for(int i = 0; i < 16; ++i)
+        {
+            int bestIndex = 0;
+            int bestDistance = INT_MAX;
+
+            for(int p = 0; p < 4; ++p)
+            {
+                int distance = 0;
+
+                for(int c = 0; c < 3; ++c)
+                {
+                    int diff = (int)((_block[i] >> (16 - 8 * c)) & 0xFF) - palette[p][c];
+                    distance += diff * diff;
+                }
+
+                if(distance < bestDistance)
+                {
+                    bestDistance = distance;
+                    bestIndex = p;
+                }
+            }
+
+            indices |= (quint32)bestIndex << (2 * i);
+        }
+    }
+
+    _output[0] = color0 & 0xFF;
+    _output[1] = color0 >> 8;
+    _output[2] = color1 & 0xFF;
+    _output[3] = color1 >> 8;
+    _output[4] = indices & 0xFF;
+    _output[5] = (indices >> 8) & 0xFF;
+    _output[6] = (indices >> 16) & 0xFF;
+    _output[7] = (indices >> 24) & 0xFF;
+}
+
+//------------------------------------------------------------------------------------------
+// single channel block, 8-value mode with the block min/max as end points
+//------------------------------------------------------------------------------------------
+void TextureCache::encodeBlockBC4(const uchar* _values, uchar* _output)
+{
+    int minValue = 255;
+    int maxValue = 0;
+
+    for(int i = 0; i < 16; ++i)
+    {
+        minValue = qMin(minValue, (int)_values[i]);
+        maxValue = qMax(maxValue, (int)_values[i]);
+    }
+
+    quint64 indices = 0;
+
+    if(maxValue > minValue)
+    {
+        int palette[8];
+        palette[0] = maxValue;
+        palette[1] = minValue;
+
+        for(int p = 2; p < 8; ++p)
+        {
+            palette[p] = ((8 - p) * maxValue + (p - 1) * minValue + 3) / 7;
+        }
+
+        for(int i = 0; i < 16; ++i)
+        {
+            int bestIndex = 0;
+            int bestDistance = INT_MAX;
+
+            for(int p = 0; p < 8; ++p)
+            {
+                int distance = qAbs((int)_values[i] - palette[p]);
+
+                if(distance < bestDistance)
+                {
+                    bestDistance = distance;
+                    bestIndex = p;
+                }
+            }
+
+            indices |= (quint64)bestIndex << (3 * i);
+        }
+    }
+
+    _output[0] = (uchar)maxValue;
+    _output[1] = (uchar)minValue;
+
+    for(int i = 0; i < 6; ++i)
+    {
+        _output[2 + i] = (indices >> (8 * i)) & 0xFF;
+    }
+}
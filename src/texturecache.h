@@ -0,0 +1,83 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#ifndef TEXTURECACHE_H
+#define TEXTURECACHE_H
+
+#include <qopengl.h>
+#include <QImage>
+#include <QString>
+
+#define TEXTURE_CACHE_MAGIC 0x31435453 // "STC1"
+#define TEXTURE_CACHE_VERSION 1
+#define TEXTURE_CACHE_MAX_MIP_LEVELS 16
+
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+
+#ifndef GL_COMPRESSED_RG_RGTC2
+#define GL_COMPRESSED_RG_RGTC2 0x8DBD
+#endif
+
+//------------------------------------------------------------------------------------------
+// Cache file layout: the header, followed by the compressed mip levels.
+// The cache is machine local, thus stored in native byte order.
+//------------------------------------------------------------------------------------------
+struct TextureCacheHeader
+{
+    quint32 magic;
+    quint32 version;
+    quint32 glFormat;
+    quint32 width;
+    quint32 height;
+    quint32 numMipLevels;
+    quint64 sourceHash;
+    quint32 levelOffsets[TEXTURE_CACHE_MAX_MIP_LEVELS];
+    quint32 levelSizes[TEXTURE_CACHE_MAX_MIP_LEVELS];
+};
+
+//------------------------------------------------------------------------------------------
+// Builds block compressed textures with a full mip chain from decoded images:
+// color maps are stored as BC1 (DXT1), normal maps as BC5 (RGTC2) keeping only the x and
+// y components, the z component is reconstructed in the shader.
+//------------------------------------------------------------------------------------------
+class TextureCache
+{
+public:
+    enum Compression
+    {
+        NO_COMPRESSION = 0,
+        COMPRESSION_COLOR_BC1,
+        COMPRESSION_NORMAL_BC5
+    };
+
+    static QString getCacheFileName(const QString& _sourceFile);
+    static quint64 hashSourceFile(const QString& _sourceFile);
+    static GLenum getGLFormat(Compression _compression);
+
+    static bool validateCacheData(const uchar* _data, qint64 _dataSize,
+                                  Compression _compression, quint64 _sourceHash);
+
+    // _image must be flipped already (bottom row first)
+    static QByteArray buildCacheData(const QImage& _image, Compression _compression,
+                                     quint64 _sourceHash);
+    static int getLevelSize(int _width, int _height, Compression _compression);
+
+private:
+    static void downsampleColor(const QVector<quint32>& _src, int _width, int _height,
+                                QVector<quint32>& _dst);
+    static void downsampleNormal(const QVector<quint32>& _src, int _width, int _height,
+                                 QVector<quint32>& _dst);
+    static void compressLevel(const QVector<quint32>& _pixels, int _width, int _height,
+                              Compression _compression, uchar* _output);
+    static void encodeBlockBC1(const quint32* _block, uchar* _output);
+    static void encodeBlockBC4(const uchar* _values, uchar* _output);
+};
+
+#endif // TEXTURECACHE_H
@@ -0,0 +1,572 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+#include "textureloader.h"
+
+//------------------------------------------------------------------------------------------
+TextureLoader::TextureLoader():
+    hasS3TC(false),
+    currentFrame(0)
+{
+}
+
+//------------------------------------------------------------------------------------------
+TextureLoader::~TextureLoader()
+{
+    // the decoders may still write into the mapped buffers
+    foreach(TextureRequest* request, pendingRequests)
+    {
+        request->decodeFuture.waitForFinished();
+    }
+
+    foreach(TextureRequest* request, textureRequests)
+    {
+        delete request->cacheFile;
+    }
+
+    qDeleteAll(textureRequests);
+    qDeleteAll(textureArrays);
+}
+
+//------------------------------------------------------------------------------------------
+void TextureLoader::initialize()
+{
+    initializeOpenGLFunctions();
+
+    // RGTC is core since OpenGL 3.0, S3TC is still an extension
+    hasS3TC = QOpenGLContext::currentContext()->hasExtension("GL_EXT_texture_compression_s3tc");
+}
+
+//------------------------------------------------------------------------------------------
+int TextureLoader::addTextureArray(const QSize& _size, TextureCache::Compression _compression,
+                                   qint64 _memoryBudget, int _maxLayers)
+{
+    if(_compression == TextureCache::COMPRESSION_COLOR_BC1 && !hasS3TC)
+    {
+        _compression = TextureCache::NO_COMPRESSION;
+    }
+
+    TextureArray* array = new TextureArray;
+    array->size = _size;
+    array->compression = _compression;
+    array->numMipLevels = 1;
+    array->layerSize = 0;
+
+    while((1 << array->numMipLevels) <= qMax(_size.width(), _size.height()))
+    {
+        ++array->numMipLevels;
+    }
+
+    for(int level = 0; level < array->numMipLevels; ++level)
+    {
+        int width = qMax(1, _size.width() >> level);
+        int height = qMax(1, _size.height() >> level);
+        array->layerSize += (_compression == TextureCache::NO_COMPRESSION) ?
+                            width * height * 4 :
+                            TextureCache::getLevelSize(width, height, _compression);
+    }
+
+    int numLayers = qBound(1, (int)(_memoryBudget / array->layerSize), _maxLayers);
+    array->layers = QVector<TextureRequest*>(numLayers, NULL);
+
+    /////////////////////////////////////////////////////////////////
+    // allocate all the layers now, the textures only replace their content
+    QOpenGLTexture* texture = new QOpenGLTexture(QOpenGLTexture::Target2DArray);
+    texture->setSize(_size.width(), _size.height());
+    texture->setLayers(numLayers);
+    texture->setMipLevels(array->numMipLevels);
+
+    if(_compression == TextureCache::NO_COMPRESSION)
+    {
+        texture->setFormat(QOpenGLTexture::RGBA8_UNorm);
+        texture->allocateStorage();
+    }
+    else
+    {
+        GLenum format = TextureCache::getGLFormat(_compression);
+        texture->setFormat(static_cast<QOpenGLTexture::TextureFormat>(format));
+        texture->create();
+        texture->bind();
+
+        for(int level = 0; level < array->numMipLevels; ++level)
+        {
+            int width = qMax(1, _size.width() >> level);
+            int height = qMax(1, _size.height() >> level);
+            int levelSize = TextureCache::getLevelSize(width, height, _compression);
+
+            glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, format, width, height,
+                                   numLayers, 0, levelSize * numLayers, NULL);
+        }
+
+        texture->release();
+        texture->setMipLevelRange(0, array->numMipLevels - 1);
+    }
+
+    texture->setMinificationFilter(QOpenGLTexture::LinearMipMapLinear);
+    texture->setMagnificationFilter(QOpenGLTexture::Linear);
+    texture->setWrapMode(QOpenGLTexture::Repeat);
+
+    array->texture = texture;
+    textureArrays.append(array);
+
+    qDebug() << "Texture array:" << numLayers << "layers," << numLayers* array->layerSize / 1024
+             << "KB";
+
+    return (textureArrays.size() - 1);
+}
+
+//------------------------------------------------------------------------------------------
+int TextureLoader::addTexture(const QString& _fileName, int _arrayID)
+{
+    TextureRequest* request = new TextureRequest;
+    request->fileName = _fileName;
+    request->array = textureArrays[_arrayID];
+    request->size = request->array->size;
+    request->compression = request->array->compression;
+    textureRequests.append(request);
+
+    return (textureRequests.size() - 1);
+}
+
+//------------------------------------------------------------------------------------------
+void TextureLoader::beginFrame()
+{
+    ++currentFrame;
+}
+
+//------------------------------------------------------------------------------------------
+void TextureLoader::useTexture(int _textureID)
+{
+    TextureRequest* request = textureRequests[_textureID];
+    request->lastUsedFrame = currentFrame;
+
+    if(request->layer < 0 && !request->failed && !pendingRequests.contains(request))
+    {
+        startLoading(request);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+void TextureLoader::startLoading(TextureRequest* _request)
+{
+    pendingRequests.append(_request);
+
+    if(_request->compression != TextureCache::NO_COMPRESSION)
+    {
+        if(_request->sourceHash == 0)
+        {
+            _request->sourceHash = TextureCache::hashSourceFile(_request->fileName);
+        }
+
+        // nothing to decode if the cache is up to date
+        if(!mapCacheFile(_request))
+        {
+            _request->decodeFuture = QtConcurrent::run(buildCompressedImage, _request);
+        }
+
+        return;
+    }
+
+    GLsizeiptr dataSize = _request->size.width() * _request->size.height() * 4;
+
+    glGenBuffers(1, &_request->pbo);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _request->pbo);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, dataSize, NULL, GL_STREAM_DRAW);
+    _request->mappedData = (uchar*) glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, dataSize,
+                                                     GL_MAP_WRITE_BIT |
+                                                     GL_MAP_INVALIDATE_BUFFER_BIT);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    _request->decodeFuture = QtConcurrent::run(decodeImage, _request);
+}
+
+//------------------------------------------------------------------------------------------
+bool TextureLoader::mapCacheFile(TextureRequest* _request)
+{
+    QFile* file = new QFile(TextureCache::getCacheFileName(_request->fileName));
+
+    if(file->open(QIODevice::ReadOnly))
+    {
+        uchar* data = file->map(0, file->size());
+
+        if(TextureCache::validateCacheData(data, file->size(), _request->compression,
+                                           _request->sourceHash))
+        {
+            _request->cacheFile = file;
+            _request->cacheData = data;
+
+            return true;
+        }
+    }
+
+    delete file;
+
+    return false;
+}
+
+//------------------------------------------------------------------------------------------
+// runs on the thread pool
+//------------------------------------------------------------------------------------------
+bool TextureLoader::decodeImage(TextureRequest* _request)
+{
+    TRACE_SCOPE("decodeImage");
+    QElapsedTimer timer;
+    timer.start();
+
+    if(!_request->mappedData)
+    {
+        return false;
+    }
+
+    QImage image = QImageReader(_request->fileName).read();
+
+    if(image.size() != _request->size)
+    {
+        return false;
+    }
+
+    // RGB32 has the same layout as ARGB32, with opaque alpha
+    if(image.format() != QImage::Format_ARGB32 && image.format() != QImage::Format_RGB32)
+    {
+        image = image.convertToFormat(QImage::Format_ARGB32);
+    }
+
+    // OpenGL expects the bottom row first, flip while copying into the buffer
+    int height = image.height();
+    int rowSize = image.width() * 4;
+
+    for(int y = 0; y < height; ++y)
+    {
+        memcpy(_request->mappedData + (height - 1 - y) * rowSize, image.constScanLine(y),
+               rowSize);
+    }
+
+    _request->decodeTime = timer.elapsed();
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+// runs on the thread pool: compress the image with its mip chain, and save it to the cache
+//------------------------------------------------------------------------------------------
+bool TextureLoader::buildCompressedImage(TextureRequest* _request)
+{
+    TRACE_SCOPE("buildCompressedImage");
+    QElapsedTimer timer;
+    timer.start();
+
+    QImage image = QImageReader(_request->fileName).read();
+
+    if(image.isNull())
+    {
+        return false;
+    }
+
+    _request->compressedData = TextureCache::buildCacheData(image.mirrored(),
+                                                            _request->compression,
+                                                            _request->sourceHash);
+
+    // the cache is an optimization only, failing to write it is not an error
+    QSaveFile file(TextureCache::getCacheFileName(_request->fileName));
+
+    if(!file.open(QIODevice::WriteOnly) ||
+       file.write(_request->compressedData) != _request->compressedData.size() ||
+       !file.commit())
+    {
+        qDebug() << "Cannot write texture cache:" << file.fileName();
+    }
+
+    _request->decodeTime = timer.elapsed();
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+bool TextureLoader::isRequestFinished(TextureRequest* _request)
+{
+    return (_request->cacheData != NULL || _request->decodeFuture.isFinished());
+}
+
+//------------------------------------------------------------------------------------------
+int TextureLoader::uploadFinishedTextures(bool _waitForAll)
+{
+    int numUploaded = 0;
+
+    while(!pendingRequests.isEmpty())
+    {
+        QList<TextureRequest*>::iterator it = pendingRequests.begin();
+
+        while(it != pendingRequests.end())
+        {
+            if(isRequestFinished(*it))
+            {
+                TextureRequest* request = *it;
+                it = pendingRequests.erase(it);
+
+                // a texture that cannot be decoded or uploaded is not loaded again, but
+                // without a free layer it is loaded again on its next use
+                if(!uploadTexture(request))
+                {
+                    request->failed = true;
+                }
+                else if(request->layer >= 0)
+                {
+                    ++numUploaded;
+                }
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        if(!_waitForAll || pendingRequests.isEmpty())
+        {
+            break;
+        }
+
+        if(!isRequestFinished(pendingRequests.first()))
+        {
+            pendingRequests.first()->decodeFuture.waitForFinished();
+        }
+    }
+
+    return numUploaded;
+}
+
+//------------------------------------------------------------------------------------------
+// take a free layer, or the one of the least recently used texture of the array as long
+// as that texture is not used in the current frame
+//------------------------------------------------------------------------------------------
+bool TextureLoader::acquireLayer(TextureRequest* _request)
+{
+    TextureArray* array = _request->array;
+    int layer = array->layers.indexOf(NULL);
+
+    if(layer < 0)
+    {
+        for(int i = 0; i < array->layers.size(); ++i)
+        {
+            if(array->layers[i]->lastUsedFrame < currentFrame &&
+               (layer < 0 || array->layers[i]->lastUsedFrame < array->layers[layer]->lastUsedFrame))
+            {
+                layer = i;
+            }
+        }
+
+        if(layer < 0)
+        {
+            qDebug() << "No free texture layer for:" << _request->fileName;
+            return false;
+        }
+
+        qDebug() << "Evict texture" << array->layers[layer]->fileName << "from layer" << layer;
+        array->layers[layer]->layer = -1;
+    }
+
+    array->layers[layer] = _request;
+    _request->layer = layer;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+// give the layer back if the driver rejected the upload, return false in that case
+//------------------------------------------------------------------------------------------
+bool TextureLoader::checkUploadError(TextureRequest* _request)
+{
+    GLenum error = glGetError();
+
+    if(error == GL_NO_ERROR)
+    {
+        return true;
+    }
+
+    qDebug() << "Cannot upload texture:" << _request->fileName << ", error" << error;
+    _request->array->layers[_request->layer] = NULL;
+    _request->layer = -1;
+
+    return false;
+}
+
+//------------------------------------------------------------------------------------------
+// return false only if the texture cannot be decoded or uploaded
+//------------------------------------------------------------------------------------------
+bool TextureLoader::uploadTexture(TextureRequest* _request)
+{
+    if(_request->compression != TextureCache::NO_COMPRESSION)
+    {
+        return uploadCompressedTexture(_request);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _request->pbo);
+
+    if(_request->mappedData)
+    {
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        _request->mappedData = NULL;
+    }
+
+    bool success = _request->decodeFuture.result();
+
+    if(!success)
+    {
+        qDebug() << "Cannot decode texture:" << _request->fileName;
+    }
+    else if(acquireLayer(_request))
+    {
+        // only report the errors of this upload
+        while(glGetError() != GL_NO_ERROR) {}
+
+        _request->array->texture->bind();
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, _request->layer, _request->size.width(),
+                        _request->size.height(), 1, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, NULL);
+
+        // this regenerates the mipmaps of all the layers, there are only a few of them
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+        _request->array->texture->release();
+        success = checkUploadError(_request);
+    }
+
+    if(success && _request->layer >= 0)
+    {
+        qDebug() << "Texture" << _request->fileName << ": decode" << _request->decodeTime
+                 << "ms, upload" << timer.elapsed() << "ms, layer" << _request->layer;
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glDeleteBuffers(1, &_request->pbo);
+    _request->pbo = 0;
+
+    return success;
+}
+
+//------------------------------------------------------------------------------------------
+// upload all the levels from the cache data, no decoding and no mipmap generation
+//------------------------------------------------------------------------------------------
+bool TextureLoader::uploadCompressedTexture(TextureRequest* _request)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const uchar* data = _request->cacheData;
+    bool fromCache = (data != NULL);
+
+    if(!fromCache && _request->decodeFuture.result())
+    {
+        data = (const uchar*)_request->compressedData.constData();
+    }
+
+    const TextureCacheHeader* header = (const TextureCacheHeader*)data;
+    TextureArray* array = _request->array;
+    bool success = false;
+
+    if(!header)
+    {
+        qDebug() << "Cannot decode texture:" << _request->fileName;
+    }
+    else if((int)header->width != array->size.width() ||
+            (int)header->height != array->size.height() ||
+            (int)header->numMipLevels != array->numMipLevels)
+    {
+        qDebug() << "Texture size does not match its texture array:" << _request->fileName;
+    }
+    else
+    {
+        success = true;
+    }
+
+    if(success && acquireLayer(_request))
+    {
+        while(glGetError() != GL_NO_ERROR) {}
+
+        array->texture->bind();
+
+        for(quint32 level = 0; level < header->numMipLevels; ++level)
+        {
+            glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, _request->layer,
+                                      qMax(1u, header->width >> level),
+                                      qMax(1u, header->height >> level), 1, header->glFormat,
+                                      header->levelSizes[level],
+                                      data + header->levelOffsets[level]);
+        }
+
+        array->texture->release();
+        success = checkUploadError(_request);
+    }
+
+    if(success && _request->layer >= 0)
+    {
+        qDebug() << "Texture" << _request->fileName << ":" << (fromCache ? "from cache," :
+                                                                    QString("compress %1 ms,").
+                                                                    arg(_request->decodeTime))
+                 << "upload" << timer.elapsed() << "ms, layer" << _request->layer << ","
+                 << array->layerSize / 1024 << "KB vs"
+                 << header->width* header->height * 4 * 4 / 3 / 1024 << "KB uncompressed";
+    }
+
+    // the driver has its own copy now
+    if(fromCache)
+    {
+        _request->cacheFile->unmap(_request->cacheData);
+        _request->cacheFile->close();
+        delete _request->cacheFile;
+        _request->cacheFile = NULL;
+        _request->cacheData = NULL;
+    }
+
+    _request->compressedData.clear();
+
+    return success;
+}
+
+//------------------------------------------------------------------------------------------
+bool TextureLoader::isTextureReady(int _textureID)
+{
+    return (textureRequests[_textureID]->layer >= 0);
+}
+
+//------------------------------------------------------------------------------------------
+bool TextureLoader::hasPendingTextures()
+{
+    return !pendingRequests.isEmpty();
+}
+
+//------------------------------------------------------------------------------------------
+int TextureLoader::getTextureLayer(int _textureID)
+{
+    return textureRequests[_textureID]->layer;
+}
+
+//------------------------------------------------------------------------------------------
+GLenum TextureLoader::getTextureFormat(int _textureID)
+{
+    return TextureCache::getGLFormat(textureRequests[_textureID]->compression);
+}
+
+//------------------------------------------------------------------------------------------
+QOpenGLTexture* TextureLoader::getTextureArray(int _arrayID)
+{
+    return textureArrays[_arrayID]->texture;
+}
+
+//------------------------------------------------------------------------------------------
+qint64 TextureLoader::getTextureMemory()
+{
+    qint64 textureMemory = 0;
+
+    foreach(TextureArray* array, textureArrays)
+    {
+        textureMemory += array->layerSize * array->layers.size();
+    }
+
+    return textureMemory;
+}
@@ -0,0 +1,123 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#ifndef TEXTURELOADER_H
+#define TEXTURELOADER_H
+
+#include <QtGui>
+#include <QtConcurrent>
+#include <QOpenGLFunctions_4_0_Core>
+#include <QOpenGLTexture>
+
+#include "texturecache.h"
+#include "tracer.h"
+
+//------------------------------------------------------------------------------------------
+// Loads 2D textures from image files into the layers of texture arrays: the images are
+// decoded on the thread pool straight into mapped pixel buffer objects (flipped
+// vertically on the way), then each texture is uploaded from its PBO on the GL thread as
+// soon as its decode is done.
+// Texture arrays with a compression are built once into the block compressed cache
+// (with their mip chain), later runs memory-map the cache file and upload it directly.
+// Nothing is loaded before a texture is used: the number of layers of each array is set
+// by its memory budget, the least recently used textures give their layers away.
+//------------------------------------------------------------------------------------------
+class TextureLoader : protected QOpenGLFunctions_4_0_Core
+{
+public:
+    TextureLoader();
+    ~TextureLoader();
+
+    void initialize();
+
+    // allocate a texture array of same-sized textures, return the array ID
+    int addTextureArray(const QSize& _size, TextureCache::Compression _compression,
+                        qint64 _memoryBudget, int _maxLayers);
+
+    // register the image file without loading it, return the texture ID
+    int addTexture(const QString& _fileName, int _arrayID);
+
+    // mark the texture as used in the current frame, start loading it if not resident
+    void beginFrame();
+    void useTexture(int _textureID);
+
+    // upload the textures that finished decoding, return the number of uploaded textures
+    int uploadFinishedTextures(bool _waitForAll);
+
+    bool isTextureReady(int _textureID);
+    bool hasPendingTextures();
+
+    // the layer of the texture in its array, -1 if it is not resident
+    int getTextureLayer(int _textureID);
+    GLenum getTextureFormat(int _textureID);
+    QOpenGLTexture* getTextureArray(int _arrayID);
+    qint64 getTextureMemory();
+
+private:
+    struct TextureRequest;
+
+    struct TextureArray
+    {
+        QSize size;
+        TextureCache::Compression compression;
+        int numMipLevels;
+        qint64 layerSize;
+        QOpenGLTexture* texture;
+        QVector<TextureRequest*> layers;
+    };
+
+    struct TextureRequest
+    {
+        TextureRequest():
+            array(NULL),
+            layer(-1),
+            sourceHash(0),
+            pbo(0),
+            mappedData(NULL),
+            cacheFile(NULL),
+            cacheData(NULL),
+            decodeTime(0),
+            lastUsedFrame(-1),
+            failed(false) {}
+
+        QString fileName;
+        QSize size;
+        TextureArray* array;
+        int layer;
+        TextureCache::Compression compression;
+        quint64 sourceHash;
+        GLuint pbo;
+        uchar* mappedData;
+        QFile* cacheFile;
+        uchar* cacheData;
+        QByteArray compressedData;
+        QFuture<bool> decodeFuture;
+        qint64 decodeTime;
+        qint64 lastUsedFrame;
+        bool failed; // cannot be decoded or uploaded, never requested again
+    };
+
+    void startLoading(TextureRequest* _request);
+    bool mapCacheFile(TextureRequest* _request);
+    static bool decodeImage(TextureRequest* _request);
+    static bool buildCompressedImage(TextureRequest* _request);
+    bool isRequestFinished(TextureRequest* _request);
+    bool acquireLayer(TextureRequest* _request);
+    bool checkUploadError(TextureRequest* _request);
+    bool uploadTexture(TextureRequest* _request);
+    bool uploadCompressedTexture(TextureRequest* _request);
+
+    bool hasS3TC;
+    qint64 currentFrame;
+
+    QVector<TextureArray*> textureArrays;
+    QVector<TextureRequest*> textureRequests;
+    QList<TextureRequest*> pendingRequests;
+};
+
+#endif // TEXTURELOADER_H
@@ -0,0 +1,102 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+#include <QStringList>
+#include <QRegExp>
+#include <algorithm>
+#include "toonramp.h"
+
+//------------------------------------------------------------------------------------------
+static bool compareBands(const ToonBand& _band1, const ToonBand& _band2)
+{
+    return _band1.threshold < _band2.threshold;
+}
+
+//------------------------------------------------------------------------------------------
+ToonRamp::ToonRamp()
+{
+}
+
+//------------------------------------------------------------------------------------------
+ToonRamp::ToonRamp(const QString& _bandString)
+{
+    setBands(_bandString);
+}
+
+//------------------------------------------------------------------------------------------
+// the current bands are kept if the string cannot be parsed
+//------------------------------------------------------------------------------------------
+bool ToonRamp::setBands(const QString& _bandString)
+{
+    QVector<ToonBand> newBands;
+    QStringList bandStrList = _bandString.split(QRegExp("[,;\\s]+"), QString::SkipEmptyParts);
+
+    foreach(QString bandStr, bandStrList)
+    {
+        QStringList values = bandStr.split(":");
+
+        if(values.size() != 2)
+        {
+            return false;
+        }
+
+        bool okThreshold, okLevel;
+        ToonBand band(values.at(0).toFloat(&okThreshold), values.at(1).toFloat(&okLevel));
+
+        if(!okThreshold || !okLevel || band.threshold < 0.0f || band.threshold > 1.0f
+           || band.level < 0.0f || band.level > 1.0f)
+        {
+            return false;
+        }
+
+        newBands.append(band);
+    }
+
+    std::sort(newBands.begin(), newBands.end(), compareBands);
+    bands = newBands;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+QString ToonRamp::getBandString()
+{
+    QStringList bandStrList;
+
+    foreach(ToonBand band, bands)
+    {
+        bandStrList.append(QString("%1:%2").arg(band.threshold).arg(band.level));
+    }
+
+    return bandStrList.join(", ");
+}
+
+//------------------------------------------------------------------------------------------
+// the ramp is sampled with the light intensity as texture coordinate
+//------------------------------------------------------------------------------------------
+QVector<GLubyte> ToonRamp::generateRamp(int _resolution)
+{
+    QVector<GLubyte> ramp(_resolution);
+
+    for(int i = 0; i < _resolution; ++i)
+    {
+        float intensity = ((float)i + 0.5f) / (float)_resolution;
+        float level = 0.0f;
+
+        for(int j = 0; j < bands.size(); ++j)
+        {
+            if(intensity > bands[j].threshold)
+            {
+                level = bands[j].level;
+            }
+        }
+
+        ramp[i] = (GLubyte)(level * 255.0f + 0.5f);
+    }
+
+    return ramp;
+}
@@ -0,0 +1,48 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#ifndef TOONRAMP_H
+#define TOONRAMP_H
+
+#include <qopengl.h>
+#include <QVector>
+#include <QString>
+
+#define TOON_RAMP_RESOLUTION 1024
+
+//------------------------------------------------------------------------------------------
+// Light intensity above the threshold is quantized to the level of the band
+//------------------------------------------------------------------------------------------
+struct ToonBand
+{
+    ToonBand(): threshold(0.0f), level(0.0f) {}
+    ToonBand(float _threshold, float _level): threshold(_threshold), level(_level) {}
+
+    float threshold;
+    float level;
+};
+
+//------------------------------------------------------------------------------------------
+// Band specification of a toon shading ramp, written as "threshold:level" pairs,
+// e.g. "0.05:0.35, 0.5:0.7, 0.95:1.0". Intensity below all thresholds maps to 0.
+//------------------------------------------------------------------------------------------
+class ToonRamp
+{
+public:
+    ToonRamp();
+    ToonRamp(const QString& _bandString);
+
+    bool setBands(const QString& _bandString);
+    QString getBandString();
+    QVector<GLubyte> generateRamp(int _resolution = TOON_RAMP_RESOLUTION);
+
+private:
+    QVector<ToonBand> bands;
+};
+
+#endif // TOONRAMP_H
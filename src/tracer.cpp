@@ -0,0 +1,161 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#include "tracer.h"
+
+QAtomicInt Tracer::enabled(0);
+QElapsedTimer Tracer::clock;
+QMutex Tracer::registryMutex;
+QList<Tracer::ThreadBuffer*> Tracer::threadBuffers;
+QThreadStorage<Tracer::ThreadBufferHandle> Tracer::localBuffer;
+
+//------------------------------------------------------------------------------------------
+// enabling starts a new trace, the events recorded before are not dumped
+//------------------------------------------------------------------------------------------
+void Tracer::setEnabled(bool _enabled)
+{
+    if(!_enabled)
+    {
+        enabled.storeRelease(0);
+        return;
+    }
+
+    QMutexLocker locker(&registryMutex);
+
+    if(!clock.isValid())
+    {
+        clock.start();
+    }
+
+    for(int i = 0; i < threadBuffers.size(); ++i)
+    {
+        threadBuffers[i]->firstEvent = threadBuffers[i]->numEvents.loadAcquire();
+    }
+
+    enabled.storeRelease(1);
+}
+
+//------------------------------------------------------------------------------------------
+qint64 Tracer::getTimeNs()
+{
+    return clock.nsecsElapsed();
+}
+
+//------------------------------------------------------------------------------------------
+void Tracer::record(const char* _name, qint64 _startNs, qint64 _durationNs)
+{
+    ThreadBuffer* buffer = getThreadBuffer();
+
+    // only this thread writes the count, the release store publishes the event
+    int index = buffer->numEvents.load();
+    TraceEvent& event = buffer->events[index & (TRACE_BUFFER_SIZE - 1)];
+    event.name = _name;
+    event.startNs = _startNs;
+    event.durationNs = _durationNs;
+    buffer->numEvents.storeRelease(index + 1);
+}
+
+//------------------------------------------------------------------------------------------
+// the registry is only locked the first time a thread records an event
+//------------------------------------------------------------------------------------------
+Tracer::ThreadBuffer* Tracer::getThreadBuffer()
+{
+    ThreadBufferHandle& handle = localBuffer.localData();
+
+    if(handle.buffer)
+    {
+        return handle.buffer;
+    }
+
+    ThreadBuffer* buffer = new ThreadBuffer;
+    buffer->numEvents.store(0);
+    buffer->firstEvent = 0;
+
+    QThread* thread = QThread::currentThread();
+
+    if(QCoreApplication::instance() && thread == QCoreApplication::instance()->thread())
+    {
+        buffer->threadName = "Main";
+    }
+    else
+    {
+        buffer->threadName = thread->objectName().isEmpty() ? QString("Worker") :
+                             thread->objectName();
+    }
+
+    QMutexLocker locker(&registryMutex);
+    buffer->threadIndex = threadBuffers.size() + 1;
+    buffer->threadName += QString(" %1").arg(buffer->threadIndex);
+    threadBuffers.append(buffer);
+    handle.buffer = buffer;
+
+    return buffer;
+}
+
+//------------------------------------------------------------------------------------------
+// the threads keep recording while the buffers are copied: the events that may have been
+// overwritten during the copy, or are being overwritten, are discarded
+//------------------------------------------------------------------------------------------
+bool Tracer::dumpChromeTrace(const QString& _fileName)
+{
+    QFile file(_fileName);
+
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    {
+        qDebug() << "Cannot open trace file:" << _fileName;
+        return false;
+    }
+
+    QTextStream stream(&file);
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    QMutexLocker locker(&registryMutex);
+    QVector<TraceEvent> events;
+    int numDumped = 0;
+
+    for(int i = 0; i < threadBuffers.size(); ++i)
+    {
+        ThreadBuffer* buffer = threadBuffers[i];
+
+        int lastEvent = buffer->numEvents.loadAcquire();
+        int firstEvent = qMax(buffer->firstEvent, lastEvent - TRACE_BUFFER_SIZE);
+        events.resize(lastEvent - firstEvent);
+
+        for(int j = firstEvent; j < lastEvent; ++j)
+        {
+            events[j - firstEvent] = buffer->events[j & (TRACE_BUFFER_SIZE - 1)];
+        }
+
+        // the slot of the next event may be half written, it is discarded as well
+        int numOverwritten = qMax(0, buffer->numEvents.loadAcquire() + 1 - TRACE_BUFFER_SIZE -
+                                  firstEvent);
+
+        stream << (i > 0 ? ",\n" : "")
+               << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+               << buffer->threadIndex << ",\"args\":{\"name\":\"" << buffer->threadName
+               << "\"}}";
+
+        for(int j = numOverwritten; j < events.size(); ++j)
+        {
+            const TraceEvent& event = events[j];
+            stream << ",\n{\"name\":\"" << event.name
+                   << "\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadIndex
+                   << ",\"ts\":" << QString::number((double) event.startNs * 1e-3, 'f', 3)
+                   << ",\"dur\":" << QString::number((double) event.durationNs * 1e-3, 'f', 3)
+                   << "}";
+            ++numDumped;
+        }
+    }
+
+    stream << "\n]}\n";
+
+    qDebug() << "Trace:" << numDumped << "events from" << threadBuffers.size()
+             << "threads written to" << QFileInfo(file).absoluteFilePath();
+
+    return true;
+}
@@ -0,0 +1,113 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QtCore>
+
+#define TRACE_BUFFER_SIZE 65536 // events per thread, must be a power of two
+#define TRACE_FILE "trace.json"
+
+//------------------------------------------------------------------------------------------
+// TRACE_SCOPE("name") records the time spent until the end of the enclosing scope, the
+// name must be a string literal. Build with DEFINES += NO_TRACING to compile the markers
+// out, otherwise a disabled marker costs a single atomic load.
+//------------------------------------------------------------------------------------------
+#ifdef NO_TRACING
+#define TRACE_SCOPE(_name)
+#else
+#define TRACE_CONCAT_IMPL(_a, _b) _a##_b
+#define TRACE_CONCAT(_a, _b) TRACE_CONCAT_IMPL(_a, _b)
+#define TRACE_SCOPE(_name) ScopedTrace TRACE_CONCAT(scopedTrace, __LINE__)(_name)
+#endif
+
+//------------------------------------------------------------------------------------------
+struct TraceEvent
+{
+    const char* name;
+    qint64 startNs;
+    qint64 durationNs;
+};
+
+//------------------------------------------------------------------------------------------
+// Each thread records into its own ring buffer, which only that thread writes: an event
+// is written then published by a release store of the event count, so recording never
+// locks. The oldest events are overwritten once a buffer is full. The buffers are
+// registered once per thread and kept until exit, the thread pool threads are reused.
+//------------------------------------------------------------------------------------------
+class Tracer
+{
+public:
+    static void setEnabled(bool _enabled);
+    static bool isEnabled()
+    {
+        return enabled.load() != 0;
+    }
+
+    static qint64 getTimeNs();
+    static void record(const char* _name, qint64 _startNs, qint64 _durationNs);
+
+    // the events recorded since tracing was enabled, in the Chrome trace event format
+    // (chrome://tracing, ui.perfetto.dev)
+    static bool dumpChromeTrace(const QString& _fileName);
+
+private:
+    struct ThreadBuffer
+    {
+        TraceEvent events[TRACE_BUFFER_SIZE];
+        QAtomicInt numEvents;
+        int firstEvent; // events before it were recorded before tracing was enabled
+        int threadIndex;
+        QString threadName;
+    };
+
+    // QThreadStorage deletes the pointers it holds when the thread exits
+    struct ThreadBufferHandle
+    {
+        ThreadBufferHandle(): buffer(NULL) {}
+        ThreadBuffer* buffer;
+    };
+
+    static ThreadBuffer* getThreadBuffer();
+
+    static QAtomicInt enabled;
+    static QElapsedTimer clock;
+    static QMutex registryMutex;
+    static QList<ThreadBuffer*> threadBuffers;
+    static QThreadStorage<ThreadBufferHandle> localBuffer;
+};
+
+//------------------------------------------------------------------------------------------
+class ScopedTrace
+{
+public:
+    ScopedTrace(const char* _name):
+        name(_name),
+        startNs(-1)
+    {
+        if(Tracer::isEnabled())
+        {
+            startNs = Tracer::getTimeNs();
+        }
+    }
+
+    ~ScopedTrace()
+    {
+        if(startNs >= 0)
+        {
+            Tracer::record(name, startNs, Tracer::getTimeNs() - startNs);
+        }
+    }
+
+private:
+    const char* name;
+    qint64 startNs;
+};
+
+#endif // TRACER_H
@@ -10,384 +10,146 @@
 
 #include <QMatrix4x4>
 
-
-GLushort UnitCube::indices[] = {0,  1,  2,   // Face 0 - triangle strip ( v0,  v1,  v2,  v3)
-                                2, 1, 3,
-                                4, 5,  6,  // Face 1 - triangle strip ( v4,  v5,  v6,  v7)
-                                6, 5, 7,
-                                8, 9, 10, // Face 2 - triangle strip ( v8,  v9, v10, v11)
-                                10, 9, 11,
-                                12, 13, 14, // Face 3 - triangle strip (v12, v13, v14, v15)
-                                14, 13, 15,
-                                16, 17, 18, // Face 4 - triangle strip (v16, v17, v18, v19)
-                                18, 17, 19,
-                                20, 21, 22,      // Face 5 - triangle strip (v20, v21, v22, v23)
-                                22, 21, 23
-                               };
-
-
-UnitCube::UnitCube():
-    vertices(NULL),
-    transformedVertices(NULL),
-    colors(NULL),
-    texCoord(NULL),
-    normals(NULL),
-    negNormals(NULL)
-{
-
-    // Vertex data for face 0
-    // v0
-    vertexList.append(QVector3D(-1.0f, -1.0f,  1.0f));
-    colorList.append(QVector3D(0.0f, 0.0f,  1.0f));
-    normalsList.append(QVector3D(0.0f, 0.0f,  1.0f));
-    texCoordList.append(QVector2D(0.0f, 0.0f));
-
-    // v1
-    vertexList.append(QVector3D(1.0f, -1.0f,  1.0f));
-    colorList.append(QVector3D(1.0f, 0.0f,  1.0f));
-    normalsList.append(QVector3D(0.0f, 0.0f,  1.0f));
-    texCoordList.append(QVector2D(1.0f, 0.0f));
-
-    // v2
-    vertexList.append(QVector3D(-1.0f, 1.0f,  1.0f));
-    colorList.append(QVector3D(0.0f, 1.0f,  1.0f));
-    normalsList.append(QVector3D(0.0f, 0.0f,  1.0f));
-    texCoordList.append(QVector2D(0.0f, 1.0f));
-
-    // v3
-    vertexList.append(QVector3D(1.0f, 1.0f,  1.0f));
-    colorList.append(QVector3D(1.0f, 1.0f,  1.0f));
-    normalsList.append(QVector3D(0.0f, 0.0f,  1.0f));
-    texCoordList.append(QVector2D(1.0f, 1.0f));
-
-
-    // Vertex data for face 1
-    // v4
-    vertexList.append(QVector3D(1.0f, -1.0f,  1.0f));
-    colorList.append(QVector3D(1.0f, 0.0f,  1.0f));
-    normalsList.append(QVector3D(1.0f, 0.0f,  0.0f));
-    texCoordList.append(QVector2D(0.0f, 0.0f));
-
-    // v5
-    vertexList.append(QVector3D(1.0f, -1.0f,  -1.0f));
-    colorList.append(QVector3D(1.0f, 0.0f,  0.0f));
-    normalsList.append(QVector3D(1.0f, 0.0f,  0.0f));
-    texCoordList.append(QVector2D(1.0f, 0.0f));
-
-    // v6
-    vertexList.append(QVector3D(1.0f, 1.0f,  1.0f));
-    colorList.append(QVector3D(1.0f, 1.0f,  1.0f));
-    normalsList.append(QVector3D(1.0f, 0.0f,  0.0f));
-    texCoordList.append(QVector2D(0.0f, 1.0f));
-
-    // v7
-    vertexList.append(QVector3D(1.0f, 1.0f,  -1.0f));
-    colorList.append(QVector3D(1.0f, 1.0f,  0.0f));
-    normalsList.append(QVector3D(1.0f, 0.0f,  0.0f));
-    texCoordList.append(QVector2D(1.0f, 1.0f));
-
-
-    // Vertex data for face 2
-    // v8
-    vertexList.append(QVector3D(1.0f, -1.0f,  -1.0f));
-    colorList.append(QVector3D(1.0f, 0.0f,  0.0f));
-    normalsList.append(QVector3D(0.0f, 0.0f,  -1.0f));
-    texCoordList.append(QVector2D(0.0f, 0.0f));
-
-    // v9
-    vertexList.append(QVector3D(-1.0f, -1.0f,  -1.0f));
-    colorList.append(QVector3D(0.0f, 0.0f,  0.0f));
-    normalsList.append(QVector3D(0.0f, 0.0f,  -1.0f));
-    texCoordList.append(QVector2D(1.0f, 0.0f));
-
-    // v10
-    vertexList.append(QVector3D(1.0f, 1.0f,  -1.0f));
-    colorList.append(QVector3D(1.0f, 1.0f,  0.0f));
-    normalsList.append(QVector3D(0.0f, 0.0f,  -1.0f));
-    texCoordList.append(QVector2D(0.0f, 1.0f));
-
-    // v11
-    vertexList.append(QVector3D(-1.0f, 1.0f,  -1.0f));
-    colorList.append(QVector3D(0.0f, 1.0f,  0.0f));
-    normalsList.append(QVector3D(0.0f, 0.0f,  -1.0f));
-    texCoordList.append(QVector2D(1.0f, 1.0f));
-
-    // Vertex data for face 3
-    // v12
-    vertexList.append(QVector3D(-1.0f, -1.0f,  -1.0f));
-    colorList.append(QVector3D(0.0f, 0.0f,  0.0f));
-    normalsList.append(QVector3D(-1.0f, 0.0f,  0.0f));
-    texCoordList.append(QVector2D(0.0f, 0.0f));
-
-    // v13
-    vertexList.append(QVector3D(-1.0f, -1.0f,  1.0f));
-    colorList.append(QVector3D(0.0f, 0.0f,  1.0f));
-    normalsList.append(QVector3D(-1.0f, 0.0f,  0.0f));
-    texCoordList.append(QVector2D(1.0f, 0.0f));
-
-    // v14
-    vertexList.append(QVector3D(-1.0f, 1.0f,  -1.0f));
-    colorList.append(QVector3D(0.0f, 1.0f,  0.0f));
-    normalsList.append(QVector3D(-1.0f, 0.0f,  0.0f));
-    texCoordList.append(QVector2D(0.0f, 1.0f));
-
-    // v15
-    vertexList.append(QVector3D(-1.0f, 1.0f,  1.0f));
-    colorList.append(QVector3D(0.0f, 1.0f,  1.0f));
-    normalsList.append(QVector3D(-1.0f, 0.0f,  0.0f));
-    texCoordList.append(QVector2D(1.0f, 1.0f));
-
-    // Vertex data for face 4
-    // v16
-    vertexList.append(QVector3D(-1.0f, -1.0f,  -1.0f));
-    colorList.append(QVector3D(0.0f, 0.0f,  0.0f));
-    normalsList.append(QVector3D(0.0f, -1.0f,  0.0f));
-    texCoordList.append(QVector2D(0.0f, 0.0f));
-
-    // v17
-    vertexList.append(QVector3D(1.0f, -1.0f,  -1.0f));
-    colorList.append(QVector3D(1.0f, 0.0f,  0.0f));
-    normalsList.append(QVector3D(0.0f, -1.0f,  0.0f));
-    texCoordList.append(QVector2D(1.0f, 0.0f));
-
-    // v18
-    vertexList.append(QVector3D(-1.0f, -1.0f,  1.0f));
-    colorList.append(QVector3D(0.0f, 0.0f,  1.0f));
-    normalsList.append(QVector3D(0.0f, -1.0f,  0.0f));
-    texCoordList.append(QVector2D(0.0f, 1.0f));
-
-    // v19
-    vertexList.append(QVector3D(1.0f, -1.0f,  1.0f));
-    colorList.append(QVector3D(1.0f, 0.0f,  1.0f));
-    normalsList.append(QVector3D(0.0f, -1.0f,  0.0f));
-    texCoordList.append(QVector2D(1.0f, 1.0f));
-
-
-    // Vertex data for face 5
-    // v20
-    vertexList.append(QVector3D(-1.0f, 1.0f,  1.0f));
-    colorList.append(QVector3D(0.0f, 1.0f,  1.0f));
-    normalsList.append(QVector3D(0.0f, 1.0f,  0.0f));
-    texCoordList.append(QVector2D(0.0f, 0.0f));
-
-    // v21
-    vertexList.append(QVector3D(1.0f, 1.0f,  1.0f));
-    colorList.append(QVector3D(1.0f, 1.0f,  1.0f));
-    normalsList.append(QVector3D(0.0f, 1.0f,  0.0f));
-    texCoordList.append(QVector2D(1.0f, 0.0f));
-
-    // v22
-    vertexList.append(QVector3D(-1.0f, 1.0f,  -1.0f));
-    colorList.append(QVector3D(0.0f, 1.0f,  0.0f));
-    normalsList.append(QVector3D(0.0f, 1.0f,  0.0f));
-    texCoordList.append(QVector2D(0.0f, 1.0f));
-
-    // v23
-    vertexList.append(QVector3D(1.0f, 1.0f,  -1.0f));
-    colorList.append(QVector3D(1.0f, 1.0f,  0.0f));
-    normalsList.append(QVector3D(0.0f, 1.0f,  0.0f));
-    texCoordList.append(QVector2D(1.0f, 1.0f));
-
-
-
-    for(int i = 0; i < 12; ++i)
-    {
-        CubeFaceTriangle face;
-        int index0 = indices[i * 3];
-        int index1 = indices[i * 3 + 1];
-        int index2 = indices[i * 3 + 2];
-        face.faceNormal = normalsList.at(index0);
-        face.vertices[0] = vertexList.at(index0);
-        face.vertices[1] = vertexList.at(index1);
-        face.vertices[2] = vertexList.at(index2);
-        face.indices[0] = index0;
-        face.indices[1] = index1;
-        face.indices[2] = index2;
-
-        faceList.append(face);
-    }
-}
-
 //------------------------------------------------------------------------------------------
-UnitCube::~UnitCube()
+// the faces in the order +z, +x, -z, -x, -y, +y: the corner at (row, column) = (0, 0),
+// and the directions of the columns and rows, the cross product of which is the normal
+static const float faceCorners[6][3] =
 {
-    clearData();
-
-}
+    { -1.0f, -1.0f,  1.0f},
+    {  1.0f, -1.0f,  1.0f},
+    {  1.0f, -1.0f, -1.0f},
+    { -1.0f, -1.0f, -1.0f},
+    { -1.0f, -1.0f, -1.0f},
+    { -1.0f,  1.0f,  1.0f}
+};
 
-//------------------------------------------------------------------------------------------
-int UnitCube::getNumVertices()
+static const float faceColumnDirections[6][3] =
 {
-    return vertexList.size();
-}
+    { 1.0f, 0.0f,  0.0f},
+    { 0.0f, 0.0f, -1.0f},
+    { -1.0f, 0.0f,  0.0f},
+    { 0.0f, 0.0f,  1.0f},
+    { 1.0f, 0.0f,  0.0f},
+    { 1.0f, 0.0f,  0.0f}
+};
 
-//------------------------------------------------------------------------------------------
-int UnitCube::getNumIndices()
+static const float faceRowDirections[6][3] =
 {
-    return (sizeof(indices) / sizeof(GLushort));
-}
+    { 0.0f, 1.0f, 0.0f},
+    { 0.0f, 1.0f, 0.0f},
+    { 0.0f, 1.0f, 0.0f},
+    { 0.0f, 1.0f, 0.0f},
+    { 0.0f, 0.0f, 1.0f},
+    { 0.0f, 0.0f, -1.0f}
+};
 
-//------------------------------------------------------------------------------------------
-int UnitCube::getVertexOffset()
+static const float faceNormals[6][3] =
 {
-    return (sizeof(GLfloat) * getNumVertices() * 3);
-}
+    { 0.0f, 0.0f,  1.0f},
+    { 1.0f, 0.0f,  0.0f},
+    { 0.0f, 0.0f, -1.0f},
+    { -1.0f, 0.0f, 0.0f},
+    { 0.0f, -1.0f, 0.0f},
+    { 0.0f, 1.0f,  0.0f}
+};
 
 //------------------------------------------------------------------------------------------
-int UnitCube::getTexCoordOffset()
+UnitCube::UnitCube()
 {
-    return (sizeof(GLfloat) * getNumVertices() * 2);
+    generateCube(1);
 }
 
 //------------------------------------------------------------------------------------------
-int UnitCube::getIndexOffset()
+UnitCube::~UnitCube()
 {
-    return sizeof(indices);
 }
 
 //------------------------------------------------------------------------------------------
-int UnitCube::getNumFaceTriangles()
-{
-    return faceList.size();
-}
-
+// with a resolution of 1, the 4 vertices of each face are (v0, v1, v2, v3) and its
+// triangles (v0, v1, v2), (v2, v1, v3)
 //------------------------------------------------------------------------------------------
-GLfloat* UnitCube::getVertices()
+void UnitCube::generateCube(int _resolution)
 {
-    if(!vertices)
-    {
-        vertices = new GLfloat[vertexList.size() * 3];
-
-        for(int i = 0; i < vertexList.size(); ++i)
-        {
-            QVector3D vertex = vertexList.at(i);
-            vertices[3 * i] = vertex.x();
-            vertices[3 * i + 1] = vertex.y();
-            vertices[3 * i + 2] = vertex.z();
-        }
+    colors.clear();
+    scaledTexCoords.clear();
 
-    }
-
-    return vertices;
+    generate(6, _resolution, _resolution, false);
 }
 
-
 //------------------------------------------------------------------------------------------
-GLfloat* UnitCube::getVertexColors()
+void UnitCube::evaluate(int _patch, int _row, int _column, GLfloat* _vertex,
+                        GLfloat* _normal, GLfloat* _texCoord)
 {
-    if(!colors)
-    {
-        colors = new GLfloat[colorList.size() * 3];
+    float u = (float) _column / numColumns;
+    float v = (float) _row / numRows;
 
-        for(int i = 0; i < colorList.size(); ++i)
-        {
-            QVector3D color = colorList.at(i);
-            colors[3 * i] = color.x();
-            colors[3 * i + 1] = color.y();
-            colors[3 * i + 2] = color.z();
-        }
+    for(int i = 0; i < 3; ++i)
+    {
+        _vertex[i] = faceCorners[_patch][i] + 2.0f * u * faceColumnDirections[_patch][i] +
+                     2.0f * v * faceRowDirections[_patch][i];
+        _normal[i] = faceNormals[_patch][i];
     }
 
-    return colors;
+    _texCoord[0] = u;
+    _texCoord[1] = v;
 }
 
 //------------------------------------------------------------------------------------------
-GLfloat* UnitCube::getNormals()
+int UnitCube::getNumFaceTriangles()
 {
-    if(!normals)
-    {
-        normals = new GLfloat[normalsList.size() * 3];
-
-        for(int i = 0; i < normalsList.size(); ++i)
-        {
-            QVector3D normal = normalsList.at(i);
-            normals[3 * i] = normal.x();
-            normals[3 * i + 1] = normal.y();
-            normals[3 * i + 2] = normal.z();
-        }
-
-    }
-
-    return normals;
+    return getNumIndices() / 3;
 }
 
 //------------------------------------------------------------------------------------------
-GLfloat* UnitCube::getNegativeNormals()
+// the color is the position mapped to [0, 1]
+//------------------------------------------------------------------------------------------
+GLfloat* UnitCube::getVertexColors()
 {
-    if(!negNormals)
+    if(colors.isEmpty())
     {
-        negNormals = new GLfloat[normalsList.size() * 3];
-    }
+        const GLfloat* vertices = getVertices();
+        colors.resize(getNumVertices() * 3);
 
-    for(int i = 0; i < normalsList.size(); ++i)
-    {
-        QVector3D normal = normalsList.at(i);
-        negNormals[3 * i] = -normal.x();
-        negNormals[3 * i + 1] = -normal.y();
-        negNormals[3 * i + 2] = -normal.z();
+        for(int i = 0; i < colors.size(); ++i)
+        {
+            colors[i] = 0.5f * (vertices[i] + 1.0f);
+        }
     }
 
-    return negNormals;
+    return colors.data();
 }
 
 //------------------------------------------------------------------------------------------
 GLfloat* UnitCube::getTexureCoordinates(float _scale)
 {
-    if(!texCoord)
-    {
-        texCoord = new GLfloat[texCoordList.size() * 2];
-    }
+    const GLfloat* texCoords = UnitPrimitive::getTexureCoordinates();
+    scaledTexCoords.resize(getNumVertices() * 2);
 
-    for(int i = 0; i < texCoordList.size(); ++i)
+    for(int i = 0; i < scaledTexCoords.size(); ++i)
     {
-        QVector2D tex = texCoordList.at(i);
-        texCoord[2 * i] = tex.x() * _scale;
-        texCoord[2 * i + 1] = tex.y() * _scale;
-
+        scaledTexCoords[i] = texCoords[i] * _scale;
     }
 
-
-    return texCoord;
-}
-
-//------------------------------------------------------------------------------------------
-GLushort* UnitCube::getIndices()
-{
-    return indices;
+    return scaledTexCoords.data();
 }
 
 //------------------------------------------------------------------------------------------
 UnitCube::CubeFaceTriangle UnitCube::getFace(int _faceIndex)
 {
-    return faceList.at(_faceIndex);
-}
+    const GLfloat* vertices = getVertices();
+    const GLfloat* normals = getNormals();
+    CubeFaceTriangle face;
 
-//------------------------------------------------------------------------------------------
-void UnitCube::clearData()
-{
-    vertexList.clear();
-    normalsList.clear();
-    texCoordList.clear();
-
-    if(vertices)
-    {
-        delete[] vertices;
-    }
-
-    if(colors)
+    for(int i = 0; i < 3; ++i)
     {
-        delete[] colors;
+        int index = getIndex(_faceIndex * 3 + i);
+        face.indices[i] = index;
+        face.vertices[i] = QVector3D(vertices[3 * index], vertices[3 * index + 1],
+                                     vertices[3 * index + 2]);
     }
 
-    if(normals)
-    {
-        delete[] normals;
-    }
+    face.faceNormal = QVector3D(normals[3 * face.indices[0]], normals[3 * face.indices[0] + 1],
+                                normals[3 * face.indices[0] + 2]);
 
-    if(texCoord)
-    {
-        delete[] texCoord;
-    }
+    return face;
 }
-
-//------------------------------------------------------------------------------------------
@@ -5,17 +5,16 @@
 //     Author: Nghia Truong
 //
 //------------------------------------------------------------------------------------------
-#include <QOpenGLWidget>
-#include <QList>
 #include <QVector3D>
-#include <QVector2D>
 #include <QtGui>
 
+#include "unitprimitive.h"
+
 #ifndef UNITCUBE_H
 #define UNITCUBE_H
 
 
-class UnitCube
+class UnitCube : public UnitPrimitive
 {
 public:
     class CubeFaceTriangle
@@ -66,38 +65,22 @@ public:
     UnitCube();
     ~UnitCube();
 
-    int getNumVertices();
-    int getNumIndices();
-    int getVertexOffset();
-    int getTexCoordOffset();
-    int getIndexOffset();
-    int getNumFaceTriangles();
+    // each face is a grid of _resolution x _resolution quads
+    void generateCube(int _resolution);
 
+    int getNumFaceTriangles();
 
-    GLfloat* getVertices();
     GLfloat* getVertexColors();
-    GLfloat* getNormals();
-    GLfloat* getNegativeNormals();
     GLfloat* getTexureCoordinates(float _scale);
-    GLushort* getIndices();
     CubeFaceTriangle getFace(int _faceIndex);
 
+protected:
+    void evaluate(int _patch, int _row, int _column, GLfloat* _vertex, GLfloat* _normal,
+                  GLfloat* _texCoord);
 
 private:
-    void clearData();
-
-    QList<QVector3D> vertexList;
-    QList<QVector3D> colorList;
-    QList<QVector2D> texCoordList;
-    QList<QVector3D> normalsList;
-    QList<CubeFaceTriangle> faceList;
-    GLfloat* vertices;
-    GLfloat* transformedVertices;
-    GLfloat* colors;
-    GLfloat* texCoord;
-    GLfloat* normals;
-    GLfloat* negNormals;
-    static GLushort indices[];
+    QVector<GLfloat> colors;
+    QVector<GLfloat> scaledTexCoords;
 };
 
 #endif // UNITCUBE_H
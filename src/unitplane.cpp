@@ -9,191 +9,80 @@
 
 #include "unitplane.h"
 
-GLushort UnitPlane::indices[] = {0,  1,  2,
-                                 2, 3, 0
-                                };
-
 inline float rand_float()
 {
-    return (rand() / RAND_MAX);
+    return ((float) rand() / RAND_MAX);
 }
 
-UnitPlane::UnitPlane():
-    vertices(NULL),
-    colors(NULL),
-    texCoord(NULL),
-    normals(NULL)
+UnitPlane::UnitPlane()
 {
-    // v0
-    vertexList.append(QVector3D(-1.0f, 0.0f,  -1.0f));
-    colorList.append(QVector3D(rand_float(), rand_float(), rand_float()));
-    normalsList.append(QVector3D(0.0f, 1.0f,  0.0f));
-    texCoordList.append(QVector2D(0.0f, 0.0f));
-
-    // v1
-    vertexList.append(QVector3D(1.0f, 0.0f,  -1.0f));
-    colorList.append(QVector3D(rand_float(), rand_float(), rand_float()));
-    normalsList.append(QVector3D(0.0f, 1.0f,  0.0f));
-    texCoordList.append(QVector2D(1.0f, 0.0f));
-
-    // v2
-    vertexList.append(QVector3D(1.0f, 0.0f,  1.0f));
-    colorList.append(QVector3D(rand_float(), rand_float(), rand_float()));
-    normalsList.append(QVector3D(0.0f, 1.0f,  0.0f));
-    texCoordList.append(QVector2D(1.0f, 1.0f));
-
-    // v3
-    vertexList.append(QVector3D(-1.0f, 0.0f,  1.0f));
-    colorList.append(QVector3D(rand_float(), rand_float(), rand_float()));
-    normalsList.append(QVector3D(0.0f, 1.0f,  0.0f));
-    texCoordList.append(QVector2D(0.0f, 1.0f));
-
+    generatePlane(1);
 }
 
 //------------------------------------------------------------------------------------------
 UnitPlane::~UnitPlane()
 {
-    clearData();
 }
 
 //------------------------------------------------------------------------------------------
-int UnitPlane::getNumVertices()
-{
-    return vertexList.size();
-}
-
+// with a resolution of 1, the triangles are (v0, v1, v3), (v3, v2, v0) where v0 = (-1, 0, -1)
+// and v3 = (1, 0, 1)
 //------------------------------------------------------------------------------------------
-int UnitPlane::getNumIndices()
+void UnitPlane::generatePlane(int _resolution)
 {
-    return (sizeof(indices) / sizeof(GLushort));
-}
+    colors.clear();
+    scaledTexCoords.clear();
 
-//------------------------------------------------------------------------------------------
-int UnitPlane::getVertexOffset()
-{
-    return (sizeof(GLfloat) * getNumVertices() * 3);
+    generate(1, _resolution, _resolution, true);
 }
 
 //------------------------------------------------------------------------------------------
-int UnitPlane::getTexCoordOffset()
+void UnitPlane::evaluate(int _patch, int _row, int _column, GLfloat* _vertex,
+                         GLfloat* _normal, GLfloat* _texCoord)
 {
-    return (sizeof(GLfloat) * getNumVertices() * 2);
-}
+    Q_UNUSED(_patch);
 
-//------------------------------------------------------------------------------------------
-int UnitPlane::getIndexOffset()
-{
-    return sizeof(indices);
-}
+    float u = (float) _column / numColumns;
+    float v = (float) _row / numRows;
 
-//------------------------------------------------------------------------------------------
-GLfloat* UnitPlane::getVertices()
-{
-    if(!vertices)
-    {
-        vertices = new GLfloat[vertexList.size() * 3];
+    _vertex[0] = 2.0f * u - 1.0f;
+    _vertex[1] = 0.0f;
+    _vertex[2] = 2.0f * v - 1.0f;
 
-        for(int i = 0; i < vertexList.size(); ++i)
-        {
-            QVector3D vertex = vertexList.at(i);
-            vertices[3 * i] = vertex.x();
-            vertices[3 * i + 1] = vertex.y();
-            vertices[3 * i + 2] = vertex.z();
-        }
+    _normal[0] = 0.0f;
+    _normal[1] = 1.0f;
+    _normal[2] = 0.0f;
 
-    }
-
-    return vertices;
+    _texCoord[0] = u;
+    _texCoord[1] = v;
 }
 
 //------------------------------------------------------------------------------------------
 GLfloat* UnitPlane::getRandomVertexColors()
 {
-    if(!colors)
+    if(colors.isEmpty())
     {
-        colors = new GLfloat[colorList.size() * 3];
+        colors.resize(getNumVertices() * 3);
 
-        for(int i = 0; i < colorList.size(); ++i)
+        for(int i = 0; i < colors.size(); ++i)
         {
-            QVector3D color = colorList.at(i);
-            colors[3 * i] = color.x();
-            colors[3 * i + 1] = color.y();
-            colors[3 * i + 2] = color.z();
+            colors[i] = rand_float();
         }
     }
 
-    return colors;
-}
-
-//------------------------------------------------------------------------------------------
-GLfloat* UnitPlane::getNormals()
-{
-    if(!normals)
-    {
-        normals = new GLfloat[normalsList.size() * 3];
-
-        for(int i = 0; i < normalsList.size(); ++i)
-        {
-            QVector3D normal = normalsList.at(i);
-            normals[3 * i] = normal.x();
-            normals[3 * i + 1] = normal.y();
-            normals[3 * i + 2] = normal.z();
-        }
-
-    }
-
-    return normals;
+    return colors.data();
 }
 
 //------------------------------------------------------------------------------------------
 GLfloat* UnitPlane::getTexureCoordinates(float _scale)
 {
-    if(!texCoord)
-    {
-        texCoord = new GLfloat[texCoordList.size() * 2];
-    }
-
-    for(int i = 0; i < texCoordList.size(); ++i)
-    {
-        QVector2D tex = texCoordList.at(i);
-        texCoord[2 * i] = tex.x() * _scale;
-        texCoord[2 * i + 1] = tex.y() * _scale;
-    }
-
-
-    return texCoord;
-}
-
-//------------------------------------------------------------------------------------------
-GLushort* UnitPlane::getIndices()
-{
-    return indices;
-}
+    const GLfloat* texCoords = UnitPrimitive::getTexureCoordinates();
+    scaledTexCoords.resize(getNumVertices() * 2);
 
-//------------------------------------------------------------------------------------------
-void UnitPlane::clearData()
-{
-    vertexList.clear();
-    normalsList.clear();
-    texCoordList.clear();
-
-    if(vertices)
+    for(int i = 0; i < scaledTexCoords.size(); ++i)
     {
-        delete[] vertices;
+        scaledTexCoords[i] = texCoords[i] * _scale;
     }
 
-    if(colors)
-    {
-        delete[] colors;
-    }
-
-    if(normals)
-    {
-        delete[] normals;
-    }
-
-    if(texCoord)
-    {
-        delete[] texCoord;
-    }
+    return scaledTexCoords.data();
 }
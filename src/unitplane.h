@@ -5,47 +5,31 @@
 //     Author: Nghia Truong
 //
 //------------------------------------------------------------------------------------------
-#include <QOpenGLWidget>
-#include <QList>
-#include <QVector3D>
-#include <QVector2D>
+#include "unitprimitive.h"
 
 #ifndef UNITPLANE_H
 #define UNITPLANE_H
 
 
-class UnitPlane
+class UnitPlane : public UnitPrimitive
 {
 public:
     UnitPlane();
     ~UnitPlane();
 
-    int getNumVertices();
-    int getNumIndices();
-    int getVertexOffset();
-    int getTexCoordOffset();
-    int getIndexOffset();
+    // a grid of _resolution x _resolution quads
+    void generatePlane(int _resolution);
 
-
-    GLfloat* getVertices();
     GLfloat* getRandomVertexColors();
-    GLfloat* getNormals();
     GLfloat* getTexureCoordinates(float _scale);
-    GLushort* getIndices();
 
+protected:
+    void evaluate(int _patch, int _row, int _column, GLfloat* _vertex, GLfloat* _normal,
+                  GLfloat* _texCoord);
 
 private:
-    void clearData();
-
-    QList<QVector3D> vertexList;
-    QList<QVector3D> colorList;
-    QList<QVector2D> texCoordList;
-    QList<QVector3D> normalsList;
-    GLfloat* vertices;
-    GLfloat* colors;
-    GLfloat* texCoord;
-    GLfloat* normals;
-    static GLushort indices[];
+    QVector<GLfloat> colors;
+    QVector<GLfloat> scaledTexCoords;
 };
 
 #endif // UNITPLANE_H
@@ -0,0 +1,241 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#include "unitprimitive.h"
+
+//------------------------------------------------------------------------------------------
+UnitPrimitive::UnitPrimitive():
+    numPatches(0),
+    numRows(0),
+    numColumns(0),
+    mainDiagonal(false)
+{
+}
+
+//------------------------------------------------------------------------------------------
+UnitPrimitive::~UnitPrimitive()
+{
+}
+
+//------------------------------------------------------------------------------------------
+void UnitPrimitive::generate(int _numPatches, int _numRows, int _numColumns,
+                             bool _mainDiagonal)
+{
+    numPatches = _numPatches;
+    numRows = _numRows;
+    numColumns = _numColumns;
+    mainDiagonal = _mainDiagonal;
+
+    int numVertices = numPatches * (numRows + 1) * (numColumns + 1);
+    int numIndices = numPatches * numRows * numColumns * 6;
+
+    geometry.allocate(numVertices, numIndices,
+                      GEOMETRY_POSITIONS | GEOMETRY_NORMALS | GEOMETRY_TEXCOORDS,
+                      (numVertices <= 65536) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT);
+    negativeNormals.clear();
+
+    /////////////////////////////////////////////////////////////////
+    // the bands write disjoint ranges of the buffers
+    if(numVertices < PRIMITIVE_PARALLEL_THRESHOLD)
+    {
+        generateBand(0, 1);
+        return;
+    }
+
+    int numBands = qMax(1, QThread::idealThreadCount());
+    QVector<QFuture<void> > futures;
+
+    for(int band = 1; band < numBands; ++band)
+    {
+        futures.append(QtConcurrent::run(this, &UnitPrimitive::generateBand, band,
+                                         numBands));
+    }
+
+    generateBand(0, numBands);
+
+    for(int i = 0; i < futures.size(); ++i)
+    {
+        futures[i].waitForFinished();
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// the vertex rows and the quad rows of all patches are split evenly between the bands
+//------------------------------------------------------------------------------------------
+void UnitPrimitive::generateBand(int _band, int _numBands)
+{
+    GLfloat* vertexData = geometry.getAttribute(POSITION_ATTRIBUTE);
+    GLfloat* normalData = geometry.getAttribute(NORMAL_ATTRIBUTE);
+    GLfloat* texCoordData = geometry.getAttribute(TEXCOORD_ATTRIBUTE);
+
+    int numVertexRows = numPatches * (numRows + 1);
+    int firstRow = (int)((qint64) numVertexRows * _band / _numBands);
+    int lastRow = (int)((qint64) numVertexRows * (_band + 1) / _numBands);
+
+    for(int row = firstRow; row < lastRow; ++row)
+    {
+        int patch = row / (numRows + 1);
+        int patchRow = row % (numRows + 1);
+        int vertex = row * (numColumns + 1);
+
+        for(int column = 0; column <= numColumns; ++column, ++vertex)
+        {
+            evaluate(patch, patchRow, column, vertexData + 3 * vertex, normalData + 3 * vertex,
+                     texCoordData + 2 * vertex);
+        }
+    }
+
+    int numQuadRows = numPatches * numRows;
+    int firstQuadRow = (int)((qint64) numQuadRows * _band / _numBands);
+    int lastQuadRow = (int)((qint64) numQuadRows * (_band + 1) / _numBands);
+
+    if(geometry.getIndexType() == GL_UNSIGNED_SHORT)
+    {
+        generateIndices((GLushort*) geometry.getIndices(), firstQuadRow, lastQuadRow);
+    }
+    else
+    {
+        generateIndices((GLuint*) geometry.getIndices(), firstQuadRow, lastQuadRow);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+template<class IndexType>
+void UnitPrimitive::generateIndices(IndexType* _indices, int _firstQuadRow,
+                                    int _lastQuadRow)
+{
+    IndexType* index = _indices + _firstQuadRow * numColumns * 6;
+
+    for(int quadRow = _firstQuadRow; quadRow < _lastQuadRow; ++quadRow)
+    {
+        int patch = quadRow / numRows;
+        int first = (quadRow + patch) * (numColumns + 1);
+        int second = first + numColumns + 1;
+
+        for(int column = 0; column < numColumns; ++column, ++first, ++second)
+        {
+            if(mainDiagonal)
+            {
+                *(index++) = first;
+                *(index++) = first + 1;
+                *(index++) = second + 1;
+
+                *(index++) = second + 1;
+                *(index++) = second;
+                *(index++) = first;
+            }
+            else
+            {
+                *(index++) = first;
+                *(index++) = first + 1;
+                *(index++) = second;
+
+                *(index++) = second;
+                *(index++) = first + 1;
+                *(index++) = second + 1;
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+int UnitPrimitive::getNumVertices()
+{
+    return geometry.getNumVertices();
+}
+
+//------------------------------------------------------------------------------------------
+int UnitPrimitive::getNumIndices()
+{
+    return geometry.getNumIndices();
+}
+
+//------------------------------------------------------------------------------------------
+int UnitPrimitive::getVertexOffset()
+{
+    return (sizeof(GLfloat) * getNumVertices() * 3);
+}
+
+//------------------------------------------------------------------------------------------
+int UnitPrimitive::getTexCoordOffset()
+{
+    return (sizeof(GLfloat) * getNumVertices() * 2);
+}
+
+//------------------------------------------------------------------------------------------
+int UnitPrimitive::getIndexOffset()
+{
+    return (getIndexSize() * getNumIndices());
+}
+
+//------------------------------------------------------------------------------------------
+GLenum UnitPrimitive::getIndexType()
+{
+    return geometry.getIndexType();
+}
+
+//------------------------------------------------------------------------------------------
+int UnitPrimitive::getIndexSize()
+{
+    return geometry.getIndexSize();
+}
+
+//------------------------------------------------------------------------------------------
+GLfloat* UnitPrimitive::getVertices()
+{
+    return geometry.getAttribute(POSITION_ATTRIBUTE);
+}
+
+//------------------------------------------------------------------------------------------
+GLfloat* UnitPrimitive::getNormals()
+{
+    return geometry.getAttribute(NORMAL_ATTRIBUTE);
+}
+
+//------------------------------------------------------------------------------------------
+GLfloat* UnitPrimitive::getNegativeNormals()
+{
+    int numComponents = getNumVertices() * 3;
+
+    if(negativeNormals.size() != numComponents)
+    {
+        const GLfloat* normals = geometry.getAttribute(NORMAL_ATTRIBUTE);
+        negativeNormals.resize(numComponents);
+
+        for(int i = 0; i < numComponents; ++i)
+        {
+            negativeNormals[i] = -normals[i];
+        }
+    }
+
+    return negativeNormals.data();
+}
+
+//------------------------------------------------------------------------------------------
+GLfloat* UnitPrimitive::getTexureCoordinates()
+{
+    return geometry.getAttribute(TEXCOORD_ATTRIBUTE);
+}
+
+//------------------------------------------------------------------------------------------
+const GLvoid* UnitPrimitive::getIndices()
+{
+    return geometry.getIndices();
+}
+
+//------------------------------------------------------------------------------------------
+GeometryBuffer& UnitPrimitive::getGeometry()
+{
+    return geometry;
+}
+
+//------------------------------------------------------------------------------------------
+int UnitPrimitive::getIndex(int _i)
+{
+    return geometry.getIndex(_i);
+}
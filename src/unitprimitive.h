@@ -0,0 +1,76 @@
+//------------------------------------------------------------------------------------------
+//
+//
+// Created on: 10/19/2026
+//     Author: Nghia Truong
+//
+//------------------------------------------------------------------------------------------
+
+#ifndef UNITPRIMITIVE_H
+#define UNITPRIMITIVE_H
+
+#include <QOpenGLWidget>
+#include <QtConcurrent>
+
+#include "geometrybuffer.h"
+
+#define PRIMITIVE_PARALLEL_THRESHOLD 65536 // vertices, generated by one thread below
+
+//------------------------------------------------------------------------------------------
+// A procedural primitive made of patches, each one a regular grid of quads whose vertices
+// are given by evaluate(). The attributes are written directly into the blocks of one
+// GeometryBuffer, by several threads for the large resolutions. The indices are 16-bit as
+// long as the vertices fit, 32-bit otherwise.
+//------------------------------------------------------------------------------------------
+class UnitPrimitive
+{
+public:
+    UnitPrimitive();
+    virtual ~UnitPrimitive();
+
+    int getNumVertices();
+    int getNumIndices();
+    int getVertexOffset();
+    int getTexCoordOffset();
+    int getIndexOffset();
+
+    // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+    GLenum getIndexType();
+    int getIndexSize();
+
+    GLfloat* getVertices();
+    GLfloat* getNormals();
+    GLfloat* getNegativeNormals();
+    GLfloat* getTexureCoordinates();
+    const GLvoid* getIndices();
+
+    // the generated geometry, to be moved out or released after the upload
+    GeometryBuffer& getGeometry();
+
+protected:
+    // the quads are split along the (row, column)-(row + 1, column + 1) diagonal if
+    // _mainDiagonal, along the other one otherwise
+    void generate(int _numPatches, int _numRows, int _numColumns, bool _mainDiagonal);
+
+    // called concurrently, for 0 <= _row <= numRows and 0 <= _column <= numColumns
+    virtual void evaluate(int _patch, int _row, int _column, GLfloat* _vertex,
+                          GLfloat* _normal, GLfloat* _texCoord) = 0;
+
+    int getIndex(int _i);
+
+    int numPatches;
+    int numRows;
+    int numColumns;
+
+private:
+    void generateBand(int _band, int _numBands);
+    template<class IndexType> void generateIndices(IndexType* _indices, int _firstQuadRow,
+                                                   int _lastQuadRow);
+
+    bool mainDiagonal;
+
+    GeometryBuffer geometry;
+    QVector<GLfloat> negativeNormals;
+};
+
+#endif // UNITPRIMITIVE_H
@@ -9,220 +9,47 @@
 #include <cmath>
 #include "unitsphere.h"
 
-#include <QMatrix4x4>
-#include <QVector2D>
-
 UnitSphere::UnitSphere():
-    vertices(NULL),
-    normals(NULL),
-    texCoord(NULL)
+    numStacks(0),
+    numSlices(0)
 {
 }
 
 //------------------------------------------------------------------------------------------
 UnitSphere::~UnitSphere()
 {
-    clearData();
 }
 
+//------------------------------------------------------------------------------------------
+// one row per stack, one column per slice, the seam vertices are duplicated
 //------------------------------------------------------------------------------------------
 void UnitSphere::generateSphere(int _numStacks, int _numSlices)
 {
     numStacks = _numStacks;
     numSlices = _numSlices;
 
-    clearData();
-    QVector3D vertex;
-    QVector2D tex;
-
-    for (int j = 0; j <= _numStacks; ++j)
-    {
-        float theta = (float)j * M_PI / _numStacks;
-        float sinTheta = sin(theta);
-        float cosTheta = cos(theta);
-
-        for (int i = 0; i <= _numSlices; ++i)
-        {
-            float phi = (float)i * 2 * M_PI / _numSlices;
-            float sinPhi = sin(phi);
-            float cosPhi = cos(phi);
-
-            vertex.setX(cosPhi * sinTheta);
-            vertex.setY(cosTheta);
-            vertex.setZ(sinPhi * sinTheta);
-            verticesList.append(vertex);
-
-            // normal at this point is the same value with coordinate
-            normalsList.append(vertex);
-
-
-            tex.setX(2.0*(1.0 - (float)i / (float) _numSlices));
-            tex.setY(1.0 - (float)j / (float) _numStacks);
-            texCoordList.append(tex);
-        }
-    }
-
-    for (int j = 0; j < _numStacks; ++j)
-    {
-        for (int i = 0; i < _numSlices; ++i)
-        {
-            int first = (j * (_numSlices + 1)) + i;
-            int second = first + _numSlices + 1;
-
-            indicesList.append(first);
-            indicesList.append(first + 1);
-            indicesList.append(second);
-
-            indicesList.append(second);
-            indicesList.append(first + 1);
-            indicesList.append(second + 1);
-        }
-    }
-
-}
-
-//------------------------------------------------------------------------------------------
-int UnitSphere::getNumVertices()
-{
-
-    return verticesList.size();
-}
-
-//------------------------------------------------------------------------------------------
-int UnitSphere::getNumIndices()
-{
-    return indicesList.size();
-}
-
-//------------------------------------------------------------------------------------------
-int UnitSphere::getVertexOffset()
-{
-    return (sizeof(GLfloat) * getNumVertices() * 3);
-}
-
-//------------------------------------------------------------------------------------------
-int UnitSphere::getIndexOffset()
-{
-    return (sizeof(GLushort) * getNumIndices());
-}
-
-//------------------------------------------------------------------------------------------
-int UnitSphere::getTexCoordOffset()
-{
-    return (sizeof(GLfloat) * getNumVertices() * 2);
-}
-
-//------------------------------------------------------------------------------------------
-GLfloat* UnitSphere::getVertices()
-{
-    if(!vertices)
-    {
-        vertices = new GLfloat[verticesList.size() * 3];
-
-        for(int i = 0; i < verticesList.size(); ++i)
-        {
-            QVector3D vertex = verticesList.at(i);
-            vertices[3 * i] = vertex.x();
-            vertices[3 * i + 1] = vertex.y();
-            vertices[3 * i + 2] = vertex.z();
-//            qDebug() << i << vertex;
-        }
-
-    }
-
-    return vertices;
+    generate(1, _numStacks, _numSlices, false);
 }
 
 //------------------------------------------------------------------------------------------
-GLfloat* UnitSphere::getNormals()
+void UnitSphere::evaluate(int _patch, int _row, int _column, GLfloat* _vertex,
+                          GLfloat* _normal, GLfloat* _texCoord)
 {
-    if(!normals)
-    {
-        normals = new GLfloat[normalsList.size() * 3];
+    Q_UNUSED(_patch);
 
-        for(int i = 0; i < normalsList.size(); ++i)
-        {
-            QVector3D normal = normalsList.at(i);
-            normals[3 * i] = normal.x();
-            normals[3 * i + 1] = normal.y();
-            normals[3 * i + 2] = normal.z();
-        }
+    float theta = (float)_row * M_PI / numStacks;
+    float phi = (float)_column * 2 * M_PI / numSlices;
+    float sinTheta = sin(theta);
 
-    }
+    _vertex[0] = cos(phi) * sinTheta;
+    _vertex[1] = cos(theta);
+    _vertex[2] = sin(phi) * sinTheta;
 
-    return normals;
-}
+    // normal at this point is the same value with coordinate
+    _normal[0] = _vertex[0];
+    _normal[1] = _vertex[1];
+    _normal[2] = _vertex[2];
 
-//------------------------------------------------------------------------------------------
-GLfloat* UnitSphere::getNegativeNormals()
-{
-    if(!normals)
-    {
-        normals = new GLfloat[normalsList.size() * 3];
-    }
-
-    for(int i = 0; i < normalsList.size(); ++i)
-    {
-        QVector3D normal = normalsList.at(i);
-        normals[3 * i] = -normal.x();
-        normals[3 * i + 1] = -normal.y();
-        normals[3 * i + 2] = -normal.z();
-    }
-
-
-
-    return normals;
+    _texCoord[0] = 2.0 * (1.0 - (float)_column / (float) numSlices);
+    _texCoord[1] = 1.0 - (float)_row / (float) numStacks;
 }
-
-//------------------------------------------------------------------------------------------
-GLfloat* UnitSphere::getTexureCoordinates()
-{
-    if(!texCoord)
-    {
-        texCoord = new GLfloat[texCoordList.size() * 2];
-
-        for(int i = 0; i < texCoordList.size(); ++i)
-        {
-            QVector2D tex = texCoordList.at(i);
-            texCoord[2 * i] = tex.x();
-            texCoord[2 * i + 1] = tex.y();
-        }
-
-    }
-
-    return texCoord;
-}
-
-//------------------------------------------------------------------------------------------
-GLushort* UnitSphere::getIndices()
-{
-    return (GLushort*)indicesList.data();
-}
-
-//------------------------------------------------------------------------------------------
-void UnitSphere::clearData()
-{
-    verticesList.clear();
-    normalsList.clear();
-    texCoordList.clear();
-    indicesList.clear();
-
-    if(vertices)
-    {
-        delete[] vertices;
-        vertices = NULL;
-    }
-
-    if(normals)
-    {
-        delete[] normals;
-        normals = NULL;
-    }
-
-    if(texCoord)
-    {
-        delete[] texCoord;
-        texCoord = NULL;
-    }
-}
-
@@ -6,17 +6,13 @@
 //
 //------------------------------------------------------------------------------------------
 
-#include <QOpenGLWidget>
-#include <QList>
-#include <QVector3D>
-#include <QVector2D>
-#include <math.h>
+#include "unitprimitive.h"
 
 #ifndef UVSPHERE_H
 #define UVSPHERE_H
 
 
-class UnitSphere
+class UnitSphere : public UnitPrimitive
 {
 public:
     UnitSphere();
@@ -24,32 +20,12 @@ public:
 
     void generateSphere(int _numStacks, int _numSlices);
 
-    int getNumVertices();
-    int getNumIndices();
-    int getVertexOffset();
-    int getTexCoordOffset();
-    int getIndexOffset();
-
-    GLfloat* getVertices();
-    GLfloat* getNormals();
-    GLfloat* getNegativeNormals();
-    GLfloat* getTexureCoordinates();
-    GLushort* getIndices();
-
     int numStacks;
     int numSlices;
 
-private:
-    void clearData();
-
-    QList<QVector3D> verticesList;
-    QList<QVector2D> texCoordList;
-    QList<QVector3D> normalsList;
-    QVector<GLushort> indicesList;
-    GLfloat* vertices;
-    GLfloat* texCoord;
-    GLfloat* normals;
-
+protected:
+    void evaluate(int _patch, int _row, int _column, GLfloat* _vertex, GLfloat* _normal,
+                  GLfloat* _texCoord);
 };
 
 #endif // UVSPHERE_H